@@ -0,0 +1,130 @@
+/**
+ * Roxy RedLight v2.0 - Native Render Benchmark
+ *
+ * Run with: pio run -e bench -t exec
+ *
+ * Renders every screen through the host canvas and reports, per frame,
+ * pixels written into the frame buffer, bytes that would cross SPI and
+ * host time. Use it to compare rendering changes, not to predict device
+ * frame times. Animation time steps one frame period per frame, so runs
+ * are repeatable.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "display.h"
+#include "host_port.h"
+
+#define BENCH_FRAMES    5000
+
+static const char* screenNames[SCREEN_COUNT] = {
+    "HOME", "SESSION", "STATS", "SETTINGS", "BATTERY", "SAFETY", "TELEMETRY", "HISTORY"
+};
+
+// Sliding trace fed a sample every frame: every column moves each frame
+static TelemetryTrace benchTrace;
+
+static uint64_t nanos() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// One frame of a screen, with data moving the way it does on the device
+static void renderFrame(Screen screen, uint32_t i) {
+    switch (screen) {
+        case SCREEN_HOME:
+            display.showHome(7.40f + (i % 8) * 0.01f, 80 - (i / 500) % 20, DEFAULT_MODE);
+            break;
+        case SCREEN_SESSION:
+            display.showSession(i % 1200, 1200, MODE_ALTERNATING,
+                                (i / 30) % 2 == 0, (i / 30) % 2 == 1);
+            break;
+        case SCREEN_STATS:
+            display.showStats(100 + i / 100, 2000 + i / 10, i % (MAX_DAILY_SESSIONS + 1));
+            break;
+        case SCREEN_SETTINGS:
+            display.showSettings(DEFAULT_MODE, (i / 10) % 4);
+            break;
+        case SCREEN_BATTERY:
+            display.showBattery(7.40f + (i % 8) * 0.01f, 100 - i % 101, (i / 1000) % 2);
+            break;
+        case SCREEN_SAFETY:
+            display.showSafety(7.40f + (i % 8) * 0.01f, 30.0f + (i % 50) * 0.1f,
+                               false, false, false);
+            break;
+        case SCREEN_TELEMETRY: {
+            if (i == 0) {
+                telemetry_trace_init(&benchTrace, 1, false);
+            }
+            TelemetrySample sample;
+            sample.value[SERIES_VOLTS] = 740 + (i % 8) - (i / 200) % 10;
+            sample.value[SERIES_TEMP] = 300 + (i % 50);
+            sample.value[SERIES_DUTY] = ((i / 30) % 2) ? 100 : 0;
+            telemetry_trace_add(&benchTrace, &sample);
+            display.showTelemetry(benchTrace, sample, false);
+            break;
+        }
+        case SCREEN_HISTORY: {
+            // Paging through 600 sessions, a screen every 10 frames
+            HistoryPage page;
+            memset(&page, 0, sizeof(page));
+            page.page = 99 - (i / 10) % 100;
+            page.count = HISTORY_PAGE_RECORDS;
+            for (uint8_t r = 0; r < HISTORY_PAGE_RECORDS; r++) {
+                HistoryRecord& record = page.records[r];
+                record.start = 3600 + (page.page * HISTORY_PAGE_RECORDS + r) * 97;
+                record.boot = 1 + page.page / 4;
+                record.durationSec = 1200 - r * 61;
+                record.doseMilliJ = record.durationSec * 5;
+                record.mode = 1 + r % 4;
+                record.end = r % HISTORY_END_COUNT;
+            }
+            display.showHistory(page, 100 * HISTORY_PAGE_RECORDS, (i / 10) % 100);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+int main(int argc, char** argv) {
+    display.begin();
+    hostClock().manual = true;
+
+    uint32_t fullFrame = (uint32_t)TFT_WIDTH * TFT_HEIGHT * sizeof(uint16_t);
+    printf("\n%d frames per screen, full frame = %lu SPI bytes\n\n",
+           BENCH_FRAMES, (unsigned long)fullFrame);
+    printf("%-10s %10s %10s %12s %8s\n", "screen", "ns/frame", "px/frame", "SPI B/frame", "of full");
+
+    for (uint8_t s = 0; s < SCREEN_COUNT; s++) {
+        Screen screen = (Screen)s;
+        display.setScreen(screen);  // First frame is a full push, as on device
+
+        HostCanvas::pixelsWritten = 0;
+        uint64_t spiBytes = 0;
+        uint64_t start = nanos();
+
+        for (uint32_t i = 0; i < BENCH_FRAMES; i++) {
+            renderFrame(screen, i);
+            display.waitFrame();
+            hostClock().ms += 1000 / DISPLAY_ANIM_FPS;
+            spiBytes += display.lastPushBytes();
+        }
+
+        uint64_t elapsed = nanos() - start;
+        double perFrame = (double)spiBytes / BENCH_FRAMES;
+        printf("%-10s %10lu %10lu %12.0f %7.1f%%\n", screenNames[s],
+               (unsigned long)(elapsed / BENCH_FRAMES),
+               (unsigned long)(HostCanvas::pixelsWritten / BENCH_FRAMES),
+               perFrame, 100.0 * perFrame / fullFrame);
+    }
+
+    #if DISPLAY_PROFILE
+    printf("\n");
+    display.dumpProfile();
+    #endif
+
+    return 0;
+}
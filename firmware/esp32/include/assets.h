@@ -0,0 +1,15 @@
+/**
+ * Roxy RedLight v2.0 - Image Assets
+ *
+ * Generated by tools/asset_tool.cpp from assets/ - do not edit.
+ * Regenerate with: pio run -e assets -t exec
+ */
+
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include "asset.h"
+
+extern const Asset assetLogo;                    // 120x72
+
+#endif // ASSETS_H
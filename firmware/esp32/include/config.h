@@ -24,6 +24,21 @@
 // Display backlight (directly controlled in TFT_eSPI, but useful for sleep)
 #define PIN_TFT_BL      38  // GPIO38 - TFT backlight
 
+// Display 8-bit parallel (i80) bus, used when DISPLAY_BUS_I80 is set
+#define PIN_LCD_D0      39  // GPIO39..48 - Data bits 0-7
+#define PIN_LCD_D1      40
+#define PIN_LCD_D2      41
+#define PIN_LCD_D3      42
+#define PIN_LCD_D4      45
+#define PIN_LCD_D5      46
+#define PIN_LCD_D6      47
+#define PIN_LCD_D7      48
+#define PIN_LCD_WR      8   // GPIO8 - Write strobe
+#define PIN_LCD_RD      9   // GPIO9 - Read strobe (held HIGH)
+#define PIN_LCD_DC      7   // GPIO7 - Data/command
+#define PIN_LCD_CS      6   // GPIO6 - Chip select
+#define PIN_LCD_RST     5   // GPIO5 - Panel reset
+
 // Analog Input
 #define PIN_VBAT_ADC    4   // GPIO4 - Battery voltage via divider
 
@@ -47,6 +62,88 @@
 #define COLOR_YELLOW    0xFFE0  // Yellow for warnings
 #define COLOR_ORANGE    0xFD20  // Orange for caution
 #define COLOR_DANGER    0xF800  // Red for danger
+#define COLOR_HEADER    0x1082  // Dark blue-gray header/footer bars
+#define COLOR_PANEL     0x2104  // Dark gray alert box, selection, bar track
+#define COLOR_BORDER    0x4208  // Progress bar border
+#define COLOR_GRAY      0x8410  // Secondary text
+#define COLOR_RED_OFF       0x4000  // Unlit red LED indicator
+#define COLOR_RED_RIM_OFF   0x8000  // Unlit red LED rim
+#define COLOR_NIR_OFF       0x2000  // Unlit NIR LED indicator
+#define COLOR_NIR_RIM       0xC000  // Lit NIR LED rim
+#define COLOR_NIR_RIM_OFF   0x4000  // Unlit NIR LED rim
+
+// Sprite color depth: 16 = RGB565, 4 = 16-entry palette built from the
+// COLOR_* values above (4x less RAM, expanded to RGB565 while pushing)
+#define DISPLAY_COLOR_DEPTH     4
+
+// Frame push: double-buffered sprites sent over SPI DMA through small
+// internal-RAM staging buffers, so loop() never waits on the panel
+#define DISPLAY_DMA_ENABLED     true
+#define DISPLAY_DMA_LINES       40      // Rows per DMA chunk (170x40x2 = 13.6 KB)
+
+// Panel bus: false = SPI through TFT_eSPI (setup in platformio.ini), true =
+// the 8-bit parallel i80 bus through esp_lcd. Both push with DMA; over i80
+// a 16 bpp frame also streams straight out of PSRAM, one transfer per
+// changed band, with no staging copy.
+#define DISPLAY_BUS_I80         false
+#define DISPLAY_I80_PCLK_HZ     15000000    // ST7789 write cycle >= 66 ns
+
+// Strip rendering: 0 draws whole 170x320 frames. Otherwise each frame is
+// drawn this many rows at a time into one internal-RAM strip (170x40 at
+// 4 bpp = 3.4 KB instead of two PSRAM frames), replaying the screen for
+// every strip that changed and pushing each strip before the next one.
+#define DISPLAY_STRIP_LINES     0
+
+// Render in a FreeRTOS task on core 0 from view snapshots published by
+// loop() on core 1, so slow frames never delay LED or safety handling.
+// false renders inline in loop() (compare the logged loop jitter).
+#define RENDER_TASK_ENABLED     true
+#define RENDER_TASK_CORE        0
+#define RENDER_TASK_PRIORITY    1
+#define RENDER_TASK_STACK       8192    // Bytes
+
+// Safety supervisor: a task above every other samples the battery and
+// temperature every SAFETY_PERIOD_MS, runs safety_check_all() and cuts the
+// LEDs itself on a fault, so no blocking call in loop() can postpone it. A
+// check finishing more than SAFETY_DEADLINE_MS after it was due counts as
+// missed. Worst-case fault to LEDs off: one period plus the check. With no
+// session and the LEDs off it checks every SAFETY_IDLE_PERIOD_MS instead.
+#define SAFETY_TASK_CORE        1
+#define SAFETY_TASK_PRIORITY    (configMAX_PRIORITIES - 1)
+#define SAFETY_TASK_STACK       4096    // Bytes
+#define SAFETY_PERIOD_MS        100
+#define SAFETY_IDLE_PERIOD_MS   2000
+#define SAFETY_DEADLINE_MS      10
+
+// Animation: progress bar tweens, a wipe between menu screens and a pulse
+// on lit LED indicators. While anything moves, frames are paced at
+// DISPLAY_ANIM_FPS; a slow frame delays the next one (counted as dropped)
+// so rendering never takes more than DISPLAY_ANIM_MAX_LOAD percent.
+#define DISPLAY_ANIM_FPS        30
+#define DISPLAY_ANIM_MAX_LOAD   50      // Percent
+#define DISPLAY_TWEEN_MS        300     // Progress fill catching up
+#define DISPLAY_WIPE_MS         200     // Screen transition
+#define DISPLAY_PULSE_MS        1200    // LED glow period
+
+// How long notifications stay on screen once shown (ms)
+#define NOTICE_TOAST_MS         3000    // Info and warning toasts
+#define NOTICE_ALERT_MS         4000    // Critical alert boxes
+
+// Pre-render each screen's static chrome into PSRAM at boot and restore it
+// with one memcpy per frame (needs BOARD_HAS_PSRAM; one frame per screen:
+// 170x320 at DISPLAY_COLOR_DEPTH bits, ~27 KB at 4 bpp)
+#define DISPLAY_CHROME_CACHE    true
+
+// Cycle-count histograms of every frame per screen and phase: serial 'p'
+// dumps them, 'r' resets, a long press of button 2 on the home screen
+// shows them. Compiled out entirely when false.
+#define DISPLAY_PROFILE         false
+
+// Telemetry screen: battery voltage, temperature and LED duty sampled this
+// often into a ring, folded into min/max chart columns over the session
+// and over the last TELEMETRY_WINDOW_SEC
+#define TELEMETRY_PERIOD_MS     1000
+#define TELEMETRY_WINDOW_SEC    3600
 
 // UI Layout
 #define HEADER_HEIGHT   40
@@ -61,6 +158,20 @@
 #define PWM_RESOLUTION  8       // 8-bit (0-255)
 #define PWM_CHANNEL_RED 0       // LEDC channel for red LEDs
 #define PWM_CHANNEL_NIR 1       // LEDC channel for NIR LEDs
+#define PWM_CHANNEL_BUZZER 2    // LEDC channel for the buzzer
+#define PWM_TIMER_LEDS  0       // LEDC timer shared by red and NIR
+#define PWM_TIMER_BUZZER 1      // Own timer: tone changes its frequency without
+                                // touching the LED PWM
+
+// =============================================================================
+// POWER MANAGEMENT
+// =============================================================================
+
+// Automatic light sleep whenever every task is waiting. Needs a core built
+// with CONFIG_PM_ENABLE and CONFIG_FREERTOS_USE_TICKLESS_IDLE. USB serial
+// drops while the chip sleeps: set false to keep a console attached.
+#define LIGHT_SLEEP_ENABLED     true
+#define PM_MIN_FREQ_MHZ         80      // Lowest CPU clock that keeps APB at 80 MHz
 
 // =============================================================================
 // BATTERY MONITORING
@@ -141,6 +252,12 @@ typedef enum {
 // Long press threshold (ms) - for mode change
 #define BUTTON_LONG_PRESS_MS    1000
 
+// Second click within this gap of the first (ms) - double-click
+#define BUTTON_DOUBLE_CLICK_MS  250
+
+// Repeat period while a button is held past a long press (ms)
+#define BUTTON_REPEAT_MS        200
+
 // Status LED blink patterns (ms)
 #define BLINK_FAST      100
 #define BLINK_SLOW      500
@@ -160,5 +277,9 @@ typedef enum {
 #define PREFS_KEY_SESSIONS  "sessions"
 #define PREFS_KEY_MINUTES   "minutes"
 #define PREFS_KEY_MODE      "mode"
+#define PREFS_KEY_BOOTS     "boots"
+
+// Session history records (LittleFS, on the filesystem partition)
+#define HISTORY_FILE        "/history.bin"
 
 #endif // CONFIG_H
@@ -0,0 +1,95 @@
+/**
+ * Roxy RedLight v2.0 - Device State
+ *
+ * Shared state, grouped by the one task that writes it. Each group is
+ * published through a seqlock, so other tasks copy a whole snapshot without
+ * locks:
+ *  - DeviceState: session, mode and counters, written by loop()
+ *  - SensorState: battery and temperature, written by the safety task
+ *
+ * Each struct is cache-line aligned so a publish dirties only its own lines.
+ */
+
+#ifndef DEVICE_STATE_H
+#define DEVICE_STATE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+#include "seqlock.h"
+
+#define DEVICE_STATE_ALIGN      32      // ESP32-S3 data cache line
+
+// =============================================================================
+// DEVICE STATE (written by loop())
+// =============================================================================
+
+typedef struct __attribute__((aligned(DEVICE_STATE_ALIGN))) {
+    // Current session
+    bool sessionActive;
+    TreatmentMode currentMode;
+    uint8_t brightness;                 // 0-255
+    bool alternatePhase;                // false = red, true = NIR
+    uint8_t ledDuty;                    // Percent, brighter channel
+    unsigned long sessionStartTime;     // millis()
+    unsigned long totalSessionSeconds;
+
+    // Lifetime counters
+    uint32_t lifetimeSessions;
+    uint32_t lifetimeMinutes;
+    uint16_t bootCount;
+
+    // Daily limits
+    uint8_t dailySessionCount;
+    unsigned long lastSessionEndTime;
+    unsigned long dayStartTime;
+
+    // Latest sensor readings and the warnings raised on them
+    float batteryVoltage;
+    bool lowBatteryWarning;
+    bool overVoltageError;
+    float temperature;
+    bool thermalWarning;
+} DeviceState;
+
+// =============================================================================
+// SENSOR STATE (written by the safety task)
+// =============================================================================
+
+typedef struct __attribute__((aligned(DEVICE_STATE_ALIGN))) {
+    float batteryVoltage;
+    float temperature;                  // C (a fixed stand-in without a sensor)
+    uint32_t sampledMs;                 // millis() at the sample, 0 before the first
+} SensorState;
+
+// =============================================================================
+// CHANNELS
+// =============================================================================
+
+typedef struct {
+    Seqlock lock;
+    DeviceState slots[2];
+} DeviceStateChannel;
+
+typedef struct {
+    Seqlock lock;
+    SensorState slots[2];
+} SensorChannel;
+
+static inline void device_state_publish(DeviceStateChannel* ch, const DeviceState* state) {
+    seqlock_publish(&ch->lock, ch->slots, sizeof(DeviceState), state);
+}
+
+static inline void device_state_read(const DeviceStateChannel* ch, DeviceState* out) {
+    seqlock_read(&ch->lock, ch->slots, sizeof(DeviceState), out);
+}
+
+static inline void sensor_state_publish(SensorChannel* ch, const SensorState* state) {
+    seqlock_publish(&ch->lock, ch->slots, sizeof(SensorState), state);
+}
+
+static inline void sensor_state_read(const SensorChannel* ch, SensorState* out) {
+    seqlock_read(&ch->lock, ch->slots, sizeof(SensorState), out);
+}
+
+#endif // DEVICE_STATE_H
@@ -7,22 +7,152 @@
 #ifndef DISPLAY_H
 #define DISPLAY_H
 
-#include <TFT_eSPI.h>
+#include <stddef.h>
 #include "config.h"
+#include "dirty.h"
+#include "canvas.h"
+#include "widget.h"
+#include "anim.h"
+#include "asset.h"
+#include "telemetry.h"
+#include "history.h"
+#include "notice.h"
+#include "ui.h"
+
+#if DISPLAY_PROFILE
+#include "perf.h"
+#endif
+
+#ifdef ARDUINO
+#include <TFT_eSPI.h>
+#include "sprite_canvas.h"
+#if DISPLAY_BUS_I80
+#include "i80_panel.h"
+typedef I80Panel PanelDriver;
+#else
+typedef TFT_eSPI PanelDriver;
+#endif
+typedef SpriteCanvas FrameCanvas;
+#else
+// Native bench: frames in host memory, pushes discarded
+#include "host_canvas.h"
+typedef HostPanel PanelDriver;
+typedef HostCanvas FrameCanvas;
+#endif
+
+// Draw calls remembered per frame for change detection
+#define DISPLAY_MAX_PRIMITIVES  64
+
+// Characters pre-rasterized for numeric fields ("0123456789:./")
+#define GLYPH_COUNT             13
+#define GLYPH_MAX_TEXT          16      // Longest number drawn from an atlas
+
+// Widgets per screen table
+#define DISPLAY_MAX_WIDGETS     8
+
+// Static layers cached per screen, plus the emergency screen
+#define CHROME_EMERGENCY        SCREEN_COUNT
+#define CHROME_COUNT            (SCREEN_COUNT + 1)
+#define CHROME_NONE             0xFF
+
+// Render profile slots: chrome ids, then alerts
+#define PROFILE_ALERT           CHROME_COUNT
+#define PROFILE_SLOTS           (CHROME_COUNT + 1)
+#define PROFILE_NONE            0xFF
+
+// Where a frame's time goes
+typedef enum {
+    PHASE_CHROME = 0,   // Restoring or redrawing the static layer
+    PHASE_DRAW,         // Dynamic primitives
+    PHASE_PUSH,         // update(): dirty bookkeeping and the blocking part of the push
+    PHASE_TOTAL,
+    PHASE_COUNT
+} RenderPhase;
+
+// Telemetry chart height in rows (the width is TELEMETRY_COLUMNS)
+#define TELEMETRY_CHART_H   56
 
 // =============================================================================
-// MENU SCREENS
+// VIEW MODEL
 // =============================================================================
 
-typedef enum {
-    SCREEN_HOME = 0,    // Main idle screen
-    SCREEN_SESSION,     // Active session display
-    SCREEN_STATS,       // Usage statistics
-    SCREEN_SETTINGS,    // Mode selection
-    SCREEN_BATTERY,     // Battery details
-    SCREEN_SAFETY,      // Safety status
-    SCREEN_COUNT
-} Screen;
+// What a screen shows, reduced to display precision. Equal view models
+// render identical frames, so a repeat can be skipped without drawing.
+// Zero the whole struct before filling it in (compared with memcmp).
+typedef struct {
+    Screen screen;
+    union {
+        struct {
+            uint16_t centiVolts;    // Voltage rounded to 0.01 V ("%.2f")
+            uint8_t battPercent;
+            uint8_t mode;
+        } home;
+        struct {
+            uint32_t elapsedSec;
+            uint32_t totalSec;
+            uint8_t mode;
+            bool redOn;
+            bool nirOn;
+        } session;
+        struct {
+            uint32_t sessions;
+            uint32_t minutes;
+            uint8_t dailySessions;
+        } stats;
+        struct {
+            uint8_t mode;
+            int8_t selectedIndex;
+        } settings;
+        struct {
+            uint16_t centiVolts;
+            uint8_t percent;
+            bool charging;
+        } battery;
+        struct {
+            uint16_t centiVolts;
+            int16_t deciDegrees;    // Temperature rounded to 0.1 C ("%.1f")
+            bool overVoltage;
+            bool underVoltage;
+            bool thermal;
+        } safety;
+        struct {
+            bool lastHour;                  // Window: last hour, else the session
+            int16_t latest[SERIES_COUNT];   // Newest sample, in series units
+            int16_t lo[SERIES_COUNT];       // Chart range per series
+            int16_t hi[SERIES_COUNT];
+            uint8_t rows[SERIES_COUNT][TELEMETRY_COLUMNS][2];  // telemetry_trace_plot()
+        } telemetry;
+        struct {
+            uint32_t total;                 // Sessions recorded
+            uint32_t screen;                // Screenful shown, 0 = newest
+            uint32_t newest;                // Number of the top row's session
+            uint8_t count;                  // Rows filled
+            HistoryRecord records[HISTORY_PAGE_RECORDS];   // Newest first
+        } history;
+    };
+} ViewModel;
+
+// Telemetry view of a trace: latest values, ranges and plotted columns
+void buildTelemetryView(ViewModel& view, const TelemetryTrace& trace,
+                        const TelemetrySample& latest, bool lastHour);
+
+// History view of one cached page, shown as a screenful
+void buildHistoryView(ViewModel& view, const HistoryPage& page, uint32_t total,
+                      uint32_t screen);
+
+// A screen: its widget table, drawn over the screen's cached chrome
+typedef struct {
+    const Widget* widgets;
+    uint8_t count;
+} ScreenLayout;
+
+// Frame counters for profiling change-driven rendering
+typedef struct {
+    uint32_t rendered;
+    uint32_t skipped;
+    uint32_t lastFrameMicros;   // Render + blocking push of the last frame
+    uint32_t dropped;           // Animation frames that missed their slot
+} FrameStats;
 
 // =============================================================================
 // DISPLAY CLASS
@@ -35,6 +165,11 @@ public:
     void begin();
     void update();
     void clear();
+
+    // Asynchronous frame push (DISPLAY_DMA_ENABLED)
+    void service();         // Feed the next DMA chunk; call every loop()
+    bool frameInFlight();   // Previous frame still being sent to the panel
+    void waitFrame();       // Fence: block until the panel holds the last frame
     void setBrightness(uint8_t level);  // 0-255
 
     // Screen navigation
@@ -43,7 +178,7 @@ public:
     void nextScreen();
     void prevScreen();
 
-    // Screen renderers
+    // Screen renderers (each builds a view model and renders it)
     void showHome(float voltage, uint8_t battPercent, TreatmentMode mode);
     void showSession(unsigned long elapsedSec, unsigned long totalSec,
                      TreatmentMode mode, bool redOn, bool nirOn);
@@ -52,25 +187,237 @@ public:
     void showBattery(float voltage, uint8_t percent, bool charging);
     void showSafety(float voltage, float temp, bool overVoltage,
                     bool underVoltage, bool thermal);
+    void showTelemetry(const TelemetryTrace& trace, const TelemetrySample& latest,
+                       bool lastHour);
+    void showHistory(const HistoryPage& page, uint32_t total, uint32_t screen);
+
+    // Notifications: queued and overlaid on whatever screen is showing
+    // until they expire (NoticeLevel; critical ones as a box mid-screen).
+    // A sticky critical one takes the emergency screen until acknowledged.
+    void notify(uint8_t level, const char* title, const char* text,
+                uint16_t color, uint32_t durationMs);
+    bool acknowledgeNotice();   // true if a sticky notice was taken down
 
     // Alerts
-    void showAlert(const char* title, const char* message, uint16_t color);
     void showEmergency(const char* reason);
 
+    // Boot screen: logo, product name and a status line
+    void showSplash(const char* message);
+
     // Helpers
     void drawHeader(const char* title);
+    void drawHeaderTitle(const char* title);
     void drawFooter(const char* left, const char* right);
+    void drawFooterRight(const char* right);
     void drawBatteryIcon(int x, int y, uint8_t percent, bool charging);
     void drawProgressBar(int x, int y, int w, int h,
                          float progress, uint16_t color);
-    void drawLEDIndicator(int x, int y, bool redOn, bool nirOn);
+    void drawLEDIndicator(int x, int y, bool redOn, bool nirOn, uint8_t glow = 0);
+
+    // Bytes sent to the panel by the last update()
+    uint32_t lastPushBytes();
+
+    // Buffer being rendered (for the native bench)
+    Canvas& canvas();
+
+    #if DISPLAY_PROFILE
+    // Render timing: serial table, reset, and a hidden screen showing it
+    void dumpProfile();
+    void resetProfile();
+    void showDiagnostics();
+    #endif
+
+    // Change-driven rendering: true if the view differs from the last
+    // rendered one (caller should draw it), false if the frame is skipped
+    bool viewChanged(const ViewModel& view);
+    FrameStats getFrameStats();
+
+    // Draw the screen a view model describes, using only its fields (the
+    // render task works from published snapshots, never live state)
+    void render(const ViewModel& view);
+
+    // Animation pacing: while something on screen moves, frames are due
+    // every 1/DISPLAY_ANIM_FPS s even if the view is unchanged (viewChanged()
+    // then returns true). A frame is also due when a notice expires.
+    // Delay is in us, PACER_IDLE when nothing moves.
+    bool frameDue();
+    uint32_t frameDelay();
 
 private:
-    TFT_eSPI tft;
-    TFT_eSprite sprite;  // For flicker-free updates
+    // One draw call from the previous frame
+    struct DrawRecord {
+        uint32_t sig;       // Hash of primitive type, geometry, colors, text
+        DirtyRect bounds;   // Pixels it may have touched
+    };
+
+    // Dirty-tracked draw primitives (all screen drawing goes through these)
+    void fillScreen(uint16_t color);
+    void fillRect(int x, int y, int w, int h, uint16_t color);
+    void drawRect(int x, int y, int w, int h, uint16_t color);
+    void fillRoundRect(int x, int y, int w, int h, int r, uint16_t color);
+    void drawRoundRect(int x, int y, int w, int h, int r, uint16_t color);
+    void fillCircle(int x, int y, int r, uint16_t color);
+    void drawCircle(int x, int y, int r, uint16_t color);
+    void drawAsset(const Asset& asset, int x, int y);
+    void setTextFont(uint8_t font);
+    void setTextColor(uint16_t fg, uint16_t bg);
+    void setTextDatum(uint8_t datum);
+    void drawString(const char* text, int x, int y);
+    int16_t textWidth(const char* text);
+
+    // Pre-rasterized glyphs for one font, 1 bpp rows MSB first (the
+    // drawBitmap layout), so numbers are blitted instead of rasterized
+    struct GlyphAtlas {
+        uint8_t font;
+        uint8_t height;
+        uint8_t width[GLYPH_COUNT];
+        uint8_t* bits[GLYPH_COUNT];     // NULL until built
+    };
+
+    void buildAtlas(GlyphAtlas& atlas, uint8_t font);
+    bool lookupGlyphs(const GlyphAtlas& atlas, const char* text, uint8_t* index, int* width);
+    int numberWidth(const GlyphAtlas& atlas, const char* text);
+    // Numeric text from the atlas with the current datum and colors; each
+    // glyph is its own primitive so only changed digits reach the panel
+    void drawNumber(const GlyphAtlas& atlas, const char* text, int x, int y);
+
+    // Compare a primitive against the previous frame and mark changes dirty
+    void track(uint32_t sig, int x, int y, int w, int h);
+
+    // Static chrome: drawChrome() renders a screen's fixed layer,
+    // beginFrame() restores it from the PSRAM cache (or redraws it)
+    void drawChrome(uint8_t id);
+    void beginFrame(uint8_t chromeId);
+    void startImmediate();      // Frame start shared by clear() and beginFrame()
+    void cacheChrome();
+
+    // Retained screens: bind a layout's widgets to the view, then repaint
+    // (over the chrome) only widgets whose value changed in this buffer
+    void renderScreen(uint8_t chromeId, const ViewModel& view);
+    void paintWidgets(const Widget* widgets, uint8_t count, const WidgetValue* values,
+                      const uint32_t* sigs, const DirtyRect* bounds,
+                      uint8_t buf, uint8_t chromeId);
+    void paintWidget(const Widget& w, const WidgetValue& value);
+    DirtyRect widgetBounds(const Widget& w, const WidgetValue& value);
+    bool showDigits(const Widget& w, uint8_t slot, const WidgetValue& value,
+                    uint32_t sig, DirtyRect bounds);
+    void restoreChrome(uint8_t chromeId, DirtyRect r);
+
+    // Notice overlay, painted over the widgets in every strip
+    void paintNotice(const Notice& n);
+
+    // Animation: tween or pulse a bound value, and limit the dirty region
+    // to the rows a screen wipe has uncovered so far
+    void animate(const Widget& w, uint8_t slot, WidgetValue* value, uint32_t now);
+    void wipe(uint32_t now);
+
+    // Strip passes: each screen body runs inside FOR_EACH_STRIP, once per
+    // changed strip (just once when drawing whole frames)
+    bool firstStrip();
+    bool nextStrip();
+
+    // Push path: sprite rows (RGB565 or palette) -> panel-order RGB565.
+    // Sprite row 0 is screen row top (the current strip's first row).
+    void createFrame(FrameCanvas& frame);
+    void expandRows(uint16_t* dst, Canvas* src, int x, int y, int w, int rows);
+    void pushRect(const DirtyRect& r, int16_t top);
+
+    // Copy the next chunk of the in-flight frame into a DMA buffer (or,
+    // streaming, point at the rest of its band)
+    void stageChunk();
+    void alignBands();  // Streaming: bands on whole DMA blocks
+
+    #if DISPLAY_PROFILE
+    // Start timing a frame in a slot, close a phase, finish the frame
+    void profileBegin(uint8_t slot);
+    void profileMark(uint8_t phase);
+    void profileEnd();
+    #endif
+
+    PanelDriver tft;
+    FrameCanvas frameA;  // For flicker-free updates (one strip in strip mode)
+    FrameCanvas frameB;  // Second buffer when pushing whole frames by DMA
+    Canvas* draw;        // Buffer being rendered
+    Canvas* flight;      // Buffer being pushed
     Screen currentScreen;
     bool needsRedraw;
     unsigned long lastUpdate;
+
+    GlyphAtlas bigDigits;       // Font 7: session countdown
+    GlyphAtlas smallDigits;     // Font 2: stats values
+
+    // Partial update state
+    DirtyRegion dirty;
+    DrawRecord records[DISPLAY_MAX_PRIMITIVES];
+    uint8_t recordCount;        // Primitives drawn this frame
+    uint8_t prevRecordCount;    // Primitives drawn last frame
+    bool recordOverflow;        // Too many primitives to track
+    uint32_t pushBytes;
+    bool tracking;              // Off while drawing chrome
+
+    // Strip rendering (DISPLAY_STRIP_LINES): the first pass tracks the
+    // whole frame, later passes replay it for the strips it dirtied
+    uint8_t stripNo;            // Strip being drawn
+    bool replay;                // Pass after the first: no tracking
+
+    // PSRAM copies of each screen's static layer (NULL = draw each frame)
+    uint8_t* chrome[CHROME_COUNT];
+    size_t frameBytes;
+
+    // Retained widgets of the current screen (slot = index in its table)
+    WidgetState widgetState[DISPLAY_MAX_WIDGETS];
+    WidgetValue shownValue[DISPLAY_MAX_WIDGETS];   // For per-glyph changes
+    uint8_t bufferChrome[2];    // Screen whose widgets frameA/frameB hold
+    uint8_t shownChrome;        // Screen whose widgets the panel shows
+    bool retained;              // Last frame was a widget frame
+
+    // Animation state
+    Tween tweens[DISPLAY_MAX_WIDGETS];  // Per widget slot (progress fills)
+    int8_t wipeDir;             // 1 = top down, -1 = bottom up, 0 = no wipe
+    uint32_t wipeStart;         // millis() when the wipe began
+    int16_t wipeRows;           // Rows of the new screen on the panel so far
+    bool moving;                // Last frame left something mid-animation
+    FramePacer pacer;
+
+    // DMA push queue: full-width row bands of the in-flight frame, sent in
+    // DISPLAY_DMA_LINES chunks through two ping-pong staging buffers
+    // (the first one also stages blocking palette pushes)
+    bool dmaActive;
+    DirtyRect bands[DIRTY_MAX_RECTS];
+    uint8_t bandCount;
+    uint8_t bandIndex;
+    int16_t bandRow;            // Next row to stage within bands[bandIndex]
+    uint16_t* stageBuf[2];
+    uint8_t stageIndex;         // Buffer the next chunk is staged into
+    bool chunkStaged;
+    uint16_t* stagedData;       // Staging buffer, or the frame itself
+    int16_t stagedY;
+    int16_t stagedRows;
+    bool streamFrames;          // Bands go out of the frame with no staging
+
+    // Notifications (posted from loop() under the display lock)
+    NoticeQueue notices;
+    const Notice* notice;       // Overlaid this frame, NULL if none
+    uint32_t shownNotice;       // Id of the notice on the panel, 0 = none
+
+    // Change-driven rendering state
+    ViewModel lastView;
+    bool viewValid;             // False after alerts draw over the screen
+    FrameStats frameStats;
+    unsigned long frameStart;   // micros() at the start of the frame
+
+    #if DISPLAY_PROFILE
+    PerfHist profile[PROFILE_SLOTS][PHASE_COUNT];  // CPU cycles
+    uint8_t profileSlot;        // PROFILE_NONE outside a timed frame
+    uint32_t profileStart;      // Cycle count at frame start
+    uint32_t profileLast;       // Cycle count at the last phase mark
+    #endif
+
+    // Current text state (part of each text primitive's signature)
+    uint8_t textFont;
+    uint8_t textDatum;
+    uint16_t textFg;
+    uint16_t textBg;
 };
 
 // Global display instance
@@ -0,0 +1,27 @@
+/**
+ * Roxy RedLight v2.0 - Font Subsets
+ *
+ * Fonts 2 and 4 are not linked from TFT_eSPI: tools/font_subset.py runs
+ * before each device build and writes src/font_subset.cpp with only the
+ * glyphs the UI's strings use, as GFX free fonts with the same cell
+ * metrics. Font 1 (GLCD) and font 7 (digits only) stay built in.
+ */
+
+#ifndef FONT_SUBSET_H
+#define FONT_SUBSET_H
+
+#include <TFT_eSPI.h>
+
+extern const GFXfont fontSubset2;
+extern const GFXfont fontSubset4;
+
+// Subset standing in for a built-in font number, NULL if it is built in
+inline const GFXfont* subsetFont(uint8_t font) {
+    switch (font) {
+        case 2:  return &fontSubset2;
+        case 4:  return &fontSubset4;
+        default: return NULL;
+    }
+}
+
+#endif // FONT_SUBSET_H
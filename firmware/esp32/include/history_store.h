@@ -0,0 +1,36 @@
+/**
+ * Roxy RedLight v2.0 - Session History Store
+ *
+ * Session records appended to a LittleFS file on the flash filesystem
+ * partition, oldest first. Pages are read back by offset, through the
+ * HistoryCache the history screen pages with.
+ */
+
+#ifndef HISTORY_STORE_H
+#define HISTORY_STORE_H
+
+#include "history.h"
+
+class HistoryStore {
+public:
+    HistoryStore();
+
+    // Mount the filesystem (formatting it on first use) and count records
+    bool begin();
+
+    // Add a record at the end
+    bool append(const HistoryRecord& record);
+
+    uint32_t count() { return records; }
+
+    // HistoryReadFn over a store passed as ctx
+    static uint16_t read(void* ctx, uint32_t first, HistoryRecord* out, uint16_t count);
+
+private:
+    bool mounted;
+    uint32_t records;
+};
+
+extern HistoryStore historyStore;
+
+#endif // HISTORY_STORE_H
@@ -0,0 +1,54 @@
+/**
+ * Roxy RedLight v2.0 - Parallel Panel Driver
+ *
+ * ST7789 over the ESP32-S3 LCD_CAM 8-bit i80 bus (esp_lcd), with the subset
+ * of the TFT_eSPI push API that Display uses. Every transfer is DMA; the
+ * TFT_eSPI base is only the sprites' parent (fonts) and never touches SPI.
+ */
+
+#ifndef I80_PANEL_H
+#define I80_PANEL_H
+
+#include <TFT_eSPI.h>
+#include <esp_idf_version.h>
+#include <esp_lcd_panel_io.h>
+#include <esp_lcd_panel_ops.h>
+#include "config.h"
+
+class I80Panel : public TFT_eSPI {
+public:
+    I80Panel();
+
+    // Bus, panel reset and ST7789 setup (replaces TFT_eSPI::init)
+    void init();
+    void setRotation(uint8_t rotation);
+    void fillScreen(uint32_t color);
+
+    // Transfers always use DMA: nothing to set up, no CS to hold
+    bool initDMA() { return bus != NULL; }
+    void startWrite() {}
+
+    // Queue a window of panel-order RGB565 pixels. The buffer must stay
+    // untouched until dmaBusy() is false (DMA-capable RAM, or PSRAM rows)
+    void pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t* data);
+    void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t* data);
+
+    bool dmaBusy() { return pending != 0; }
+    void dmaWait();
+
+private:
+    esp_lcd_i80_bus_handle_t bus;
+    esp_lcd_panel_io_handle_t io;
+    esp_lcd_panel_handle_t panel;
+    volatile uint8_t pending;       // Transfers queued, not yet finished
+
+    // Transfer finished (ISR); the argument order changed in IDF 5
+    #if ESP_IDF_VERSION_MAJOR >= 5
+    static bool onDone(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t* event,
+                       void* ctx);
+    #else
+    static bool onDone(esp_lcd_panel_io_handle_t io, void* ctx, void* event);
+    #endif
+};
+
+#endif // I80_PANEL_H
@@ -0,0 +1,103 @@
+/**
+ * Roxy RedLight v2.0 - Sprite Canvas
+ *
+ * Canvas backed by a TFT_eSprite (PSRAM frame buffer on the T-Display S3)
+ */
+
+#ifndef SPRITE_CANVAS_H
+#define SPRITE_CANVAS_H
+
+#include <TFT_eSPI.h>
+#include "canvas.h"
+#include "font_subset.h"
+
+class SpriteCanvas : public Canvas {
+public:
+    explicit SpriteCanvas(TFT_eSPI* tft) : sprite(tft) {}
+
+    bool create(int16_t w, int16_t h, uint8_t depth, const uint16_t* palette,
+                bool internal = false) {
+        sprite.setPsram(!internal);
+        sprite.setColorDepth(depth);
+        sprite.createSprite(w, h);
+        if (depth == 4 && palette) {
+            sprite.createPalette(palette, 16);
+        }
+        return sprite.created();
+    }
+    void destroy() { sprite.deleteSprite(); }
+    bool created() { return sprite.created(); }
+    void* getPointer() { return sprite.getPointer(); }
+    uint16_t readPixelValue(int32_t x, int32_t y) { return sprite.readPixelValue(x, y); }
+    void setOffset(int32_t dx, int32_t dy) {
+        // A viewport datum above/left of the sprite shifts everything drawn
+        if (dx == 0 && dy == 0) {
+            sprite.resetViewport();
+        } else {
+            sprite.setViewport(-dx, -dy, sprite.width() + dx, sprite.height() + dy, true);
+        }
+    }
+
+    void fillScreen(uint32_t color) { sprite.fillSprite(color); }
+    void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+        sprite.fillRect(x, y, w, h, color);
+    }
+    void drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+        sprite.drawRect(x, y, w, h, color);
+    }
+    void fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color) {
+        sprite.fillRoundRect(x, y, w, h, r, color);
+    }
+    void drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color) {
+        sprite.drawRoundRect(x, y, w, h, r, color);
+    }
+    void fillCircle(int32_t x, int32_t y, int32_t r, uint32_t color) {
+        sprite.fillCircle(x, y, r, color);
+    }
+    void drawCircle(int32_t x, int32_t y, int32_t r, uint32_t color) {
+        sprite.drawCircle(x, y, r, color);
+    }
+    void drawBitmap(int16_t x, int16_t y, const uint8_t* bitmap,
+                    int16_t w, int16_t h, uint16_t fg, uint16_t bg) {
+        sprite.drawBitmap(x, y, bitmap, w, h, fg, bg);
+    }
+
+    // Font numbers with a subset select it as the free font instead
+    void setTextFont(uint8_t font) {
+        const GFXfont* subset = subsetFont(font);
+        if (subset) {
+            sprite.setFreeFont(subset);
+        } else {
+            sprite.setTextFont(font);
+        }
+    }
+    void setTextColor(uint16_t fg, uint16_t bg) { sprite.setTextColor(fg, bg); }
+    void setTextDatum(uint8_t datum) { sprite.setTextDatum(datum); }
+    int16_t drawString(const char* text, int32_t x, int32_t y) { return sprite.drawString(text, x, y); }
+    int16_t textWidth(const char* text) { return sprite.textWidth(text); }
+    int16_t textWidth(const char* text, uint8_t font) {
+        const GFXfont* subset = subsetFont(font);
+        if (subset == NULL) {
+            return sprite.textWidth(text, font);
+        }
+        // Every subset glyph is a full cell, so the width is the advances
+        int16_t w = 0;
+        for (; *text; text++) {
+            uint8_t c = *text;
+            if (c >= subset->first && c <= subset->last) {
+                w += subset->glyph[c - subset->first].xAdvance;
+            }
+        }
+        return w;
+    }
+    int16_t fontHeight() { return sprite.fontHeight(); }
+    int16_t fontHeight(int16_t font) {
+        const GFXfont* subset = subsetFont(font);
+        return subset ? subset->yAdvance : sprite.fontHeight(font);
+    }
+
+    // Direct window push, used when there is no staging buffer
+    TFT_eSprite sprite;
+};
+
+#endif // SPRITE_CANVAS_H
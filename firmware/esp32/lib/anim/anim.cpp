@@ -0,0 +1,152 @@
+/**
+ * Roxy RedLight v2.0 - Animation Implementation
+ */
+
+#include "anim.h"
+
+// =============================================================================
+// EASING
+// =============================================================================
+
+// Q16 product (64-bit intermediate: ANIM_ONE squared overflows 32 bits)
+static uint32_t mulQ16(uint32_t a, uint32_t b) {
+    return (uint32_t)(((uint64_t)a * b) >> 16);
+}
+
+uint32_t anim_ease(uint8_t ease, uint32_t t) {
+    if (t > ANIM_ONE) {
+        t = ANIM_ONE;
+    }
+
+    switch (ease) {
+        case EASE_IN:
+            return mulQ16(t, t);
+
+        case EASE_OUT: {
+            uint32_t r = ANIM_ONE - t;
+            return ANIM_ONE - mulQ16(r, r);
+        }
+
+        case EASE_IN_OUT:
+            // t^2 * (3 - 2t)
+            return mulQ16(mulQ16(t, t), 3 * ANIM_ONE - 2 * t);
+
+        default:
+            return t;
+    }
+}
+
+uint32_t anim_progress(uint32_t start, uint32_t duration, uint32_t now) {
+    if (duration == 0) {
+        return ANIM_ONE;
+    }
+    uint32_t elapsed = now - start;
+    if ((int32_t)elapsed < 0) {
+        return 0;
+    }
+    if (elapsed >= duration) {
+        return ANIM_ONE;
+    }
+    return (uint32_t)(((uint64_t)elapsed << 16) / duration);
+}
+
+int32_t anim_lerp(int32_t a, int32_t b, uint32_t f) {
+    int64_t delta = (int64_t)b - a;
+    return a + (int32_t)((delta * f + (int64_t)(ANIM_ONE / 2)) >> 16);
+}
+
+uint32_t anim_pulse(uint32_t now, uint32_t period) {
+    if (period == 0) {
+        return 0;
+    }
+
+    // Triangle 0 -> 1 -> 0, smoothed at both ends
+    uint32_t phase = (uint32_t)(((uint64_t)(now % period) << 17) / period);
+    uint32_t t = (phase > ANIM_ONE) ? 2 * ANIM_ONE - phase : phase;
+    return anim_ease(EASE_IN_OUT, t);
+}
+
+// =============================================================================
+// TWEENS
+// =============================================================================
+
+void tween_set(Tween* tween, int32_t value) {
+    tween->from = value;
+    tween->to = value;
+    tween->start = 0;
+    tween->duration = 0;
+    tween->ease = EASE_LINEAR;
+}
+
+void tween_to(Tween* tween, int32_t target, uint32_t now, uint16_t duration, uint8_t ease) {
+    if (target == tween->to) {
+        return;
+    }
+
+    // Retarget mid-flight from the value on screen, so it never jumps
+    tween->from = tween_value(tween, now);
+    tween->to = target;
+    tween->start = now;
+    tween->duration = duration;
+    tween->ease = ease;
+}
+
+int32_t tween_value(const Tween* tween, uint32_t now) {
+    uint32_t t = anim_progress(tween->start, tween->duration, now);
+    return anim_lerp(tween->from, tween->to, anim_ease(tween->ease, t));
+}
+
+bool tween_active(const Tween* tween, uint32_t now) {
+    return anim_progress(tween->start, tween->duration, now) < ANIM_ONE;
+}
+
+// =============================================================================
+// FRAME PACER
+// =============================================================================
+
+void pacer_init(FramePacer* pacer, uint32_t period, uint8_t maxLoad) {
+    pacer->period = period;
+    pacer->next = 0;
+    pacer->maxLoad = (maxLoad == 0) ? 1 : (maxLoad > 100) ? 100 : maxLoad;
+    pacer->running = false;
+    pacer->frames = 0;
+    pacer->dropped = 0;
+}
+
+void pacer_frame(FramePacer* pacer, uint32_t start, uint32_t end) {
+    pacer->frames++;
+
+    int32_t late = (int32_t)(start - pacer->next);
+    if (!pacer->running || late < 0) {
+        // First frame, or an early one (new data): the grid starts here
+        pacer->next = start + pacer->period;
+        pacer->running = true;
+    } else {
+        // Slots that went by while nothing was drawn
+        uint32_t missed = (uint32_t)late / pacer->period;
+        pacer->dropped += missed;
+        pacer->next += (missed + 1) * pacer->period;
+    }
+
+    // Leave the rest of the time to everything else: a frame that took
+    // cost us waits cost * (100 - maxLoad) / maxLoad before the next one
+    uint32_t cost = end - start;
+    uint32_t rest = (uint32_t)((uint64_t)cost * (100 - pacer->maxLoad) / pacer->maxLoad);
+    uint32_t earliest = end + rest;
+    while ((int32_t)(earliest - pacer->next) > 0) {
+        pacer->next += pacer->period;
+        pacer->dropped++;
+    }
+}
+
+void pacer_idle(FramePacer* pacer) {
+    pacer->running = false;
+}
+
+uint32_t pacer_wait(const FramePacer* pacer, uint32_t now) {
+    if (!pacer->running) {
+        return PACER_IDLE;
+    }
+    int32_t wait = (int32_t)(pacer->next - now);
+    return (wait > 0) ? (uint32_t)wait : 0;
+}
@@ -0,0 +1,167 @@
+/**
+ * Roxy RedLight v2.0 - Animation
+ *
+ * Testable fixed-point easing, tweens and the frame pacer that schedules
+ * animation frames (integer math only, times passed in by the caller)
+ */
+
+#ifndef ANIM_H
+#define ANIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// FIXED POINT
+// =============================================================================
+
+// Fractions are Q16: 0 = start, ANIM_ONE = end
+#define ANIM_ONE        65536UL
+
+// Returned by pacer_wait() when no frame is scheduled
+#define PACER_IDLE      0xFFFFFFFFUL
+
+typedef enum {
+    EASE_LINEAR = 0,
+    EASE_IN,            // Quadratic: slow start
+    EASE_OUT,           // Quadratic: slow end
+    EASE_IN_OUT         // Smoothstep: slow start and end
+} Ease;
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+// A value moving from one target to the next over a fixed time (ms)
+typedef struct {
+    int32_t from;
+    int32_t to;
+    uint32_t start;
+    uint16_t duration;
+    uint8_t ease;
+} Tween;
+
+// Frame schedule on a fixed period (us), with a cap on render load
+typedef struct {
+    uint32_t period;        // Frame period
+    uint32_t next;          // When the next frame is due
+    uint8_t maxLoad;        // Percent of the time frames may take
+    bool running;           // False until a frame starts the schedule
+    uint32_t frames;        // Frames paced
+    uint32_t dropped;       // Deadlines passed without a frame
+} FramePacer;
+
+// =============================================================================
+// EASING FUNCTIONS
+// =============================================================================
+
+/**
+ * Apply an easing curve
+ * @param ease Ease curve
+ * @param t Linear fraction (Q16, clamped to 0..ANIM_ONE)
+ * @return Eased fraction (Q16, 0..ANIM_ONE)
+ */
+uint32_t anim_ease(uint8_t ease, uint32_t t);
+
+/**
+ * How far through an interval a time is (wrap-safe)
+ * @param start Interval start
+ * @param duration Interval length (0 = already over)
+ * @param now Current time
+ * @return Fraction (Q16, 0..ANIM_ONE)
+ */
+uint32_t anim_progress(uint32_t start, uint32_t duration, uint32_t now);
+
+/**
+ * Interpolate between two values
+ * @param a Value at 0
+ * @param b Value at ANIM_ONE
+ * @param f Fraction (Q16)
+ * @return a + (b - a) * f, rounded to nearest
+ */
+int32_t anim_lerp(int32_t a, int32_t b, uint32_t f);
+
+/**
+ * Smooth pulse: 0 at the start of each period, ANIM_ONE halfway
+ * @param now Current time
+ * @param period Pulse period (same unit as now)
+ * @return Pulse level (Q16, 0..ANIM_ONE)
+ */
+uint32_t anim_pulse(uint32_t now, uint32_t period);
+
+// =============================================================================
+// TWEEN FUNCTIONS
+// =============================================================================
+
+/**
+ * Jump to a value with no animation
+ * @param tween Pointer to tween
+ * @param value New value
+ */
+void tween_set(Tween* tween, int32_t value);
+
+/**
+ * Move towards a new target from wherever the tween is now. Does nothing
+ * if the target is unchanged, so it can be called every frame.
+ * @param tween Pointer to tween
+ * @param target Value to end at
+ * @param now Current time (ms)
+ * @param duration Time to get there (ms)
+ * @param ease Ease curve
+ */
+void tween_to(Tween* tween, int32_t target, uint32_t now, uint16_t duration, uint8_t ease);
+
+/**
+ * Value at a time
+ * @param tween Pointer to tween
+ * @param now Current time (ms)
+ * @return Interpolated value (the target once finished)
+ */
+int32_t tween_value(const Tween* tween, uint32_t now);
+
+/**
+ * Check if the tween is still moving
+ * @param tween Pointer to tween
+ * @param now Current time (ms)
+ * @return true before the target is reached
+ */
+bool tween_active(const Tween* tween, uint32_t now);
+
+// =============================================================================
+// FRAME PACER FUNCTIONS
+// =============================================================================
+
+/**
+ * Set up an idle pacer
+ * @param pacer Pointer to pacer
+ * @param period Frame period (us)
+ * @param maxLoad Largest share of the time frames may take (1-100 percent)
+ */
+void pacer_init(FramePacer* pacer, uint32_t period, uint8_t maxLoad);
+
+/**
+ * Record a rendered frame and schedule the next one. Frames are due on a
+ * fixed grid; missed grid slots count as dropped. A slow frame pushes the
+ * next one out (dropping slots) so rendering stays under maxLoad.
+ * @param pacer Pointer to pacer
+ * @param start When the frame started (us)
+ * @param end When it finished (us)
+ */
+void pacer_frame(FramePacer* pacer, uint32_t start, uint32_t end);
+
+/**
+ * Stop scheduling: nothing is moving. The next frame restarts the grid
+ * without counting the idle time as dropped frames.
+ * @param pacer Pointer to pacer
+ */
+void pacer_idle(FramePacer* pacer);
+
+/**
+ * Time until the next frame is due
+ * @param pacer Pointer to pacer
+ * @param now Current time (us)
+ * @return Microseconds to wait, 0 if due, PACER_IDLE if idle
+ */
+uint32_t pacer_wait(const FramePacer* pacer, uint32_t now);
+
+#endif // ANIM_H
@@ -0,0 +1,170 @@
+/**
+ * Roxy RedLight v2.0 - Image Assets Implementation
+ */
+
+#include "asset.h"
+#include <string.h>
+
+// =============================================================================
+// ENCODER
+// =============================================================================
+
+uint32_t asset_encode(const uint8_t* pixels, uint32_t count, uint8_t* out, uint32_t capacity) {
+    uint32_t bytes = 0;
+    uint32_t i = 0;
+
+    while (i < count) {
+        uint8_t index = pixels[i] & 0x0F;
+        uint32_t run = 1;
+        while (i + run < count && run < ASSET_RUN_MAX && pixels[i + run] == pixels[i]) {
+            run++;
+        }
+
+        uint8_t need = (run < ASSET_LONG_MIN) ? 1 : 2;
+        if (out != NULL) {
+            if (bytes + need > capacity) {
+                return 0;
+            }
+            if (need == 1) {
+                out[bytes] = (index << 4) | (run - 1);
+            } else {
+                out[bytes] = (index << 4) | ASSET_RUN_LONG;
+                out[bytes + 1] = run - ASSET_LONG_MIN;
+            }
+        }
+        bytes += need;
+        i += run;
+    }
+    return bytes;
+}
+
+bool asset_valid(const Asset* asset) {
+    uint32_t pixels = (uint32_t)asset->width * asset->height;
+    uint32_t count = 0;
+    uint32_t pos = 0;
+
+    while (pos < asset->size) {
+        uint8_t token = asset->data[pos++];
+        uint32_t run = (token & 0x0F) + 1;
+        if ((token & 0x0F) == ASSET_RUN_LONG) {
+            if (pos >= asset->size) {
+                return false;   // Long run cut off
+            }
+            run = ASSET_LONG_MIN + asset->data[pos++];
+        }
+        if ((token >> 4) >= asset->colors) {
+            return false;
+        }
+        count += run;
+    }
+    return count == pixels;
+}
+
+// =============================================================================
+// DECODER
+// =============================================================================
+
+// Load the next run; a stream that ends early pads with transparency
+static void nextRun(AssetReader* reader) {
+    const Asset* asset = reader->asset;
+    if (reader->pos >= asset->size) {
+        reader->index = (asset->transparent != ASSET_OPAQUE) ? asset->transparent : 0;
+        reader->left = 0xFFFF;
+        return;
+    }
+
+    uint8_t token = asset->data[reader->pos++];
+    reader->index = token >> 4;
+    reader->left = (token & 0x0F) + 1;
+    if ((token & 0x0F) == ASSET_RUN_LONG && reader->pos < asset->size) {
+        reader->left = ASSET_LONG_MIN + asset->data[reader->pos++];
+    }
+}
+
+void asset_begin(AssetReader* reader, const Asset* asset) {
+    reader->asset = asset;
+    reader->pos = 0;
+    reader->row = 0;
+    reader->index = 0;
+    reader->left = 0;
+}
+
+void asset_skip_rows(AssetReader* reader, uint16_t rows) {
+    uint32_t pixels = (uint32_t)rows * reader->asset->width;
+    while (pixels > 0) {
+        if (reader->left == 0) {
+            nextRun(reader);
+        }
+        uint32_t n = (reader->left < pixels) ? reader->left : pixels;
+        reader->left -= n;
+        pixels -= n;
+    }
+    reader->row += rows;
+}
+
+// Fill pixels [x0, x1) of a 4 bpp row with one value
+static void fill4(uint8_t* row, int16_t x0, int16_t x1, uint8_t value) {
+    if (x0 & 1) {
+        row[x0 >> 1] = (row[x0 >> 1] & 0xF0) | value;
+        x0++;
+    }
+    int16_t pairs = (x1 - x0) >> 1;
+    if (pairs > 0) {
+        memset(row + (x0 >> 1), (value << 4) | value, pairs);
+        x0 += pairs << 1;
+    }
+    if (x0 < x1) {
+        row[x0 >> 1] = (row[x0 >> 1] & 0x0F) | (value << 4);
+    }
+}
+
+void asset_decode_row4(AssetReader* reader, uint8_t* row, int16_t x, int16_t width,
+                       const uint8_t* map) {
+    uint8_t transparent = reader->asset->transparent;
+    uint16_t remaining = reader->asset->width;
+
+    while (remaining > 0) {
+        if (reader->left == 0) {
+            nextRun(reader);
+        }
+        uint16_t n = (reader->left < remaining) ? reader->left : remaining;
+
+        int16_t x0 = (x < 0) ? 0 : x;
+        int16_t x1 = (x + n > width) ? width : x + n;
+        if (x0 < x1 && reader->index != transparent) {
+            fill4(row, x0, x1, map[reader->index] & 0x0F);
+        }
+
+        x += n;
+        reader->left -= n;
+        remaining -= n;
+    }
+    reader->row++;
+}
+
+void asset_decode_row16(AssetReader* reader, uint16_t* row, int16_t x, int16_t width,
+                        const uint16_t* map) {
+    uint8_t transparent = reader->asset->transparent;
+    uint16_t remaining = reader->asset->width;
+
+    while (remaining > 0) {
+        if (reader->left == 0) {
+            nextRun(reader);
+        }
+        uint16_t n = (reader->left < remaining) ? reader->left : remaining;
+
+        int16_t x0 = (x < 0) ? 0 : x;
+        int16_t x1 = (x + n > width) ? width : x + n;
+        if (x0 < x1 && reader->index != transparent) {
+            uint16_t value = map[reader->index];
+            for (int16_t i = x0; i < x1; i++) {
+                row[i] = value;
+            }
+        }
+
+        x += n;
+        reader->left -= n;
+        remaining -= n;
+    }
+    reader->row++;
+}
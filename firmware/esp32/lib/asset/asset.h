@@ -0,0 +1,119 @@
+/**
+ * Roxy RedLight v2.0 - Image Assets
+ *
+ * Testable palette-RLE image streams: encoded on the host (tools/), kept in
+ * flash as const data and decoded a scanline at a time straight into a
+ * frame buffer row
+ */
+
+#ifndef ASSET_H
+#define ASSET_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// STREAM FORMAT
+// =============================================================================
+
+// Pixels are indices into the asset's own palette (at most 16 colors), in
+// row-major order. The stream is a list of runs, which may carry on into
+// the next row. Each run starts with one byte:
+//   high nibble - palette index
+//   low nibble  - run length - 1 (1 to 15 pixels), or ASSET_RUN_LONG:
+//                 the next byte holds length - ASSET_LONG_MIN (16 to 271)
+#define ASSET_MAX_COLORS    16
+#define ASSET_RUN_LONG      0x0F
+#define ASSET_LONG_MIN      16
+#define ASSET_RUN_MAX       (ASSET_LONG_MIN + 255)
+
+// No palette index is left undrawn
+#define ASSET_OPAQUE        0xFF
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+// An encoded image (all pointers into flash)
+typedef struct {
+    uint16_t width;
+    uint16_t height;
+    uint8_t colors;             // Palette entries used
+    uint8_t transparent;        // Index that is not drawn, or ASSET_OPAQUE
+    const uint16_t* palette;    // RGB565 per index
+    const uint8_t* data;        // Run stream
+    uint32_t size;              // Stream bytes
+} Asset;
+
+// Decoding position within an asset, one row at a time
+typedef struct {
+    const Asset* asset;
+    uint32_t pos;               // Next stream byte
+    uint16_t row;               // Next row to decode
+    uint8_t index;              // Current run's palette index
+    uint16_t left;              // Pixels left in the current run
+} AssetReader;
+
+// =============================================================================
+// ENCODER (host tools and tests)
+// =============================================================================
+
+/**
+ * Encode palette indices as a run stream
+ * @param pixels Index per pixel, row-major (each < ASSET_MAX_COLORS)
+ * @param count Pixels (width * height)
+ * @param out Output buffer, or NULL to only measure
+ * @param capacity Output buffer size
+ * @return Stream bytes, or 0 if they do not fit
+ */
+uint32_t asset_encode(const uint8_t* pixels, uint32_t count, uint8_t* out, uint32_t capacity);
+
+/**
+ * Check that a stream decodes to exactly width * height pixels
+ * @param asset Pointer to asset
+ * @return true if the stream is well formed
+ */
+bool asset_valid(const Asset* asset);
+
+// =============================================================================
+// DECODER FUNCTIONS
+// =============================================================================
+
+/**
+ * Start decoding at the first row
+ * @param reader Pointer to reader
+ * @param asset Asset to decode
+ */
+void asset_begin(AssetReader* reader, const Asset* asset);
+
+/**
+ * Pass over rows without drawing them (whole runs at a time)
+ * @param reader Pointer to reader
+ * @param rows Rows to skip
+ */
+void asset_skip_rows(AssetReader* reader, uint16_t rows);
+
+/**
+ * Decode the next row into a 4 bpp row (two pixels per byte, even x in the
+ * high nibble). Transparent pixels and pixels outside the row are skipped.
+ * @param reader Pointer to reader
+ * @param row Destination row
+ * @param x Column of the asset's left edge in the row (may be negative)
+ * @param width Destination row width in pixels
+ * @param map Sprite value per asset palette index
+ */
+void asset_decode_row4(AssetReader* reader, uint8_t* row, int16_t x, int16_t width,
+                       const uint8_t* map);
+
+/**
+ * Decode the next row into a 16 bpp row, as asset_decode_row4()
+ * @param reader Pointer to reader
+ * @param row Destination row
+ * @param x Column of the asset's left edge in the row (may be negative)
+ * @param width Destination row width in pixels
+ * @param map Sprite value per asset palette index
+ */
+void asset_decode_row16(AssetReader* reader, uint16_t* row, int16_t x, int16_t width,
+                        const uint16_t* map);
+
+#endif // ASSET_H
@@ -0,0 +1,82 @@
+/**
+ * Roxy RedLight v2.0 - Canvas Interface
+ *
+ * The drawing surface Display renders into: a TFT_eSprite on the device,
+ * a plain host-memory buffer in the native bench
+ */
+
+#ifndef CANVAS_H
+#define CANVAS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// TEXT DATUMS (same values as TFT_eSPI)
+// =============================================================================
+
+#ifndef TL_DATUM
+#define TL_DATUM    0   // Top left
+#define TC_DATUM    1   // Top centre
+#define TR_DATUM    2   // Top right
+#define ML_DATUM    3   // Middle left
+#define MC_DATUM    4   // Middle centre
+#define MR_DATUM    5   // Middle right
+#define BL_DATUM    6   // Bottom left
+#define BC_DATUM    7   // Bottom centre
+#define BR_DATUM    8   // Bottom right
+#endif
+
+// =============================================================================
+// CANVAS
+// =============================================================================
+
+/**
+ * Colors are sprite values: RGB565 at 16 bpp, a palette index at 4 bpp,
+ * 0/1 at 1 bpp. Buffer layout matches TFT_eSprite so frames can be copied
+ * and pushed the same way on both backends:
+ *   16 bpp - RGB565 in panel (byte-swapped) order
+ *    4 bpp - two pixels per byte, even x in the high nibble
+ *    1 bpp - rows padded to whole bytes, MSB first
+ */
+class Canvas {
+public:
+    virtual ~Canvas() {}
+
+    // Buffer (internal: keep it out of PSRAM, for small working buffers)
+    virtual bool create(int16_t w, int16_t h, uint8_t depth, const uint16_t* palette,
+                        bool internal = false) = 0;
+    virtual void destroy() = 0;
+    virtual bool created() = 0;
+    virtual void* getPointer() = 0;
+    virtual uint16_t readPixelValue(int32_t x, int32_t y) = 0;
+
+    // Drawing origin: shapes and text land at (x - dx, y - dy), clipped to
+    // the buffer, so a strip of the screen can be drawn with screen
+    // coordinates. fillScreen(), getPointer() and readPixelValue() always
+    // address the whole buffer.
+    virtual void setOffset(int32_t dx, int32_t dy) = 0;
+
+    // Shapes
+    virtual void fillScreen(uint32_t color) = 0;
+    virtual void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) = 0;
+    virtual void drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) = 0;
+    virtual void fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color) = 0;
+    virtual void drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color) = 0;
+    virtual void fillCircle(int32_t x, int32_t y, int32_t r, uint32_t color) = 0;
+    virtual void drawCircle(int32_t x, int32_t y, int32_t r, uint32_t color) = 0;
+    virtual void drawBitmap(int16_t x, int16_t y, const uint8_t* bitmap,
+                            int16_t w, int16_t h, uint16_t fg, uint16_t bg) = 0;
+
+    // Text (TFT_eSPI built-in font numbers)
+    virtual void setTextFont(uint8_t font) = 0;
+    virtual void setTextColor(uint16_t fg, uint16_t bg) = 0;
+    virtual void setTextDatum(uint8_t datum) = 0;
+    virtual int16_t drawString(const char* text, int32_t x, int32_t y) = 0;
+    virtual int16_t textWidth(const char* text) = 0;
+    virtual int16_t textWidth(const char* text, uint8_t font) = 0;
+    virtual int16_t fontHeight() = 0;
+    virtual int16_t fontHeight(int16_t font) = 0;
+};
+
+#endif // CANVAS_H
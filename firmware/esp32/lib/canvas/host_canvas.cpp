@@ -0,0 +1,322 @@
+/**
+ * Roxy RedLight v2.0 - Host Canvas Implementation
+ */
+
+#include "host_canvas.h"
+#include <stdlib.h>
+#include <string.h>
+
+uint32_t HostCanvas::pixelsWritten = 0;
+
+// =============================================================================
+// FONT METRICS
+// =============================================================================
+
+// Cell sizes of TFT_eSPI's built-in fonts (proportional in reality)
+typedef struct {
+    uint8_t font;
+    uint8_t width;
+    uint8_t height;
+} FontMetrics;
+
+static const FontMetrics fonts[] = {
+    {1, 6, 8},
+    {2, 8, 16},
+    {4, 14, 26},
+    {6, 24, 48},
+    {7, 32, 48},
+    {8, 55, 75}
+};
+
+static const FontMetrics& metrics(uint8_t font) {
+    for (size_t i = 0; i < sizeof(fonts) / sizeof(fonts[0]); i++) {
+        if (fonts[i].font == font) {
+            return fonts[i];
+        }
+    }
+    return fonts[0];
+}
+
+static int16_t charWidth(const FontMetrics& m, char c) {
+    // Separators are narrow in every built-in font
+    return (c == ' ' || c == ':' || c == '.') ? m.width / 2 : m.width;
+}
+
+// Largest d with d*d + dy*dy <= r*r
+static int32_t span(int32_t r, int32_t dy) {
+    int32_t d = r;
+    while (d > 0 && d * d + dy * dy > r * r) {
+        d--;
+    }
+    return d;
+}
+
+// =============================================================================
+// BUFFER
+// =============================================================================
+
+HostCanvas::HostCanvas(HostPanel* panel) {
+    buf = NULL;
+    width = 0;
+    height = 0;
+    rowPixels = 0;
+    depth = 16;
+    offsetX = 0;
+    offsetY = 0;
+    textFont = 1;
+    textDatum = TL_DATUM;
+    textFg = 0xFFFF;
+    textBg = 0x0000;
+}
+
+HostCanvas::~HostCanvas() {
+    destroy();
+}
+
+bool HostCanvas::create(int16_t w, int16_t h, uint8_t bpp, const uint16_t* palette,
+                        bool internal) {
+    destroy();
+
+    // Same row padding as TFT_eSprite
+    depth = bpp;
+    rowPixels = (depth == 1) ? (w + 7) & ~7 : (depth == 4) ? (w + 1) & ~1 : w;
+    buf = (uint8_t*)calloc((size_t)rowPixels * h * depth / 8, 1);
+    if (buf == NULL) {
+        return false;
+    }
+    width = w;
+    height = h;
+    return true;
+}
+
+void HostCanvas::destroy() {
+    free(buf);
+    buf = NULL;
+    width = 0;
+    height = 0;
+}
+
+bool HostCanvas::created() {
+    return buf != NULL;
+}
+
+void* HostCanvas::getPointer() {
+    return buf;
+}
+
+uint16_t HostCanvas::readPixelValue(int32_t x, int32_t y) {
+    if (buf == NULL || x < 0 || y < 0 || x >= width || y >= height) {
+        return 0;
+    }
+    uint32_t index = (uint32_t)y * rowPixels + x;
+    if (depth == 16) {
+        uint16_t v = ((uint16_t*)buf)[index];
+        return (v >> 8) | (v << 8);
+    }
+    if (depth == 4) {
+        uint8_t pair = buf[index >> 1];
+        return (index & 1) ? (pair & 0x0F) : (pair >> 4);
+    }
+    return (buf[index >> 3] >> (7 - (index & 7))) & 1;
+}
+
+void HostCanvas::setOffset(int32_t dx, int32_t dy) {
+    offsetX = dx;
+    offsetY = dy;
+}
+
+void HostCanvas::pixel(int32_t x, int32_t y, uint32_t color) {
+    x -= offsetX;
+    y -= offsetY;
+    if (buf == NULL || x < 0 || y < 0 || x >= width || y >= height) {
+        return;
+    }
+    uint32_t index = (uint32_t)y * rowPixels + x;
+    if (depth == 16) {
+        ((uint16_t*)buf)[index] = (uint16_t)((color >> 8) | (color << 8));
+    } else if (depth == 4) {
+        uint8_t& pair = buf[index >> 1];
+        pair = (index & 1) ? (pair & 0xF0) | (color & 0x0F)
+                           : (pair & 0x0F) | ((color & 0x0F) << 4);
+    } else {
+        uint8_t mask = 0x80 >> (index & 7);
+        buf[index >> 3] = (color & 1) ? (buf[index >> 3] | mask) : (buf[index >> 3] & ~mask);
+    }
+    pixelsWritten++;
+}
+
+void HostCanvas::hline(int32_t x, int32_t y, int32_t w, uint32_t color) {
+    for (int32_t i = 0; i < w; i++) {
+        pixel(x + i, y, color);
+    }
+}
+
+void HostCanvas::vline(int32_t x, int32_t y, int32_t h, uint32_t color) {
+    for (int32_t i = 0; i < h; i++) {
+        pixel(x, y + i, color);
+    }
+}
+
+// Midpoint circle quadrants: bit 0 top-left, 1 top-right, 2 bottom-right,
+// 3 bottom-left
+void HostCanvas::arc(int32_t cx, int32_t cy, int32_t r, uint8_t corners, uint32_t color) {
+    int32_t f = 1 - r;
+    int32_t ddx = 1;
+    int32_t ddy = -2 * r;
+    int32_t px = 0;
+    int32_t py = r;
+
+    while (px <= py) {
+        if (corners & 0x1) { pixel(cx - py, cy - px, color); pixel(cx - px, cy - py, color); }
+        if (corners & 0x2) { pixel(cx + px, cy - py, color); pixel(cx + py, cy - px, color); }
+        if (corners & 0x4) { pixel(cx + py, cy + px, color); pixel(cx + px, cy + py, color); }
+        if (corners & 0x8) { pixel(cx - px, cy + py, color); pixel(cx - py, cy + px, color); }
+
+        if (f >= 0) {
+            py--;
+            ddy += 2;
+            f += ddy;
+        }
+        px++;
+        ddx += 2;
+        f += ddx;
+    }
+}
+
+// =============================================================================
+// SHAPES
+// =============================================================================
+
+void HostCanvas::fillScreen(uint32_t color) {
+    fillRect(offsetX, offsetY, width, height, color);
+}
+
+void HostCanvas::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    for (int32_t j = 0; j < h; j++) {
+        hline(x, y + j, w, color);
+    }
+}
+
+void HostCanvas::drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    if (w <= 0 || h <= 0) {
+        return;
+    }
+    hline(x, y, w, color);
+    hline(x, y + h - 1, w, color);
+    vline(x, y + 1, h - 2, color);
+    vline(x + w - 1, y + 1, h - 2, color);
+}
+
+void HostCanvas::fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color) {
+    int32_t limit = ((w < h) ? w : h) / 2;
+    if (r > limit) {
+        r = limit;
+    }
+
+    for (int32_t j = 0; j < h; j++) {
+        // Distance into a corner's rows
+        int32_t d = (j < r) ? r - j : (j >= h - r) ? j - (h - 1 - r) : 0;
+        int32_t inset = d ? r - span(r, d) : 0;
+        hline(x + inset, y + j, w - 2 * inset, color);
+    }
+}
+
+void HostCanvas::drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color) {
+    int32_t limit = ((w < h) ? w : h) / 2;
+    if (r > limit) {
+        r = limit;
+    }
+
+    hline(x + r, y, w - 2 * r, color);
+    hline(x + r, y + h - 1, w - 2 * r, color);
+    vline(x, y + r, h - 2 * r, color);
+    vline(x + w - 1, y + r, h - 2 * r, color);
+
+    arc(x + r, y + r, r, 0x1, color);
+    arc(x + w - 1 - r, y + r, r, 0x2, color);
+    arc(x + w - 1 - r, y + h - 1 - r, r, 0x4, color);
+    arc(x + r, y + h - 1 - r, r, 0x8, color);
+}
+
+void HostCanvas::fillCircle(int32_t x, int32_t y, int32_t r, uint32_t color) {
+    for (int32_t dy = -r; dy <= r; dy++) {
+        int32_t dx = span(r, dy);
+        hline(x - dx, y + dy, 2 * dx + 1, color);
+    }
+}
+
+void HostCanvas::drawCircle(int32_t x, int32_t y, int32_t r, uint32_t color) {
+    arc(x, y, r, 0xF, color);
+}
+
+void HostCanvas::drawBitmap(int16_t x, int16_t y, const uint8_t* bitmap,
+                            int16_t w, int16_t h, uint16_t fg, uint16_t bg) {
+    int16_t rowBytes = (w + 7) / 8;
+    for (int16_t j = 0; j < h; j++) {
+        for (int16_t i = 0; i < w; i++) {
+            bool set = bitmap[j * rowBytes + i / 8] & (0x80 >> (i & 7));
+            pixel(x + i, y + j, set ? fg : bg);
+        }
+    }
+}
+
+// =============================================================================
+// TEXT
+// =============================================================================
+
+void HostCanvas::setTextFont(uint8_t font) {
+    textFont = font;
+}
+
+void HostCanvas::setTextColor(uint16_t fg, uint16_t bg) {
+    textFg = fg;
+    textBg = bg;
+}
+
+void HostCanvas::setTextDatum(uint8_t datum) {
+    textDatum = datum;
+}
+
+int16_t HostCanvas::drawString(const char* text, int32_t x, int32_t y) {
+    const FontMetrics& m = metrics(textFont);
+    int16_t w = textWidth(text);
+
+    // Datum columns L/C/R, rows T/M/B
+    int32_t cx = x - ((textDatum % 3) * w) / 2;
+    int32_t cy = y - ((textDatum / 3) * m.height) / 2;
+
+    for (const char* c = text; *c; c++) {
+        int16_t cw = charWidth(m, *c);
+
+        // Background fill as for TFT_eSPI fonts drawn with a bg color
+        if (textBg != textFg) {
+            fillRect(cx, cy, cw, m.height, textBg);
+        }
+        if (*c != ' ') {
+            drawRect(cx + 1, cy + 1, cw - 2, m.height - 2, textFg);
+        }
+        cx += cw;
+    }
+    return w;
+}
+
+int16_t HostCanvas::textWidth(const char* text) {
+    return textWidth(text, textFont);
+}
+
+int16_t HostCanvas::textWidth(const char* text, uint8_t font) {
+    const FontMetrics& m = metrics(font);
+    int16_t w = 0;
+    for (const char* c = text; *c; c++) {
+        w += charWidth(m, *c);
+    }
+    return w;
+}
+
+int16_t HostCanvas::fontHeight() {
+    return metrics(textFont).height;
+}
+
+int16_t HostCanvas::fontHeight(int16_t font) {
+    return metrics(font).height;
+}
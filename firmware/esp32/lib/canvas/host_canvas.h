@@ -0,0 +1,97 @@
+/**
+ * Roxy RedLight v2.0 - Host Canvas
+ *
+ * Canvas backed by a plain buffer in host memory, plus a panel that
+ * accepts pushes and discards them. Lets display.cpp run natively.
+ */
+
+#ifndef HOST_CANVAS_H
+#define HOST_CANVAS_H
+
+#include "canvas.h"
+
+// =============================================================================
+// HOST PANEL
+// =============================================================================
+
+// The subset of TFT_eSPI that Display pushes through; transfers finish
+// immediately and go nowhere
+class HostPanel {
+public:
+    void init() {}
+    void setRotation(uint8_t rotation) {}
+    void fillScreen(uint32_t color) {}
+    bool initDMA() { return true; }
+    void startWrite() {}
+    bool dmaBusy() { return false; }
+    void dmaWait() {}
+    void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t* data) {}
+    void pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t* data) {}
+};
+
+// =============================================================================
+// HOST CANVAS
+// =============================================================================
+
+/**
+ * Shapes follow TFT_eSPI's geometry closely enough for dirty tracking and
+ * push sizes. Text has TFT_eSPI-like per-font cell metrics but draws each
+ * character as a box: good for measuring, not for looking at.
+ */
+class HostCanvas : public Canvas {
+public:
+    // Panel argument mirrors TFT_eSprite's constructor (unused)
+    explicit HostCanvas(HostPanel* panel = 0);
+    ~HostCanvas();
+
+    bool create(int16_t w, int16_t h, uint8_t depth, const uint16_t* palette,
+                bool internal = false);
+    void destroy();
+    bool created();
+    void* getPointer();
+    uint16_t readPixelValue(int32_t x, int32_t y);
+    void setOffset(int32_t dx, int32_t dy);
+
+    void fillScreen(uint32_t color);
+    void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+    void drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+    void fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color);
+    void drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color);
+    void fillCircle(int32_t x, int32_t y, int32_t r, uint32_t color);
+    void drawCircle(int32_t x, int32_t y, int32_t r, uint32_t color);
+    void drawBitmap(int16_t x, int16_t y, const uint8_t* bitmap,
+                    int16_t w, int16_t h, uint16_t fg, uint16_t bg);
+
+    void setTextFont(uint8_t font);
+    void setTextColor(uint16_t fg, uint16_t bg);
+    void setTextDatum(uint8_t datum);
+    int16_t drawString(const char* text, int32_t x, int32_t y);
+    int16_t textWidth(const char* text);
+    int16_t textWidth(const char* text, uint8_t font);
+    int16_t fontHeight();
+    int16_t fontHeight(int16_t font);
+
+    // Pixels stored by every host canvas since the last reset
+    static uint32_t pixelsWritten;
+
+private:
+    void pixel(int32_t x, int32_t y, uint32_t color);
+    void hline(int32_t x, int32_t y, int32_t w, uint32_t color);
+    void vline(int32_t x, int32_t y, int32_t h, uint32_t color);
+    void arc(int32_t cx, int32_t cy, int32_t r, uint8_t corners, uint32_t color);
+
+    uint8_t* buf;
+    int16_t width;
+    int16_t height;
+    int16_t rowPixels;      // Width padded to whole bytes
+    uint8_t depth;
+    int32_t offsetX;
+    int32_t offsetY;
+
+    uint8_t textFont;
+    uint8_t textDatum;
+    uint16_t textFg;
+    uint16_t textBg;
+};
+
+#endif // HOST_CANVAS_H
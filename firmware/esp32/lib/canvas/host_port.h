@@ -0,0 +1,92 @@
+/**
+ * Roxy RedLight v2.0 - Host Port
+ *
+ * The few Arduino/ESP-IDF calls display.cpp makes, for native builds
+ */
+
+#ifndef HOST_PORT_H
+#define HOST_PORT_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Timing from the monotonic clock
+inline unsigned long micros() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long)ts.tv_sec * 1000000UL + ts.tv_nsec / 1000;
+}
+
+// Animation time (millis) can be stepped by hand for repeatable runs
+struct HostClock {
+    bool manual;
+    unsigned long ms;
+};
+
+inline HostClock& hostClock() {
+    static HostClock clock = {false, 0};
+    return clock;
+}
+
+inline unsigned long millis() {
+    if (hostClock().manual) {
+        return hostClock().ms;
+    }
+    return micros() / 1000;
+}
+
+// Cycle counter ticking at a nominal 1000 MHz (1 cycle = 1 ns)
+class HostEsp {
+public:
+    uint32_t getCycleCount() {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+    }
+    uint32_t getCpuFreqMHz() { return 1000; }
+};
+
+inline HostEsp ESP;
+
+// Serial output goes to stdout
+class HostSerial {
+public:
+    void println(const char* text) { puts(text); }
+    int printf(const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        int n = vprintf(format, args);
+        va_end(args);
+        return n;
+    }
+};
+
+inline HostSerial Serial;
+
+// One heap: PSRAM and DMA-capable allocations come from malloc
+#define MALLOC_CAP_DMA          (1 << 3)
+#define MALLOC_CAP_SPIRAM       (1 << 10)
+#define MALLOC_CAP_INTERNAL     (1 << 11)
+#define ps_malloc(size)                 malloc(size)
+#define heap_caps_malloc(size, caps)    malloc(size)
+
+inline size_t heap_caps_get_free_size(uint32_t caps) {
+    return 0;   // Not tracked on the host
+}
+
+// No GPIO: backlight calls do nothing
+#define OUTPUT  0x03
+#define HIGH    0x1
+#define LOW     0x0
+
+inline void pinMode(uint8_t pin, uint8_t mode) {}
+inline void digitalWrite(uint8_t pin, uint8_t value) {}
+inline void analogWrite(uint8_t pin, int value) {}
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#endif // HOST_PORT_H
@@ -0,0 +1,170 @@
+/**
+ * Roxy RedLight v2.0 - Dirty Region Tracking Implementation
+ */
+
+#include "dirty.h"
+
+// =============================================================================
+// RECT HELPERS
+// =============================================================================
+
+static uint32_t rect_area(DirtyRect r) {
+    return (uint32_t)r.w * (uint32_t)r.h;
+}
+
+DirtyRect dirty_rect_union(DirtyRect a, DirtyRect b) {
+    int16_t x0 = (a.x < b.x) ? a.x : b.x;
+    int16_t y0 = (a.y < b.y) ? a.y : b.y;
+    int16_t x1 = (a.x + a.w > b.x + b.w) ? a.x + a.w : b.x + b.w;
+    int16_t y1 = (a.y + a.h > b.y + b.h) ? a.y + a.h : b.y + b.h;
+
+    DirtyRect r = {x0, y0, (int16_t)(x1 - x0), (int16_t)(y1 - y0)};
+    return r;
+}
+
+bool dirty_rect_intersects(DirtyRect a, DirtyRect b) {
+    return a.x < b.x + b.w && b.x < a.x + a.w &&
+           a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+bool dirty_rect_clip(DirtyRect r, DirtyRect clip, DirtyRect* out) {
+    if (!dirty_rect_intersects(r, clip)) {
+        return false;
+    }
+    int16_t x0 = (r.x > clip.x) ? r.x : clip.x;
+    int16_t y0 = (r.y > clip.y) ? r.y : clip.y;
+    int16_t x1 = (r.x + r.w < clip.x + clip.w) ? r.x + r.w : clip.x + clip.w;
+    int16_t y1 = (r.y + r.h < clip.y + clip.h) ? r.y + r.h : clip.y + clip.h;
+
+    DirtyRect c = {x0, y0, (int16_t)(x1 - x0), (int16_t)(y1 - y0)};
+    *out = c;
+    return true;
+}
+
+static bool should_merge(DirtyRect a, DirtyRect b) {
+    if (dirty_rect_intersects(a, b)) {
+        return true;  // Never push the same pixels twice
+    }
+    // Merge neighbours when the bounding box wastes only a few pixels
+    uint32_t merged = rect_area(dirty_rect_union(a, b));
+    return merged <= rect_area(a) + rect_area(b) + DIRTY_MERGE_SLACK;
+}
+
+// =============================================================================
+// REGION
+// =============================================================================
+
+void dirty_init(DirtyRegion* region, int16_t w, int16_t h) {
+    region->bound_w = w;
+    region->bound_h = h;
+    region->count = 0;
+}
+
+void dirty_clear(DirtyRegion* region) {
+    region->count = 0;
+}
+
+void dirty_add(DirtyRegion* region, int16_t x, int16_t y, int16_t w, int16_t h) {
+    if (w <= 0 || h <= 0) {
+        return;
+    }
+
+    // Clip to screen
+    int32_t x0 = (x < 0) ? 0 : x;
+    int32_t y0 = (y < 0) ? 0 : y;
+    int32_t x1 = (int32_t)x + w;
+    int32_t y1 = (int32_t)y + h;
+    if (x1 > region->bound_w) x1 = region->bound_w;
+    if (y1 > region->bound_h) y1 = region->bound_h;
+    if (x1 <= x0 || y1 <= y0) {
+        return;
+    }
+
+    DirtyRect r = {(int16_t)x0, (int16_t)y0, (int16_t)(x1 - x0), (int16_t)(y1 - y0)};
+
+    // Absorb existing rects; repeat because the grown rect may reach others
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (uint8_t i = 0; i < region->count; i++) {
+            if (should_merge(r, region->rects[i])) {
+                r = dirty_rect_union(r, region->rects[i]);
+                region->rects[i] = region->rects[--region->count];
+                merged = true;
+                break;
+            }
+        }
+    }
+
+    // Full: fold into the rect whose bounding box grows the least
+    if (region->count >= DIRTY_MAX_RECTS) {
+        uint8_t best = 0;
+        uint32_t bestGrowth = UINT32_MAX;
+        for (uint8_t i = 0; i < region->count; i++) {
+            uint32_t growth = rect_area(dirty_rect_union(r, region->rects[i])) -
+                              rect_area(region->rects[i]);
+            if (growth < bestGrowth) {
+                bestGrowth = growth;
+                best = i;
+            }
+        }
+        r = dirty_rect_union(r, region->rects[best]);
+        region->rects[best] = region->rects[--region->count];
+        dirty_add(region, r.x, r.y, r.w, r.h);
+        return;
+    }
+
+    region->rects[region->count++] = r;
+}
+
+void dirty_add_all(DirtyRegion* region) {
+    region->rects[0].x = 0;
+    region->rects[0].y = 0;
+    region->rects[0].w = region->bound_w;
+    region->rects[0].h = region->bound_h;
+    region->count = 1;
+}
+
+bool dirty_is_empty(const DirtyRegion* region) {
+    return region->count == 0;
+}
+
+uint32_t dirty_area(const DirtyRegion* region) {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < region->count; i++) {
+        total += rect_area(region->rects[i]);
+    }
+    return total;
+}
+
+uint8_t dirty_row_bands(const DirtyRegion* region, DirtyRect* bands) {
+    uint8_t count = 0;
+
+    for (uint8_t i = 0; i < region->count; i++) {
+        DirtyRect r = region->rects[i];
+        DirtyRect band = {0, r.y, region->bound_w, r.h};
+
+        // Insertion sort by top edge
+        uint8_t pos = count;
+        while (pos > 0 && bands[pos - 1].y > band.y) {
+            bands[pos] = bands[pos - 1];
+            pos--;
+        }
+        bands[pos] = band;
+        count++;
+    }
+
+    // Join bands that overlap or touch vertically
+    uint8_t out = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (out > 0 && bands[i].y <= bands[out - 1].y + bands[out - 1].h) {
+            int16_t bottom = bands[i].y + bands[i].h;
+            if (bottom > bands[out - 1].y + bands[out - 1].h) {
+                bands[out - 1].h = bottom - bands[out - 1].y;
+            }
+        } else {
+            bands[out++] = bands[i];
+        }
+    }
+    return out;
+}
@@ -0,0 +1,122 @@
+/**
+ * Roxy RedLight v2.0 - Dirty Region Tracking
+ *
+ * Testable rectangle bookkeeping for partial display updates
+ */
+
+#ifndef DIRTY_H
+#define DIRTY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// LIMITS
+// =============================================================================
+
+#define DIRTY_MAX_RECTS     8       // Rects kept before forced merging
+#define DIRTY_MERGE_SLACK   256     // Extra pixels accepted to merge two rects
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+typedef struct {
+    int16_t x;
+    int16_t y;
+    int16_t w;
+    int16_t h;
+} DirtyRect;
+
+typedef struct {
+    DirtyRect rects[DIRTY_MAX_RECTS];
+    uint8_t count;
+    int16_t bound_w;                // Clip area (screen size)
+    int16_t bound_h;
+} DirtyRegion;
+
+// =============================================================================
+// REGION FUNCTIONS
+// =============================================================================
+
+/**
+ * Initialize an empty region clipped to a w x h screen
+ * @param region Pointer to region
+ * @param w Screen width in pixels
+ * @param h Screen height in pixels
+ */
+void dirty_init(DirtyRegion* region, int16_t w, int16_t h);
+
+/**
+ * Remove all rects from the region
+ * @param region Pointer to region
+ */
+void dirty_clear(DirtyRegion* region);
+
+/**
+ * Add a rect, clipping it to the screen and merging it with
+ * overlapping or nearby rects. Never exceeds DIRTY_MAX_RECTS.
+ * @param region Pointer to region
+ * @param x Left edge
+ * @param y Top edge
+ * @param w Width (<= 0 is ignored)
+ * @param h Height (<= 0 is ignored)
+ */
+void dirty_add(DirtyRegion* region, int16_t x, int16_t y, int16_t w, int16_t h);
+
+/**
+ * Mark the whole screen dirty (single rect)
+ * @param region Pointer to region
+ */
+void dirty_add_all(DirtyRegion* region);
+
+/**
+ * Check whether anything needs pushing
+ * @param region Pointer to region
+ * @return true if the region holds no rects
+ */
+bool dirty_is_empty(const DirtyRegion* region);
+
+/**
+ * Total number of pixels covered by the region's rects
+ * @param region Pointer to region
+ * @return Pixel count
+ */
+uint32_t dirty_area(const DirtyRegion* region);
+
+/**
+ * Convert the region to full-width row bands, sorted top to bottom with
+ * overlapping or touching bands joined. Each band is one contiguous run
+ * of framebuffer memory, as needed for a single DMA transfer.
+ * @param region Pointer to region
+ * @param bands Output array with room for DIRTY_MAX_RECTS entries
+ * @return Number of bands written
+ */
+uint8_t dirty_row_bands(const DirtyRegion* region, DirtyRect* bands);
+
+/**
+ * Smallest rect containing both a and b
+ * @param a First rect
+ * @param b Second rect
+ * @return Bounding rect
+ */
+DirtyRect dirty_rect_union(DirtyRect a, DirtyRect b);
+
+/**
+ * Check if two rects overlap (touching edges do not count)
+ * @param a First rect
+ * @param b Second rect
+ * @return true if they share at least one pixel
+ */
+bool dirty_rect_intersects(DirtyRect a, DirtyRect b);
+
+/**
+ * Part of a rect inside a clip rect (used to split pushes into strips)
+ * @param r Rect to clip
+ * @param clip Clip rect
+ * @param out Receives the overlap (untouched if there is none)
+ * @return true if the rects overlap
+ */
+bool dirty_rect_clip(DirtyRect r, DirtyRect clip, DirtyRect* out);
+
+#endif // DIRTY_H
@@ -0,0 +1,82 @@
+/**
+ * Roxy RedLight v2.0 - Session History Implementation
+ */
+
+#include "history.h"
+#include <string.h>
+
+// =============================================================================
+// CACHE
+// =============================================================================
+
+void history_cache_init(HistoryCache* cache, HistoryReadFn read, void* ctx) {
+    memset(cache, 0, sizeof(HistoryCache));
+    cache->read = read;
+    cache->ctx = ctx;
+}
+
+const HistoryPage* history_cache_page(HistoryCache* cache, uint32_t page) {
+    cache->clock++;
+
+    HistoryPage* victim = &cache->pages[0];
+    for (uint8_t i = 0; i < HISTORY_CACHE_PAGES; i++) {
+        HistoryPage* slot = &cache->pages[i];
+        if (slot->lastUse != 0 && slot->page == page) {
+            slot->lastUse = cache->clock;
+            cache->hits++;
+            return slot;
+        }
+        if (slot->lastUse < victim->lastUse) {
+            victim = slot;      // Empty slots (0) go first
+        }
+    }
+
+    cache->misses++;
+    victim->page = page;
+    victim->lastUse = cache->clock;
+    victim->count = (uint8_t)cache->read(cache->ctx, page * HISTORY_PAGE_RECORDS,
+                                         victim->records, HISTORY_PAGE_RECORDS);
+    return victim;
+}
+
+void history_cache_invalidate(HistoryCache* cache, uint32_t page) {
+    for (uint8_t i = 0; i < HISTORY_CACHE_PAGES; i++) {
+        if (cache->pages[i].page == page) {
+            cache->pages[i].lastUse = 0;
+        }
+    }
+}
+
+// =============================================================================
+// PAGING
+// =============================================================================
+
+uint32_t history_screen_count(uint32_t records) {
+    return (records == 0) ? 1 : (records + HISTORY_PAGE_RECORDS - 1) / HISTORY_PAGE_RECORDS;
+}
+
+uint32_t history_screen_page(uint32_t records, uint32_t screen) {
+    uint32_t screens = history_screen_count(records);
+    if (screen >= screens) {
+        screen = screens - 1;
+    }
+    return screens - 1 - screen;
+}
+
+uint32_t history_page_of(uint32_t index) {
+    return index / HISTORY_PAGE_RECORDS;
+}
+
+// =============================================================================
+// STRING HELPERS
+// =============================================================================
+
+const char* history_end_name(uint8_t end) {
+    switch (end) {
+        case HISTORY_END_COMPLETE:   return "Done";
+        case HISTORY_END_STOPPED:    return "Stop";
+        case HISTORY_END_TIME_LIMIT: return "Limit";
+        case HISTORY_END_FAULT:      return "Fault";
+        default:                     return "?";
+    }
+}
@@ -0,0 +1,134 @@
+/**
+ * Roxy RedLight v2.0 - Session History
+ *
+ * Testable paging for the session history screen: fixed-size records
+ * appended to a store (a flash file on the device), read back a screenful
+ * page at a time through a small LRU cache so scrolling only touches
+ * flash for pages not seen recently
+ */
+
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// LIMITS
+// =============================================================================
+
+#define HISTORY_PAGE_RECORDS    6       // Records per page (one screenful)
+#define HISTORY_CACHE_PAGES     4       // Pages kept in RAM
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+typedef enum {
+    HISTORY_END_COMPLETE = 0,   // Ran the full session time
+    HISTORY_END_STOPPED,        // Stopped with the button
+    HISTORY_END_TIME_LIMIT,     // Cut off at the maximum session time
+    HISTORY_END_FAULT,          // Emergency shutdown (battery, thermal)
+    HISTORY_END_COUNT
+} HistoryEnd;
+
+#define HISTORY_WALL_CLOCK      0x1     // start is epoch seconds, not uptime
+
+// One session as stored (16 bytes, the store's unit of I/O)
+typedef struct {
+    uint32_t start;             // Epoch seconds, or seconds after boot
+    uint16_t boot;              // Boot count when the session ran
+    uint16_t durationSec;
+    uint16_t doseMilliJ;        // Delivered dose, mJ/cm2
+    uint8_t mode;               // TreatmentMode
+    uint8_t end;                // HistoryEnd
+    uint8_t flags;
+    uint8_t reserved[3];
+} HistoryRecord;
+
+// Reads up to count records starting at index first (0 = oldest) from the
+// store, returning how many were read
+typedef uint16_t (*HistoryReadFn)(void* ctx, uint32_t first, HistoryRecord* out, uint16_t count);
+
+typedef struct {
+    uint32_t page;              // Records page * HISTORY_PAGE_RECORDS onward
+    uint32_t lastUse;           // LRU stamp, 0 = slot empty
+    uint8_t count;              // Records loaded (the newest page may be short)
+    HistoryRecord records[HISTORY_PAGE_RECORDS];
+} HistoryPage;
+
+typedef struct {
+    HistoryPage pages[HISTORY_CACHE_PAGES];
+    uint32_t clock;             // Stamps uses for LRU
+    uint32_t hits;
+    uint32_t misses;
+    HistoryReadFn read;
+    void* ctx;
+} HistoryCache;
+
+// =============================================================================
+// CACHE FUNCTIONS
+// =============================================================================
+
+/**
+ * Start an empty cache over a store
+ * @param cache Pointer to cache
+ * @param read Store reader
+ * @param ctx Passed to read
+ */
+void history_cache_init(HistoryCache* cache, HistoryReadFn read, void* ctx);
+
+/**
+ * A page of records, read from the store on a miss into the least
+ * recently used slot
+ * @param cache Pointer to cache
+ * @param page Page number (0 = oldest records)
+ * @return Pointer to the cached page, valid until the next call
+ */
+const HistoryPage* history_cache_page(HistoryCache* cache, uint32_t page);
+
+/**
+ * Drop a page whose records changed (the newest, after an append)
+ * @param cache Pointer to cache
+ * @param page Page number
+ */
+void history_cache_invalidate(HistoryCache* cache, uint32_t page);
+
+// =============================================================================
+// PAGING FUNCTIONS
+// =============================================================================
+
+/**
+ * Screens needed for a record count (at least 1, for the empty screen)
+ * @param records Records in the store
+ * @return Screen count
+ */
+uint32_t history_screen_count(uint32_t records);
+
+/**
+ * Page shown on a screen; screen 0 holds the newest records
+ * @param records Records in the store
+ * @param screen Screen index, 0 .. history_screen_count() - 1
+ * @return Page number
+ */
+uint32_t history_screen_page(uint32_t records, uint32_t screen);
+
+/**
+ * Page a record lives in
+ * @param index Record index (0 = oldest)
+ * @return Page number
+ */
+uint32_t history_page_of(uint32_t index);
+
+// =============================================================================
+// STRING HELPERS
+// =============================================================================
+
+/**
+ * Short name of an end reason
+ * @param end HistoryEnd
+ * @return Name (max 5 characters)
+ */
+const char* history_end_name(uint8_t end);
+
+#endif // HISTORY_H
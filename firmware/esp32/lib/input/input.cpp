@@ -0,0 +1,226 @@
+/**
+ * Roxy RedLight v2.0 - Button Input Implementation
+ */
+
+#include "input.h"
+#include <string.h>
+
+typedef enum {
+    GESTURE_SHORT = 0,
+    GESTURE_LONG,
+    GESTURE_DOUBLE,
+    GESTURE_REPEAT,
+    GESTURE_COUNT
+} Gesture;
+
+static const ButtonEvent gestureEvents[INPUT_BUTTONS][GESTURE_COUNT] = {
+    {BUTTON_1_SHORT, BUTTON_1_LONG, BUTTON_1_DOUBLE, BUTTON_1_REPEAT},
+    {BUTTON_2_SHORT, BUTTON_2_LONG, BUTTON_2_DOUBLE, BUTTON_2_REPEAT}
+};
+
+// Which timer a button is waiting on
+typedef enum {
+    TIMER_NONE = 0,
+    TIMER_SETTLE,       // Raw level differs from the debounced one
+    TIMER_PHASE         // Long press, hold-repeat or double-click gap
+} TimerKind;
+
+// =============================================================================
+// EDGE RING
+// =============================================================================
+
+void input_ring_init(InputRing* ring) {
+    memset(ring, 0, sizeof(InputRing));
+}
+
+bool input_ring_pop(InputRing* ring, InputEdge* out) {
+    uint32_t tail = ring->tail;
+    if (tail == __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+    *out = ring->edges[tail & (INPUT_RING_SIZE - 1)];
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);    // Slot free again
+    return true;
+}
+
+// =============================================================================
+// RECOGNIZER
+// =============================================================================
+
+void input_init(InputRecognizer* rec, uint32_t now, uint16_t debounceMs, uint16_t longMs,
+                uint16_t doubleMs, uint16_t repeatMs) {
+    memset(rec, 0, sizeof(InputRecognizer));
+    rec->debounceUs = debounceMs * 1000UL;
+    rec->longUs = longMs * 1000UL;
+    rec->doubleUs = doubleMs * 1000UL;
+    rec->repeatUs = repeatMs * 1000UL;
+    for (uint8_t i = 0; i < INPUT_BUTTONS; i++) {
+        rec->buttons[i].changedUs = now - rec->debounceUs;  // First edge counts
+        rec->buttons[i].rawUs = now;
+    }
+}
+
+void input_double_click(InputRecognizer* rec, uint8_t button, bool enabled) {
+    if (button < INPUT_BUTTONS) {
+        rec->buttons[button].doubleClick = enabled;
+    }
+}
+
+static void emit(InputRecognizer* rec, uint8_t button, Gesture gesture, uint32_t us) {
+    if (rec->eventCount >= INPUT_EVENT_QUEUE) {
+        rec->dropped++;
+        return;
+    }
+    InputEvent* event = &rec->events[(rec->eventHead + rec->eventCount) % INPUT_EVENT_QUEUE];
+    event->event = gestureEvents[button][gesture];
+    event->us = us;
+    rec->eventCount++;
+}
+
+// A debounced press or release
+static void accept(InputRecognizer* rec, uint8_t i, bool down, uint32_t at) {
+    InputButton* b = &rec->buttons[i];
+    b->down = down;
+    b->changedUs = at;
+
+    if (down) {
+        b->phase = (b->phase == INPUT_RELEASED) ? INPUT_SECOND : INPUT_PRESSED;
+        b->pressUs = at;
+        return;
+    }
+
+    switch (b->phase) {
+        case INPUT_PRESSED:
+            if (b->doubleClick) {
+                b->phase = INPUT_RELEASED;
+                b->releaseUs = at;
+                return;
+            }
+            emit(rec, i, GESTURE_SHORT, at);
+            break;
+        case INPUT_SECOND:
+            emit(rec, i, GESTURE_DOUBLE, at);
+            break;
+        default:
+            break;      // Released after a long press: already reported
+    }
+    b->phase = INPUT_UP;
+}
+
+static TimerKind deadline(const InputRecognizer* rec, const InputButton* b, uint32_t now,
+                          uint32_t* at) {
+    TimerKind kind = TIMER_NONE;
+    if (b->raw != b->down) {
+        kind = TIMER_SETTLE;
+        *at = b->rawUs + rec->debounceUs;
+    }
+
+    uint32_t phaseAt;
+    switch (b->phase) {
+        case INPUT_PRESSED:
+        case INPUT_SECOND:  phaseAt = b->pressUs + rec->longUs;      break;
+        case INPUT_HELD:    phaseAt = b->repeatUs;                   break;
+        case INPUT_RELEASED: phaseAt = b->releaseUs + rec->doubleUs; break;
+        default:            return kind;
+    }
+    if (kind == TIMER_NONE || (int32_t)(phaseAt - now) < (int32_t)(*at - now)) {
+        kind = TIMER_PHASE;
+        *at = phaseAt;
+    }
+    return kind;
+}
+
+static void fire(InputRecognizer* rec, uint8_t i, TimerKind kind, uint32_t at, uint32_t now) {
+    InputButton* b = &rec->buttons[i];
+    if (kind == TIMER_SETTLE) {
+        accept(rec, i, b->raw, at);     // Level held steady past the bounce
+        return;
+    }
+
+    switch (b->phase) {
+        case INPUT_SECOND:
+        case INPUT_PRESSED:
+            if (b->phase == INPUT_SECOND) {
+                emit(rec, i, GESTURE_SHORT, at);    // The first click stands alone
+            }
+            emit(rec, i, GESTURE_LONG, at);
+            b->phase = INPUT_HELD;
+            b->repeatUs = at + rec->repeatUs;
+            break;
+        case INPUT_HELD:
+            emit(rec, i, GESTURE_REPEAT, at);
+            b->repeatUs += rec->repeatUs;
+            if ((int32_t)(b->repeatUs - now) <= 0) {
+                b->repeatUs = now + rec->repeatUs;  // Loop stalled: no burst
+            }
+            break;
+        case INPUT_RELEASED:
+            emit(rec, i, GESTURE_SHORT, at);    // No second click came
+            b->phase = INPUT_UP;
+            break;
+        default:
+            break;
+    }
+}
+
+void input_tick(InputRecognizer* rec, uint32_t now) {
+    // Fire due timers oldest first, so gestures queue in time order
+    for (;;) {
+        int8_t best = -1;
+        TimerKind bestKind = TIMER_NONE;
+        uint32_t bestAt = 0;
+        for (uint8_t i = 0; i < INPUT_BUTTONS; i++) {
+            uint32_t at;
+            TimerKind kind = deadline(rec, &rec->buttons[i], now, &at);
+            if (kind != TIMER_NONE && (int32_t)(at - now) <= 0 &&
+                (best < 0 || (int32_t)(at - bestAt) < 0)) {
+                best = i;
+                bestKind = kind;
+                bestAt = at;
+            }
+        }
+        if (best < 0) {
+            return;
+        }
+        fire(rec, best, bestKind, bestAt, now);
+    }
+}
+
+void input_feed(InputRecognizer* rec, const InputEdge* edge) {
+    if (edge->button >= INPUT_BUTTONS) {
+        return;
+    }
+    input_tick(rec, edge->us);
+
+    InputButton* b = &rec->buttons[edge->button];
+    b->raw = edge->down;
+    b->rawUs = edge->us;
+    if (edge->down != b->down && edge->us - b->changedUs >= rec->debounceUs) {
+        accept(rec, edge->button, edge->down, edge->us);
+    }
+}
+
+bool input_event(InputRecognizer* rec, InputEvent* out) {
+    if (rec->eventCount == 0) {
+        return false;
+    }
+    *out = rec->events[rec->eventHead];
+    rec->eventHead = (rec->eventHead + 1) % INPUT_EVENT_QUEUE;
+    rec->eventCount--;
+    return true;
+}
+
+uint32_t input_wait(const InputRecognizer* rec, uint32_t now) {
+    uint32_t best = INPUT_IDLE;
+    for (uint8_t i = 0; i < INPUT_BUTTONS; i++) {
+        uint32_t at;
+        if (deadline(rec, &rec->buttons[i], now, &at) != TIMER_NONE) {
+            int32_t ahead = (int32_t)(at - now);
+            uint32_t wait = (ahead < 0) ? 0 : (uint32_t)ahead;
+            if (wait < best) {
+                best = wait;
+            }
+        }
+    }
+    return best;
+}
@@ -0,0 +1,175 @@
+/**
+ * Roxy RedLight v2.0 - Button Input
+ *
+ * Testable input path: button ISRs push timestamped edges into a lock-free
+ * single-producer single-consumer ring, and loop() feeds them through a
+ * recognizer that debounces each button and turns presses into gestures
+ * (short, long, double-click, hold-repeat) reported as ButtonEvents.
+ * Times are microseconds (micros(), wrap-safe).
+ */
+
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ui.h"
+
+// =============================================================================
+// LIMITS
+// =============================================================================
+
+#define INPUT_BUTTONS       2
+#define INPUT_RING_SIZE     64          // Edges (power of two): bounces included
+#define INPUT_EVENT_QUEUE   16          // Recognized gestures waiting for loop()
+#define INPUT_IDLE          0xFFFFFFFF  // input_wait(): no timer running
+
+// =============================================================================
+// EDGE RING
+// =============================================================================
+
+typedef struct {
+    uint32_t us;                // When the ISR saw the edge
+    uint8_t button;             // 0 = button 1
+    bool down;                  // Pressed (pin low)
+} InputEdge;
+
+// The ISR only writes head, loop() only writes tail
+typedef struct {
+    InputEdge edges[INPUT_RING_SIZE];
+    uint32_t head;              // Free-running: next slot to fill
+    uint32_t tail;              // Free-running: next slot to read
+    uint32_t overruns;          // Edges lost to a full ring
+} InputRing;
+
+/**
+ * Empty the ring
+ * @param ring Pointer to ring
+ */
+void input_ring_init(InputRing* ring);
+
+/**
+ * Add an edge (producer side: call from the ISR only). Inline so an IRAM
+ * ISR never calls into flash.
+ * @param ring Pointer to ring
+ * @param us Edge time
+ * @param button Button index
+ * @param down true on press
+ * @return false if the ring was full
+ */
+static inline bool input_ring_push(InputRing* ring, uint32_t us, uint8_t button, bool down) {
+    uint32_t head = ring->head;
+    if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) >= INPUT_RING_SIZE) {
+        ring->overruns++;
+        return false;
+    }
+    InputEdge* edge = &ring->edges[head & (INPUT_RING_SIZE - 1)];
+    edge->us = us;
+    edge->button = button;
+    edge->down = down;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);   // Publish the edge
+    return true;
+}
+
+/**
+ * Take the oldest edge (consumer side: loop() only)
+ * @param ring Pointer to ring
+ * @param out Filled with the edge
+ * @return false if the ring is empty
+ */
+bool input_ring_pop(InputRing* ring, InputEdge* out);
+
+// =============================================================================
+// GESTURE RECOGNIZER
+// =============================================================================
+
+typedef enum {
+    INPUT_UP = 0,
+    INPUT_PRESSED,              // Down, not yet long
+    INPUT_HELD,                 // Long reported, repeating
+    INPUT_RELEASED,             // Short click waiting for a second one
+    INPUT_SECOND                // Second press of a possible double-click
+} InputPhase;
+
+typedef struct {
+    bool raw;                   // Level of the last edge
+    uint32_t rawUs;
+    bool down;                  // Debounced level
+    uint32_t changedUs;         // Last debounced change
+    uint8_t phase;              // InputPhase
+    uint32_t pressUs;
+    uint32_t releaseUs;
+    uint32_t repeatUs;          // Next hold-repeat
+    bool doubleClick;           // Wait for a second click before SHORT
+} InputButton;
+
+typedef struct {
+    ButtonEvent event;
+    uint32_t us;                // When the gesture was complete (edge or deadline)
+} InputEvent;
+
+typedef struct {
+    InputButton buttons[INPUT_BUTTONS];
+    uint32_t debounceUs;
+    uint32_t longUs;
+    uint32_t doubleUs;
+    uint32_t repeatUs;
+    InputEvent events[INPUT_EVENT_QUEUE];
+    uint8_t eventHead;
+    uint8_t eventCount;
+    uint32_t dropped;           // Gestures lost to a full event queue
+} InputRecognizer;
+
+/**
+ * Start a recognizer with both buttons up
+ * @param rec Pointer to recognizer
+ * @param now Current time (us)
+ * @param debounceMs Edges closer than this to the last change are bounce
+ * @param longMs Hold time for a long press
+ * @param doubleMs Gap allowed between the clicks of a double-click
+ * @param repeatMs Hold-repeat period after a long press
+ */
+void input_init(InputRecognizer* rec, uint32_t now, uint16_t debounceMs, uint16_t longMs,
+                uint16_t doubleMs, uint16_t repeatMs);
+
+/**
+ * Enable double-clicks on a button. While enabled, a short press is only
+ * reported once the double-click gap has passed.
+ * @param rec Pointer to recognizer
+ * @param button Button index
+ * @param enabled Whether to wait for a second click
+ */
+void input_double_click(InputRecognizer* rec, uint8_t button, bool enabled);
+
+/**
+ * Feed an edge from the ring (timers due before it fire first)
+ * @param rec Pointer to recognizer
+ * @param edge Edge, in ring order
+ */
+void input_feed(InputRecognizer* rec, const InputEdge* edge);
+
+/**
+ * Fire the timers due by now: debounce settling, long press, hold-repeat
+ * and the end of a double-click gap
+ * @param rec Pointer to recognizer
+ * @param now Current time (us)
+ */
+void input_tick(InputRecognizer* rec, uint32_t now);
+
+/**
+ * Take the oldest recognized gesture
+ * @param rec Pointer to recognizer
+ * @param out Filled with the gesture
+ * @return false if none is waiting
+ */
+bool input_event(InputRecognizer* rec, InputEvent* out);
+
+/**
+ * Time until the next timer
+ * @param rec Pointer to recognizer
+ * @param now Current time (us)
+ * @return us (0 if due), INPUT_IDLE if no timer is running
+ */
+uint32_t input_wait(const InputRecognizer* rec, uint32_t now);
+
+#endif // INPUT_H
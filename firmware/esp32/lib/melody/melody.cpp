@@ -0,0 +1,94 @@
+/**
+ * Roxy RedLight v2.0 - Melody Sequencer Implementation
+ */
+
+#include "melody.h"
+#include <string.h>
+
+#define QUEUE_MASK      (MELODY_QUEUE_NOTES - 1)
+
+// =============================================================================
+// QUEUE
+// =============================================================================
+
+void melody_init(MelodySeq* seq) {
+    memset(seq, 0, sizeof(MelodySeq));
+}
+
+void melody_stop(MelodySeq* seq) {
+    seq->count = 0;
+    seq->started = false;
+    seq->priority = MELODY_PRIORITY_CLICK;
+    seq->freq = MELODY_REST;
+}
+
+bool melody_play(MelodySeq* seq, const ToneNote* notes, uint8_t count, uint8_t priority, uint32_t now) {
+    if (seq->count > 0) {
+        if (priority < seq->priority) {
+            seq->dropped++;
+            return false;
+        }
+        if (priority > seq->priority) {
+            seq->count = 0;             // Preempt, sounding note included
+        }
+    }
+    if (count > MELODY_QUEUE_NOTES - seq->count) {
+        seq->dropped++;
+        return false;
+    }
+
+    if (seq->count == 0) {
+        seq->started = false;
+        seq->noteEnd = now;             // First note starts now
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        seq->notes[(seq->head + seq->count) & QUEUE_MASK] = notes[i];
+        seq->count++;
+    }
+    seq->priority = priority;
+    return true;
+}
+
+// =============================================================================
+// PLAYBACK
+// =============================================================================
+
+bool melody_update(MelodySeq* seq, uint32_t now) {
+    uint16_t before = seq->freq;
+
+    while (seq->count > 0) {
+        if (!seq->started) {
+            // Starts where the last note ended, keeping the rhythm
+            seq->noteEnd += seq->notes[seq->head].ms;
+            seq->started = true;
+        }
+        if ((int32_t)(now - seq->noteEnd) < 0) {
+            break;                      // Still sounding
+        }
+        seq->head = (seq->head + 1) & QUEUE_MASK;
+        seq->count--;
+        seq->started = false;
+    }
+
+    if (seq->count > 0) {
+        seq->freq = seq->notes[seq->head].freq;
+    } else {
+        melody_stop(seq);
+    }
+    return seq->freq != before;
+}
+
+uint32_t melody_next(const MelodySeq* seq, uint32_t now) {
+    if (seq->count == 0) {
+        return MELODY_IDLE;
+    }
+    if (!seq->started) {
+        return 0;                       // Head note not started yet
+    }
+    int32_t ahead = (int32_t)(seq->noteEnd - now);
+    return (ahead < 0) ? 0 : (uint32_t)ahead;
+}
+
+bool melody_busy(const MelodySeq* seq) {
+    return seq->count > 0;
+}
@@ -0,0 +1,102 @@
+/**
+ * Roxy RedLight v2.0 - Melody Sequencer
+ *
+ * Testable note queue for the buzzer: melodies are tables of {Hz, ms}
+ * notes, queued without blocking and stepped by the caller at each note
+ * boundary. Louder news preempts quieter: an alarm flushes queued clicks.
+ */
+
+#ifndef MELODY_H
+#define MELODY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// LIMITS
+// =============================================================================
+
+#define MELODY_QUEUE_NOTES  32          // Power of two
+#define MELODY_REST         0           // Note frequency for silence
+#define MELODY_IDLE         0xFFFFFFFF  // melody_next(): nothing queued
+
+// Who wins when melodies overlap
+typedef enum {
+    MELODY_PRIORITY_CLICK = 0,  // Button feedback
+    MELODY_PRIORITY_EVENT,      // Session start/stop/complete, warnings
+    MELODY_PRIORITY_ALARM       // Emergency shutdown
+} MelodyPriority;
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+typedef struct {
+    uint16_t freq;              // Hz, MELODY_REST for a pause
+    uint16_t ms;
+} ToneNote;
+
+typedef struct {
+    ToneNote notes[MELODY_QUEUE_NOTES];
+    uint8_t head;               // Note sounding (or next to sound)
+    uint8_t count;              // Notes queued, including the one sounding
+    bool started;               // Head note's end time is set
+    uint32_t noteEnd;           // When the head note ends (or the next starts)
+    uint8_t priority;           // Of what is queued
+    uint16_t freq;              // Output now, MELODY_REST when silent
+    uint32_t dropped;           // Melodies refused (lower priority or full)
+} MelodySeq;
+
+// =============================================================================
+// SEQUENCER FUNCTIONS
+// =============================================================================
+
+/**
+ * Start a silent sequencer
+ * @param seq Pointer to sequencer
+ */
+void melody_init(MelodySeq* seq);
+
+/**
+ * Queue a melody (notes are copied). A higher priority than what is queued
+ * replaces it; a lower one is dropped.
+ * @param seq Pointer to sequencer
+ * @param notes Note table
+ * @param count Notes in the table
+ * @param priority MelodyPriority
+ * @param now Current time (ms)
+ * @return true if queued
+ */
+bool melody_play(MelodySeq* seq, const ToneNote* notes, uint8_t count, uint8_t priority, uint32_t now);
+
+/**
+ * Silence and empty the queue
+ * @param seq Pointer to sequencer
+ */
+void melody_stop(MelodySeq* seq);
+
+/**
+ * Step past finished notes. Notes follow each other on time even when
+ * called late.
+ * @param seq Pointer to sequencer
+ * @param now Current time (ms)
+ * @return true if seq->freq changed (the buzzer needs retuning)
+ */
+bool melody_update(MelodySeq* seq, uint32_t now);
+
+/**
+ * Time until the next note boundary
+ * @param seq Pointer to sequencer
+ * @param now Current time (ms)
+ * @return ms (0 if due), MELODY_IDLE if nothing queued
+ */
+uint32_t melody_next(const MelodySeq* seq, uint32_t now);
+
+/**
+ * Whether anything is queued
+ * @param seq Pointer to sequencer
+ * @return true while a melody plays
+ */
+bool melody_busy(const MelodySeq* seq);
+
+#endif // MELODY_H
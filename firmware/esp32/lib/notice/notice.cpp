@@ -0,0 +1,116 @@
+/**
+ * Roxy RedLight v2.0 - Notifications Implementation
+ */
+
+#include "notice.h"
+#include <string.h>
+
+// =============================================================================
+// QUEUE
+// =============================================================================
+
+void notice_init(NoticeQueue* queue) {
+    memset(queue, 0, sizeof(NoticeQueue));
+    queue->nextId = 1;
+}
+
+// Whether a is shown before b
+static bool outranks(const Notice* a, const Notice* b) {
+    return (a->level != b->level) ? a->level > b->level : a->id < b->id;
+}
+
+// Slot of the notice that is (or will be) showing, -1 if the queue is empty
+static int top(const NoticeQueue* queue) {
+    int best = -1;
+    for (uint8_t i = 0; i < NOTICE_SLOTS; i++) {
+        const Notice* n = &queue->slots[i];
+        if (n->id != 0 && (best < 0 || outranks(n, &queue->slots[best]))) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+bool notice_post(NoticeQueue* queue, uint8_t level, const char* title, const char* text,
+                 uint16_t color, uint32_t duration) {
+    Notice* slot = NULL;
+    for (uint8_t i = 0; i < NOTICE_SLOTS; i++) {
+        Notice* n = &queue->slots[i];
+        if (n->id == 0) {
+            slot = n;
+            break;
+        }
+        // Full: the least urgent, oldest first
+        if (n->duration == NOTICE_STICKY) {
+            continue;
+        }
+        if (!slot || n->level < slot->level || (n->level == slot->level && n->id < slot->id)) {
+            slot = n;
+        }
+    }
+    if (!slot || slot->id != 0) {
+        queue->dropped++;
+        if (!slot || slot->level > level) {
+            return false;
+        }
+    }
+
+    memset(slot, 0, sizeof(Notice));
+    slot->id = queue->nextId++;
+    if (queue->nextId == 0) {
+        queue->nextId = 1;
+    }
+    slot->level = level;
+    slot->color = color;
+    slot->duration = duration;
+    strncpy(slot->title, title, NOTICE_TITLE_LEN - 1);
+    strncpy(slot->text, text, NOTICE_TEXT_LEN - 1);
+    return true;
+}
+
+const Notice* notice_current(NoticeQueue* queue, uint32_t now) {
+    Notice* best = NULL;
+    for (uint8_t i = 0; i < NOTICE_SLOTS; i++) {
+        Notice* n = &queue->slots[i];
+        if (n->id == 0) {
+            continue;
+        }
+        // Time shown counts even while a more urgent notice covers it
+        if (n->shown && n->duration != NOTICE_STICKY && now - n->shownAt >= n->duration) {
+            n->id = 0;
+            continue;
+        }
+        if (!best || outranks(n, best)) {
+            best = n;
+        }
+    }
+
+    if (best && !best->shown) {
+        best->shown = true;
+        best->shownAt = now;
+    }
+    return best;
+}
+
+uint32_t notice_next(const NoticeQueue* queue, uint32_t now) {
+    int slot = top(queue);
+    if (slot < 0) {
+        return NOTICE_IDLE;
+    }
+    const Notice* best = &queue->slots[slot];
+    if (!best->shown || best->duration == NOTICE_STICKY) {
+        return NOTICE_IDLE;
+    }
+
+    uint32_t elapsed = now - best->shownAt;
+    return (elapsed >= best->duration) ? 0 : best->duration - elapsed;
+}
+
+bool notice_acknowledge(NoticeQueue* queue) {
+    int slot = top(queue);
+    if (slot < 0 || queue->slots[slot].duration != NOTICE_STICKY) {
+        return false;
+    }
+    queue->slots[slot].id = 0;
+    return true;
+}
@@ -0,0 +1,102 @@
+/**
+ * Roxy RedLight v2.0 - Notifications
+ *
+ * Testable queue of timed on-screen notices. The display overlays the
+ * current one on whatever screen is showing; the most urgent goes first,
+ * and each expires on its own after being shown for its duration. Sticky
+ * notices stay until acknowledged.
+ */
+
+#ifndef NOTICE_H
+#define NOTICE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// LIMITS
+// =============================================================================
+
+#define NOTICE_SLOTS        4
+#define NOTICE_TITLE_LEN    16      // Including the terminator
+#define NOTICE_TEXT_LEN     28
+#define NOTICE_IDLE         0xFFFFFFFF  // notice_next(): nothing to time
+#define NOTICE_STICKY       0       // Duration: until notice_acknowledge()
+
+typedef enum {
+    NOTICE_INFO = 0,    // Toast: status news
+    NOTICE_WARNING,     // Toast: something needs attention
+    NOTICE_CRITICAL     // Alert box: an action was refused or cut short
+} NoticeLevel;
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+typedef struct {
+    uint32_t id;                    // Unique per post, 0 = free slot
+    uint8_t level;                  // NoticeLevel
+    uint16_t color;                 // Title and border
+    uint32_t duration;              // ms on screen, NOTICE_STICKY = until acknowledged
+    uint32_t shownAt;               // When first shown
+    bool shown;
+    char title[NOTICE_TITLE_LEN];
+    char text[NOTICE_TEXT_LEN];
+} Notice;
+
+typedef struct {
+    Notice slots[NOTICE_SLOTS];
+    uint32_t nextId;
+    uint32_t dropped;               // Posts refused or evicted
+} NoticeQueue;
+
+// =============================================================================
+// QUEUE FUNCTIONS
+// =============================================================================
+
+/**
+ * Start an empty queue
+ * @param queue Pointer to queue
+ */
+void notice_init(NoticeQueue* queue);
+
+/**
+ * Queue a notice (strings are copied, truncated to fit). When full, the
+ * oldest notice of the lowest level makes room if it is no more urgent;
+ * sticky notices are never evicted.
+ * @param queue Pointer to queue
+ * @param level NoticeLevel
+ * @param title Short heading
+ * @param text One line of detail
+ * @param color Accent color (RGB565)
+ * @param duration ms to stay on screen once shown, or NOTICE_STICKY
+ * @return true if queued
+ */
+bool notice_post(NoticeQueue* queue, uint8_t level, const char* title, const char* text,
+                 uint16_t color, uint32_t duration);
+
+/**
+ * Drop expired notices and pick the one to show: highest level first,
+ * then in posting order. Starts its timer if new.
+ * @param queue Pointer to queue
+ * @param now Current time (ms)
+ * @return Notice to overlay, NULL if none
+ */
+const Notice* notice_current(NoticeQueue* queue, uint32_t now);
+
+/**
+ * Time until the notice showing expires
+ * @param queue Pointer to queue
+ * @param now Current time (ms)
+ * @return ms, NOTICE_IDLE if none is showing or it is sticky
+ */
+uint32_t notice_next(const NoticeQueue* queue, uint32_t now);
+
+/**
+ * Take down the most urgent notice if it is sticky (timed ones run out alone)
+ * @param queue Pointer to queue
+ * @return true if one was taken down
+ */
+bool notice_acknowledge(NoticeQueue* queue);
+
+#endif // NOTICE_H
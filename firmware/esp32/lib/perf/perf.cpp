@@ -0,0 +1,99 @@
+/**
+ * Roxy RedLight v2.0 - Timing Histogram Implementation
+ */
+
+#include "perf.h"
+#include <string.h>
+
+#define PERF_SUB_COUNT  (1 << PERF_SUB_BITS)
+
+// =============================================================================
+// BUCKETS
+// =============================================================================
+
+uint16_t perf_bucket(uint32_t value) {
+    if (value < PERF_SUB_COUNT) {
+        return value;   // Small values are exact
+    }
+    // Octave from the top bit, then the next PERF_SUB_BITS bits
+    uint8_t msb = 31 - __builtin_clz(value);
+    uint8_t sub = (value >> (msb - PERF_SUB_BITS)) & (PERF_SUB_COUNT - 1);
+    return ((msb - PERF_SUB_BITS + 1) << PERF_SUB_BITS) + sub;
+}
+
+static uint32_t bucket_top(uint16_t bucket) {
+    if (bucket < PERF_SUB_COUNT) {
+        return bucket;
+    }
+    uint8_t msb = (bucket >> PERF_SUB_BITS) + PERF_SUB_BITS - 1;
+    uint8_t sub = bucket & (PERF_SUB_COUNT - 1);
+    uint64_t low = (uint64_t)(PERF_SUB_COUNT + sub) << (msb - PERF_SUB_BITS);
+    return (uint32_t)(low + ((uint64_t)1 << (msb - PERF_SUB_BITS)) - 1);
+}
+
+// =============================================================================
+// HISTOGRAM
+// =============================================================================
+
+void perf_init(PerfHist* hist) {
+    memset(hist, 0, sizeof(*hist));
+}
+
+void perf_record(PerfHist* hist, uint32_t value) {
+    if (hist->count == 0 || value < hist->min) hist->min = value;
+    if (value > hist->max) hist->max = value;
+    hist->count++;
+    hist->sum += value;
+
+    // Keep the shape rather than saturating one bucket
+    uint16_t b = perf_bucket(value);
+    if (hist->buckets[b] == UINT16_MAX) {
+        for (uint16_t i = 0; i < PERF_BUCKETS; i++) {
+            hist->buckets[i] >>= 1;
+        }
+    }
+    hist->buckets[b]++;
+}
+
+uint32_t perf_min(const PerfHist* hist) {
+    return hist->min;
+}
+
+uint32_t perf_max(const PerfHist* hist) {
+    return hist->max;
+}
+
+uint32_t perf_avg(const PerfHist* hist) {
+    if (hist->count == 0) {
+        return 0;
+    }
+    return (uint32_t)(hist->sum / hist->count);
+}
+
+uint32_t perf_percentile(const PerfHist* hist, uint8_t pct) {
+    uint32_t total = 0;
+    for (uint16_t i = 0; i < PERF_BUCKETS; i++) {
+        total += hist->buckets[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    // Rank of the sample, rounded up
+    uint32_t rank = (uint32_t)(((uint64_t)total * pct + 99) / 100);
+    if (rank == 0) {
+        rank = 1;
+    }
+
+    uint32_t seen = 0;
+    for (uint16_t i = 0; i < PERF_BUCKETS; i++) {
+        seen += hist->buckets[i];
+        if (seen >= rank) {
+            uint32_t top = bucket_top(i);
+            if (top > hist->max) top = hist->max;
+            if (top < hist->min) top = hist->min;
+            return top;
+        }
+    }
+    return hist->max;
+}
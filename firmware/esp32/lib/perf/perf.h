@@ -0,0 +1,88 @@
+/**
+ * Roxy RedLight v2.0 - Timing Histograms
+ *
+ * Testable log-bucketed histograms for profiling (min/avg/max/percentile)
+ */
+
+#ifndef PERF_H
+#define PERF_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// LIMITS
+// =============================================================================
+
+// Each power of two is split into 2^PERF_SUB_BITS buckets, so a percentile
+// is reported within 1/2^PERF_SUB_BITS (25%) of the true value
+#define PERF_SUB_BITS   2
+#define PERF_BUCKETS    ((32 - PERF_SUB_BITS + 1) << PERF_SUB_BITS)
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint16_t buckets[PERF_BUCKETS];  // Halved together when one would overflow
+} PerfHist;
+
+// =============================================================================
+// HISTOGRAM FUNCTIONS
+// =============================================================================
+
+/**
+ * Empty the histogram
+ * @param hist Pointer to histogram
+ */
+void perf_init(PerfHist* hist);
+
+/**
+ * Add one sample
+ * @param hist Pointer to histogram
+ * @param value Sample (e.g. CPU cycles)
+ */
+void perf_record(PerfHist* hist, uint32_t value);
+
+/**
+ * Smallest sample
+ * @param hist Pointer to histogram
+ * @return Minimum, 0 if empty
+ */
+uint32_t perf_min(const PerfHist* hist);
+
+/**
+ * Largest sample
+ * @param hist Pointer to histogram
+ * @return Maximum, 0 if empty
+ */
+uint32_t perf_max(const PerfHist* hist);
+
+/**
+ * Mean of all samples
+ * @param hist Pointer to histogram
+ * @return Average, 0 if empty
+ */
+uint32_t perf_avg(const PerfHist* hist);
+
+/**
+ * Value below which pct percent of the samples fall, rounded up to the
+ * top of its bucket and clamped to [min, max]
+ * @param hist Pointer to histogram
+ * @param pct Percentile (1-100)
+ * @return Percentile estimate, 0 if empty
+ */
+uint32_t perf_percentile(const PerfHist* hist, uint8_t pct);
+
+/**
+ * Bucket a value falls into (exposed for testing)
+ * @param value Sample
+ * @return Bucket index below PERF_BUCKETS
+ */
+uint16_t perf_bucket(uint32_t value);
+
+#endif // PERF_H
@@ -0,0 +1,178 @@
+/**
+ * Roxy RedLight v2.0 - Job Scheduler Implementation
+ */
+
+#include "sched.h"
+#include <string.h>
+
+#define SLOT_MASK       (SCHED_SLOTS - 1)
+#define SPAN(level)     (1UL << (SCHED_SLOT_BITS * (level)))   // ms per slot
+#define WHEEL_SPAN      (1ULL << (SCHED_SLOT_BITS * SCHED_LEVELS))
+
+// =============================================================================
+// WHEEL
+// =============================================================================
+
+// Link a job into the slot for its deadline, relative to the wheel's time:
+// the lowest level whose range reaches it
+static void link(Scheduler* sched, SchedJob* job) {
+    uint32_t when = job->deadline;
+    int32_t ahead = (int32_t)(when - sched->now);
+
+    uint8_t level = 0;
+    if (ahead <= 0) {
+        when = sched->now;              // Overdue: the next tick processed
+    } else if ((uint64_t)ahead >= WHEEL_SPAN) {
+        level = SCHED_LEVELS - 1;       // Beyond the wheel: park, cascade again
+        when = sched->now + (uint32_t)(WHEEL_SPAN - SPAN(level));
+    } else {
+        while (level < SCHED_LEVELS - 1 && (uint32_t)ahead >= SPAN(level + 1)) {
+            level++;
+        }
+    }
+
+    SchedJob** head = &sched->slots[level][(when >> (SCHED_SLOT_BITS * level)) & SLOT_MASK];
+    job->prev = NULL;
+    job->next = *head;
+    if (*head) {
+        (*head)->prev = job;
+    }
+    *head = job;
+    job->head = head;
+}
+
+static void unlink(SchedJob* job) {
+    if (job->prev) {
+        job->prev->next = job->next;
+    } else {
+        *job->head = job->next;
+    }
+    if (job->next) {
+        job->next->prev = job->prev;
+    }
+    job->next = NULL;
+    job->prev = NULL;
+    job->head = NULL;
+}
+
+// Re-file a higher-level slot's jobs now that its span has started
+static void cascade(Scheduler* sched, uint8_t level) {
+    uint32_t index = (sched->now >> (SCHED_SLOT_BITS * level)) & SLOT_MASK;
+    SchedJob* job = sched->slots[level][index];
+    sched->slots[level][index] = NULL;
+
+    while (job) {
+        SchedJob* next = job->next;
+        link(sched, job);
+        job = next;
+    }
+}
+
+// =============================================================================
+// JOBS
+// =============================================================================
+
+void sched_init(Scheduler* sched, uint32_t now) {
+    memset(sched, 0, sizeof(Scheduler));
+    sched->now = now;
+}
+
+void sched_job_init(SchedJob* job, const char* name, SchedFn fn, void* arg) {
+    memset(job, 0, sizeof(SchedJob));
+    job->name = name;
+    job->fn = fn;
+    job->arg = arg;
+}
+
+void sched_start(Scheduler* sched, SchedJob* job, uint32_t now, uint32_t delay, uint32_t period) {
+    sched_stop(sched, job);
+    job->deadline = now + delay;
+    job->period = period;
+    link(sched, job);
+}
+
+void sched_stop(Scheduler* sched, SchedJob* job) {
+    if (job->head) {
+        unlink(job);
+    }
+}
+
+bool sched_active(const SchedJob* job) {
+    return job->head != NULL;
+}
+
+// Account for and re-arm a due job, then call it (so it may stop or
+// re-arm itself)
+static void runJob(Scheduler* sched, SchedJob* job, uint32_t now) {
+    uint32_t late = now - job->deadline;
+    job->runs++;
+    job->lateTotal += late;
+    if (late > job->lateMax) {
+        job->lateMax = late;
+    }
+
+    if (job->period) {
+        // Next deadline on the original phase, skipping any already past
+        uint32_t skipped = late / job->period;
+        job->missed += skipped;
+        job->deadline += (skipped + 1) * job->period;
+        link(sched, job);
+    }
+    job->fn(job->arg);
+}
+
+uint16_t sched_run(Scheduler* sched, uint32_t now) {
+    uint16_t ran = 0;
+
+    while ((int32_t)(now - sched->now) >= 0) {
+        // Higher levels first, so their jobs can land in this very slot
+        for (uint8_t level = SCHED_LEVELS - 1; level > 0; level--) {
+            if ((sched->now & (SPAN(level) - 1)) == 0) {
+                cascade(sched, level);
+            }
+        }
+
+        SchedJob** head = &sched->slots[0][sched->now & SLOT_MASK];
+        while (*head) {
+            SchedJob* job = *head;
+            unlink(job);
+            runJob(sched, job, now);
+            ran++;
+        }
+        sched->now++;
+    }
+    return ran;
+}
+
+uint32_t sched_next(const Scheduler* sched, uint32_t now) {
+    // Few jobs and 256 slot heads: a full scan is cheaper than keeping the
+    // wheel sorted, and called once per loop pass
+    uint32_t best = SCHED_IDLE;
+    for (uint8_t level = 0; level < SCHED_LEVELS; level++) {
+        for (uint8_t i = 0; i < SCHED_SLOTS; i++) {
+            for (const SchedJob* job = sched->slots[level][i]; job; job = job->next) {
+                int32_t ahead = (int32_t)(job->deadline - now);
+                uint32_t wait = (ahead < 0) ? 0 : (uint32_t)ahead;
+                if (wait < best) {
+                    best = wait;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+// =============================================================================
+// ACCOUNTING
+// =============================================================================
+
+void sched_reset_stats(SchedJob* job) {
+    job->runs = 0;
+    job->lateTotal = 0;
+    job->lateMax = 0;
+    job->missed = 0;
+}
+
+uint32_t sched_late_avg(const SchedJob* job) {
+    return job->runs ? job->lateTotal / job->runs : 0;
+}
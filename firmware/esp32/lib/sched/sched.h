@@ -0,0 +1,133 @@
+/**
+ * Roxy RedLight v2.0 - Job Scheduler
+ *
+ * Testable cooperative scheduler for loop(): periodic and one-shot jobs on
+ * a hierarchical timer wheel keyed by millisecond deadlines. Arming and
+ * stopping a job is O(1); the loop asks for the time to the next deadline
+ * and sleeps until then. Each job keeps its own lateness and missed-period
+ * counts.
+ */
+
+#ifndef SCHED_H
+#define SCHED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// LIMITS
+// =============================================================================
+
+// Four levels of 64 slots: 1 ms, 64 ms, 4.1 s and 262 s per slot, covering
+// 4.6 hours. Longer delays park in the last level and cascade again.
+#define SCHED_LEVELS        4
+#define SCHED_SLOT_BITS     6
+#define SCHED_SLOTS         (1 << SCHED_SLOT_BITS)
+
+#define SCHED_IDLE          0xFFFFFFFF  // sched_next(): no job armed
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+typedef void (*SchedFn)(void* arg);
+
+// A job, owned by the caller (usually static) and linked into the wheel
+// while armed
+typedef struct SchedJob {
+    struct SchedJob* next;
+    struct SchedJob* prev;
+    struct SchedJob** head;     // Slot the job is linked in, NULL if idle
+    uint32_t deadline;          // Due time (ms, wraps)
+    uint32_t period;            // 0 = one-shot
+    SchedFn fn;
+    void* arg;
+    const char* name;
+
+    // Accounting, since sched_job_init() or sched_reset_stats()
+    uint32_t runs;
+    uint32_t lateTotal;         // Sum of ms run after the deadline
+    uint32_t lateMax;
+    uint32_t missed;            // Periods skipped after running too late
+} SchedJob;
+
+typedef struct {
+    SchedJob* slots[SCHED_LEVELS][SCHED_SLOTS];
+    uint32_t now;               // Next millisecond the wheel will process
+} Scheduler;
+
+// =============================================================================
+// SCHEDULER FUNCTIONS
+// =============================================================================
+
+/**
+ * Start an empty scheduler
+ * @param sched Pointer to scheduler
+ * @param now Current time (ms)
+ */
+void sched_init(Scheduler* sched, uint32_t now);
+
+/**
+ * Set up an idle job
+ * @param job Pointer to job
+ * @param name Label for logs
+ * @param fn Called when the job runs
+ * @param arg Passed to fn
+ */
+void sched_job_init(SchedJob* job, const char* name, SchedFn fn, void* arg);
+
+/**
+ * Arm (or re-arm) a job. Periodic jobs keep their phase: a late run does
+ * not push later ones back.
+ * @param sched Pointer to scheduler
+ * @param job Pointer to job
+ * @param now Current time (ms)
+ * @param delay First run this many ms from now
+ * @param period Then every period ms, 0 for once
+ */
+void sched_start(Scheduler* sched, SchedJob* job, uint32_t now, uint32_t delay, uint32_t period);
+
+/**
+ * Disarm a job (no effect if idle). Safe from inside any job.
+ * @param sched Pointer to scheduler
+ * @param job Pointer to job
+ */
+void sched_stop(Scheduler* sched, SchedJob* job);
+
+/**
+ * Whether a job is armed
+ * @param job Pointer to job
+ * @return true if it will run
+ */
+bool sched_active(const SchedJob* job);
+
+/**
+ * Run every job due up to now, advancing the wheel
+ * @param sched Pointer to scheduler
+ * @param now Current time (ms)
+ * @return Jobs run
+ */
+uint16_t sched_run(Scheduler* sched, uint32_t now);
+
+/**
+ * Time until the earliest armed deadline
+ * @param sched Pointer to scheduler
+ * @param now Current time (ms)
+ * @return ms to wait (0 if a job is due), SCHED_IDLE if none armed
+ */
+uint32_t sched_next(const Scheduler* sched, uint32_t now);
+
+/**
+ * Clear a job's run and lateness counts
+ * @param job Pointer to job
+ */
+void sched_reset_stats(SchedJob* job);
+
+/**
+ * Mean lateness of a job's runs
+ * @param job Pointer to job
+ * @return ms, 0 if it has not run
+ */
+uint32_t sched_late_avg(const SchedJob* job);
+
+#endif // SCHED_H
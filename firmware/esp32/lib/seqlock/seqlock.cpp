@@ -0,0 +1,48 @@
+/**
+ * Roxy RedLight v2.0 - Sequence Lock Implementation
+ */
+
+#include "seqlock.h"
+#include <string.h>
+
+void seqlock_init(Seqlock* lock) {
+    lock->seq = 0;
+}
+
+void seqlock_publish(Seqlock* lock, void* slots, size_t size, const void* value) {
+    uint32_t seq = lock->seq;   // Only the writer changes it
+
+    // The previous switch must be seen before this slot changes: a reader
+    // that still sees the old sequence is reading the other slot
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy((uint8_t*)slots + ((seq + 1) & 1) * size, value, size);
+    __atomic_store_n(&lock->seq, seq + 1, __ATOMIC_RELEASE);     // Switch readers over
+}
+
+uint32_t seqlock_read_begin(const Seqlock* lock) {
+    return __atomic_load_n(&lock->seq, __ATOMIC_ACQUIRE);
+}
+
+const void* seqlock_slot(const void* slots, size_t size, uint32_t seq) {
+    return (const uint8_t*)slots + (seq & 1) * size;
+}
+
+bool seqlock_read_valid(const Seqlock* lock, uint32_t seq) {
+    // The copy completes before the sequence is checked again. Unchanged:
+    // the writer can only have touched the other slot. One publish on: it
+    // may be filling this slot for the next.
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&lock->seq, __ATOMIC_RELAXED) == seq;
+}
+
+uint32_t seqlock_read(const Seqlock* lock, const void* slots, size_t size, void* out) {
+    uint32_t retries = 0;
+    for (;;) {
+        uint32_t seq = seqlock_read_begin(lock);
+        memcpy(out, seqlock_slot(slots, size, seq), size);
+        if (seqlock_read_valid(lock, seq)) {
+            return retries;
+        }
+        retries++;
+    }
+}
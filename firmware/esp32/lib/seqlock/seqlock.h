@@ -0,0 +1,74 @@
+/**
+ * Roxy RedLight v2.0 - Sequence Lock
+ *
+ * Lock-free publishing of a struct from one writer to any number of
+ * readers, on either core. The value lives in two slots: the writer fills
+ * the one readers are not using, then bumps the sequence to switch them
+ * over. A reader copies the current slot and retries only if a publish
+ * completed meanwhile, so a reader that preempts the writer (the safety
+ * task on loop()'s core) never waits on it, and the writer never waits at
+ * all.
+ */
+
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct {
+    uint32_t seq;               // Publishes so far: slot (seq & 1) is current
+} Seqlock;
+
+/**
+ * Reset to no publishes (slot 0 current)
+ * @param lock Pointer to lock
+ */
+void seqlock_init(Seqlock* lock);
+
+/**
+ * Publish a new value (writer only)
+ * @param lock Pointer to lock
+ * @param slots Two slots of size bytes each
+ * @param size Value size in bytes
+ * @param value Value to copy in
+ */
+void seqlock_publish(Seqlock* lock, void* slots, size_t size, const void* value);
+
+/**
+ * Start a read: the sequence to read the value at
+ * @param lock Pointer to lock
+ * @return Sequence (pass to seqlock_slot and seqlock_read_valid)
+ */
+uint32_t seqlock_read_begin(const Seqlock* lock);
+
+/**
+ * Slot holding the value at a sequence
+ * @param slots Two slots of size bytes each
+ * @param size Value size in bytes
+ * @param seq From seqlock_read_begin()
+ * @return Slot to copy from
+ */
+const void* seqlock_slot(const void* slots, size_t size, uint32_t seq);
+
+/**
+ * Finish a read: whether the copy taken since seqlock_read_begin() is
+ * whole (the writer has not started overwriting that slot)
+ * @param lock Pointer to lock
+ * @param seq From seqlock_read_begin()
+ * @return false if the copy may be torn (read again)
+ */
+bool seqlock_read_valid(const Seqlock* lock, uint32_t seq);
+
+/**
+ * Copy out a consistent value
+ * @param lock Pointer to lock
+ * @param slots Two slots of size bytes each
+ * @param size Value size in bytes
+ * @param out Filled with the value
+ * @return Reads retried (0 unless the writer published meanwhile)
+ */
+uint32_t seqlock_read(const Seqlock* lock, const void* slots, size_t size, void* out);
+
+#endif // SEQLOCK_H
@@ -0,0 +1,118 @@
+/**
+ * Roxy RedLight v2.0 - Safety Supervisor Implementation
+ */
+
+#include "supervisor.h"
+#include <string.h>
+
+// =============================================================================
+// TIMING
+// =============================================================================
+
+void supervisor_init(Supervisor* sup, uint32_t now, uint32_t periodMs, uint32_t deadlineMs) {
+    memset(sup, 0, sizeof(Supervisor));
+    sup->periodUs = periodMs * 1000UL;
+    sup->deadlineUs = deadlineMs * 1000UL;
+    sup->releaseUs = now;
+    sup->fault = SAFETY_OK;
+    sup->tripFault = SAFETY_OK;
+}
+
+void supervisor_begin(Supervisor* sup, uint32_t now) {
+    int32_t late = (int32_t)(now - sup->releaseUs);
+    if (late < 0) {
+        late = 0;       // Woken a tick early
+    }
+
+    // Fell a whole period behind: those checks never ran
+    if ((uint32_t)late >= sup->periodUs) {
+        uint32_t skipped = (uint32_t)late / sup->periodUs;
+        sup->missed += skipped;
+        sup->releaseUs += skipped * sup->periodUs;
+        late -= (int32_t)(skipped * sup->periodUs);
+    }
+
+    if ((uint32_t)late > sup->lateMaxUs) {
+        sup->lateMaxUs = late;
+    }
+    sup->startUs = now;
+}
+
+void supervisor_end(Supervisor* sup, uint32_t now) {
+    uint32_t exec = now - sup->startUs;
+    uint32_t response = now - sup->releaseUs;
+    if (exec > sup->execMaxUs) {
+        sup->execMaxUs = exec;
+    }
+    if (response > sup->responseMaxUs) {
+        sup->responseMaxUs = response;
+    }
+    if (response > sup->deadlineUs) {
+        sup->missed++;
+    }
+    sup->runs++;
+    sup->releaseUs += sup->periodUs;
+}
+
+void supervisor_set_period(Supervisor* sup, uint32_t now, uint32_t periodMs) {
+    uint32_t periodUs = periodMs * 1000UL;
+    if (periodUs == sup->periodUs) {
+        return;
+    }
+
+    // releaseUs is already one old period past the last check's release
+    sup->releaseUs += periodUs - sup->periodUs;
+    sup->periodUs = periodUs;
+    if ((int32_t)(now - sup->releaseUs) > 0) {
+        sup->releaseUs = now;
+    }
+}
+
+uint32_t supervisor_worst_case(const Supervisor* sup) {
+    return sup->periodUs + sup->lateMaxUs + sup->execMaxUs;
+}
+
+// =============================================================================
+// VERDICT
+// =============================================================================
+
+// Faults that make lit LEDs unsafe (the rest only refuse a new session)
+static bool critical(SafetyResult result) {
+    switch (result) {
+        case SAFETY_ERR_OVERVOLTAGE:
+        case SAFETY_ERR_UNDERVOLTAGE:
+        case SAFETY_ERR_THERMAL:
+        case SAFETY_ERR_SESSION_TOO_LONG:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool supervisor_check(Supervisor* sup, float voltage, float temp_c, bool session_active,
+                      uint32_t elapsed_seconds) {
+    // No session history here: start limits are loop()'s to enforce
+    SafetyStatus status = safety_check_all(voltage, temp_c, 0, UINT32_MAX, session_active,
+                                           elapsed_seconds);
+    SafetyResult fault = critical(status.error) ? status.error : SAFETY_OK;
+
+    // A fault arising trips once; it clears when the readings recover
+    if (fault != SAFETY_OK && sup->fault == SAFETY_OK) {
+        sup->tripFault = fault;
+        sup->offPending = true;
+        __atomic_store_n(&sup->trips, sup->trips + 1, __ATOMIC_RELEASE);   // Publish the trip
+    }
+    sup->fault = fault;
+    return fault != SAFETY_OK;
+}
+
+void supervisor_leds_off(Supervisor* sup, uint32_t now) {
+    if (!sup->offPending) {
+        return;
+    }
+    sup->offPending = false;
+    sup->offLatencyUs = now - sup->startUs;
+    if (sup->offLatencyUs > sup->offLatencyMaxUs) {
+        sup->offLatencyMaxUs = sup->offLatencyUs;
+    }
+}
@@ -0,0 +1,103 @@
+/**
+ * Roxy RedLight v2.0 - Safety Supervisor
+ *
+ * Testable core of the safety task: each check runs safety_check_all() on
+ * fresh readings and says whether the LEDs must be off, latching a trip
+ * for loop() to follow up. It also keeps the check's timing against its
+ * release (the time it was due), so deadline misses and the worst-case
+ * fault-to-LED-off latency are measured rather than assumed.
+ * Times are microseconds (micros(), wrap-safe).
+ */
+
+#ifndef SUPERVISOR_H
+#define SUPERVISOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "safety.h"
+
+#define SUPERVISOR_NO_SENSOR    -999.0f     // Temperature when no thermistor is fitted
+
+typedef struct {
+    // Timing
+    uint32_t periodUs;
+    uint32_t deadlineUs;        // Release to finish allowed
+    uint32_t releaseUs;         // When the current check was due
+    uint32_t startUs;           // When it started
+    uint32_t runs;
+    uint32_t missed;            // Checks finished past the deadline, and releases skipped
+    uint32_t lateMaxUs;         // Release to start
+    uint32_t execMaxUs;         // Start to finish
+    uint32_t responseMaxUs;     // Release to finish
+
+    // Verdict
+    uint8_t fault;              // SafetyResult holding the LEDs off, SAFETY_OK if none
+    uint8_t tripFault;          // Fault of the latest trip
+    uint32_t trips;             // Faults raised (loop() follows up on each)
+    bool offPending;            // This check tripped; LEDs not yet off
+    uint32_t offLatencyUs;      // Latest trip: check start to LEDs off
+    uint32_t offLatencyMaxUs;
+} Supervisor;
+
+/**
+ * Start a supervisor with its first check due now
+ * @param sup Pointer to supervisor
+ * @param now Current time (us)
+ * @param periodMs Check period
+ * @param deadlineMs Time after release by which a check must finish
+ */
+void supervisor_init(Supervisor* sup, uint32_t now, uint32_t periodMs, uint32_t deadlineMs);
+
+/**
+ * Mark the start of a check (before sampling)
+ * @param sup Pointer to supervisor
+ * @param now Current time (us)
+ */
+void supervisor_begin(Supervisor* sup, uint32_t now);
+
+/**
+ * Evaluate a check's readings. Voltage, temperature and session length
+ * faults hold the LEDs off; the session start limits do not.
+ * @param sup Pointer to supervisor
+ * @param voltage Battery voltage
+ * @param temp_c Temperature (SUPERVISOR_NO_SENSOR without a sensor)
+ * @param session_active Whether a session is running
+ * @param elapsed_seconds Session duration so far
+ * @return true if the LEDs must be off
+ */
+bool supervisor_check(Supervisor* sup, float voltage, float temp_c, bool session_active,
+                      uint32_t elapsed_seconds);
+
+/**
+ * Record that the LEDs are off (times the trip if this check raised one)
+ * @param sup Pointer to supervisor
+ * @param now Current time (us)
+ */
+void supervisor_leds_off(Supervisor* sup, uint32_t now);
+
+/**
+ * Mark the end of a check and advance to the next release
+ * @param sup Pointer to supervisor
+ * @param now Current time (us)
+ */
+void supervisor_end(Supervisor* sup, uint32_t now);
+
+/**
+ * Change the check period. The next check falls one new period after the
+ * last was due, or at once if that has passed: nothing counts as missed.
+ * @param sup Pointer to supervisor
+ * @param now Current time (us)
+ * @param periodMs New check period
+ */
+void supervisor_set_period(Supervisor* sup, uint32_t now, uint32_t periodMs);
+
+/**
+ * Worst-case time from a fault arising to the LEDs going off, as measured
+ * so far: it can arise just after a check sampled, so a full period plus
+ * the worst lateness and check time
+ * @param sup Pointer to supervisor
+ * @return us
+ */
+uint32_t supervisor_worst_case(const Supervisor* sup);
+
+#endif // SUPERVISOR_H
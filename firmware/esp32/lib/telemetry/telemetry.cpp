@@ -0,0 +1,165 @@
+/**
+ * Roxy RedLight v2.0 - Telemetry Traces Implementation
+ */
+
+#include "telemetry.h"
+#include <string.h>
+
+// =============================================================================
+// RING
+// =============================================================================
+
+void telemetry_ring_init(TelemetryRing* ring) {
+    memset(ring, 0, sizeof(TelemetryRing));
+}
+
+void telemetry_ring_push(TelemetryRing* ring, const TelemetrySample* sample) {
+    ring->samples[ring->written & (TELEMETRY_RING_SIZE - 1)] = *sample;
+    ring->written++;
+}
+
+bool telemetry_ring_read(const TelemetryRing* ring, uint32_t* cursor, TelemetrySample* sample) {
+    uint32_t behind = ring->written - *cursor;
+    if (behind == 0) {
+        return false;
+    }
+    if (behind > TELEMETRY_RING_SIZE) {
+        *cursor = ring->written - TELEMETRY_RING_SIZE;  // Overwritten: skip ahead
+    }
+
+    *sample = ring->samples[*cursor & (TELEMETRY_RING_SIZE - 1)];
+    (*cursor)++;
+    return true;
+}
+
+// =============================================================================
+// TRACE
+// =============================================================================
+
+static TelemetryColumn* columnAt(TelemetryTrace* trace, uint16_t index) {
+    return &trace->columns[(trace->first + index) % TELEMETRY_COLUMNS];
+}
+
+void telemetry_trace_init(TelemetryTrace* trace, uint16_t span, bool grow) {
+    memset(trace, 0, sizeof(TelemetryTrace));
+    trace->span = span ? span : 1;
+    trace->grow = grow;
+}
+
+// Halve the column count: pairs merge into one column of twice the span
+static void mergePairs(TelemetryTrace* trace) {
+    for (uint16_t i = 0; i < TELEMETRY_COLUMNS / 2; i++) {
+        const TelemetryColumn* a = &trace->columns[2 * i];
+        const TelemetryColumn* b = &trace->columns[2 * i + 1];
+        TelemetryColumn merged;
+        for (uint8_t s = 0; s < SERIES_COUNT; s++) {
+            merged.lo[s] = (a->lo[s] < b->lo[s]) ? a->lo[s] : b->lo[s];
+            merged.hi[s] = (a->hi[s] > b->hi[s]) ? a->hi[s] : b->hi[s];
+        }
+        trace->columns[i] = merged;
+    }
+    trace->count = TELEMETRY_COLUMNS / 2;
+    trace->span *= 2;
+    trace->filled = trace->span;    // The newest merged column is complete
+}
+
+void telemetry_trace_add(TelemetryTrace* trace, const TelemetrySample* sample) {
+    if (trace->count == 0 || trace->filled >= trace->span) {
+        // Start a new column, making room first
+        if (trace->count == TELEMETRY_COLUMNS) {
+            if (trace->grow) {
+                mergePairs(trace);      // Growing traces never wrap: first is 0
+            } else {
+                trace->first = (trace->first + 1) % TELEMETRY_COLUMNS;
+                trace->count--;
+            }
+        }
+        TelemetryColumn* column = columnAt(trace, trace->count);
+        for (uint8_t s = 0; s < SERIES_COUNT; s++) {
+            column->lo[s] = sample->value[s];
+            column->hi[s] = sample->value[s];
+        }
+        trace->count++;
+        trace->filled = 1;
+        return;
+    }
+
+    TelemetryColumn* column = columnAt(trace, trace->count - 1);
+    for (uint8_t s = 0; s < SERIES_COUNT; s++) {
+        if (sample->value[s] < column->lo[s]) {
+            column->lo[s] = sample->value[s];
+        }
+        if (sample->value[s] > column->hi[s]) {
+            column->hi[s] = sample->value[s];
+        }
+    }
+    trace->filled++;
+}
+
+const TelemetryColumn* telemetry_trace_column(const TelemetryTrace* trace, uint16_t index) {
+    return &trace->columns[(trace->first + index) % TELEMETRY_COLUMNS];
+}
+
+// =============================================================================
+// SCALING
+// =============================================================================
+
+void telemetry_trace_range(const TelemetryTrace* trace, uint8_t series, int16_t minSpan,
+                           int16_t* lo, int16_t* hi) {
+    int32_t low = 0;
+    int32_t high = 0;
+    for (uint16_t i = 0; i < trace->count; i++) {
+        const TelemetryColumn* column = telemetry_trace_column(trace, i);
+        if (i == 0 || column->lo[series] < low) {
+            low = column->lo[series];
+        }
+        if (i == 0 || column->hi[series] > high) {
+            high = column->hi[series];
+        }
+    }
+
+    if (high - low < minSpan) {
+        int32_t mid = (low + high) / 2;
+        low = mid - minSpan / 2;
+        high = low + minSpan;
+    }
+    *lo = (int16_t)((low < INT16_MIN) ? INT16_MIN : low);
+    *hi = (int16_t)((high > INT16_MAX) ? INT16_MAX : high);
+}
+
+// Row of a value: hi on row 0, lo on the last row, clamped to the chart
+static uint8_t rowOf(int16_t value, int16_t lo, int16_t hi, uint8_t height) {
+    if (value >= hi) {
+        return 0;
+    }
+    if (value <= lo) {
+        return height - 1;
+    }
+    return (uint8_t)(((int32_t)(hi - value) * (height - 1) + (hi - lo) / 2) / (hi - lo));
+}
+
+void telemetry_trace_plot(const TelemetryTrace* trace, uint8_t series, int16_t lo, int16_t hi,
+                          uint8_t height, uint8_t rows[][2]) {
+    memset(rows, TELEMETRY_EMPTY, TELEMETRY_COLUMNS * 2);
+    if (hi <= lo || height == 0) {
+        return;
+    }
+
+    for (uint16_t i = 0; i < trace->count; i++) {
+        const TelemetryColumn* column = telemetry_trace_column(trace, i);
+        uint8_t top = rowOf(column->hi[series], lo, hi, height);
+        uint8_t bottom = rowOf(column->lo[series], lo, hi, height);
+
+        // Reach the previous column when the two do not overlap
+        if (i > 0) {
+            if (top > rows[i - 1][1]) {
+                top = rows[i - 1][1];
+            }
+            if (bottom < rows[i - 1][0]) {
+                bottom = rows[i - 1][0];
+            }
+        }
+        rows[i][0] = top;
+        rows[i][1] = bottom;
+    }
+}
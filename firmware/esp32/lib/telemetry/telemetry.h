@@ -0,0 +1,143 @@
+/**
+ * Roxy RedLight v2.0 - Telemetry Traces
+ *
+ * Testable sample history for the telemetry screen: a fixed ring of raw
+ * samples written by the control loop, and min/max decimators that fold
+ * each sample into chart-width columns as it is read, so drawing never
+ * rescans the history
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// LIMITS
+// =============================================================================
+
+#define TELEMETRY_RING_SIZE     256     // Raw samples kept (power of two)
+#define TELEMETRY_COLUMNS       150     // Chart width in pixels (even)
+#define TELEMETRY_EMPTY         0xFF    // Plot row marking a column with no data
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+typedef enum {
+    SERIES_VOLTS = 0,   // Battery, centivolts
+    SERIES_TEMP,        // Temperature, tenths of a degree C
+    SERIES_DUTY,        // LED duty, percent
+    SERIES_COUNT
+} TelemetrySeries;
+
+typedef struct {
+    int16_t value[SERIES_COUNT];
+} TelemetrySample;
+
+// Single writer, single reader on the same core: no locking
+typedef struct {
+    TelemetrySample samples[TELEMETRY_RING_SIZE];
+    uint32_t written;           // Samples ever pushed (wraps)
+} TelemetryRing;
+
+// Range of each series over the samples folded into one column
+typedef struct {
+    int16_t lo[SERIES_COUNT];
+    int16_t hi[SERIES_COUNT];
+} TelemetryColumn;
+
+// A chart's worth of columns. Growing traces cover everything since they
+// were started: when full, neighbouring columns merge and the span
+// doubles. Sliding traces keep the span and drop their oldest column.
+typedef struct {
+    TelemetryColumn columns[TELEMETRY_COLUMNS];
+    uint16_t first;             // Oldest column (sliding traces wrap)
+    uint16_t count;             // Columns holding data
+    uint16_t span;              // Samples per column
+    uint16_t filled;            // Samples in the newest column
+    bool grow;
+} TelemetryTrace;
+
+// =============================================================================
+// RING FUNCTIONS
+// =============================================================================
+
+/**
+ * Empty a ring
+ * @param ring Pointer to ring
+ */
+void telemetry_ring_init(TelemetryRing* ring);
+
+/**
+ * Append a sample, overwriting the oldest once full
+ * @param ring Pointer to ring
+ * @param sample Sample to store
+ */
+void telemetry_ring_push(TelemetryRing* ring, const TelemetrySample* sample);
+
+/**
+ * Read the sample after a reader's cursor. A reader that fell more than a
+ * ring behind resumes at the oldest sample still stored.
+ * @param ring Pointer to ring
+ * @param cursor Reader position (start at ring->written), advanced
+ * @param sample Filled with the sample read
+ * @return false if the reader is caught up
+ */
+bool telemetry_ring_read(const TelemetryRing* ring, uint32_t* cursor, TelemetrySample* sample);
+
+// =============================================================================
+// TRACE FUNCTIONS
+// =============================================================================
+
+/**
+ * Start an empty trace
+ * @param trace Pointer to trace
+ * @param span Samples per column (initial span for growing traces)
+ * @param grow true to merge columns when full, false to slide
+ */
+void telemetry_trace_init(TelemetryTrace* trace, uint16_t span, bool grow);
+
+/**
+ * Fold one sample into the newest column (O(1), amortized for merges)
+ * @param trace Pointer to trace
+ * @param sample Sample to add
+ */
+void telemetry_trace_add(TelemetryTrace* trace, const TelemetrySample* sample);
+
+/**
+ * Column by age
+ * @param trace Pointer to trace
+ * @param index 0 = oldest, count - 1 = newest
+ * @return Pointer to the column
+ */
+const TelemetryColumn* telemetry_trace_column(const TelemetryTrace* trace, uint16_t index);
+
+/**
+ * Range of a series over the trace, widened about its middle to a minimum
+ * span so noise does not fill the chart
+ * @param trace Pointer to trace
+ * @param series Series to measure
+ * @param minSpan Smallest hi - lo to return
+ * @param lo Filled with the bottom of the range
+ * @param hi Filled with the top of the range
+ */
+void telemetry_trace_range(const TelemetryTrace* trace, uint8_t series, int16_t minSpan,
+                           int16_t* lo, int16_t* hi);
+
+/**
+ * Scale a series to chart rows: per column, the top and bottom row its
+ * min/max covers (row 0 at the top), joined to the previous column so the
+ * trace reads as a line. Columns without data get TELEMETRY_EMPTY.
+ * @param trace Pointer to trace
+ * @param series Series to plot
+ * @param lo Value at the bottom row
+ * @param hi Value at the top row
+ * @param height Chart rows
+ * @param rows Filled with TELEMETRY_COLUMNS (top, bottom) pairs
+ */
+void telemetry_trace_plot(const TelemetryTrace* trace, uint8_t series, int16_t lo, int16_t hi,
+                          uint8_t height, uint8_t rows[][2]);
+
+#endif // TELEMETRY_H
@@ -4,6 +4,94 @@
 
 #include "ui.h"
 
+// =============================================================================
+// TRANSITION TABLE
+// =============================================================================
+
+#define T(action, next)     {ACTION_##action, next}
+#define STAY                UI_STAY
+#define ___                 {ACTION_NONE, UI_STAY}
+
+// One row per screen, idle then session running; columns in ButtonEvent
+// order. Button 1 is primary/back, button 2 forward. While a session runs
+// button 1 stops it on every screen, and button 2 flips between the session
+// and telemetry screens; no double-click there, so a stop never waits.
+// Idle, the session screen shows home and acts so.
+static const UITransition transitions[SCREEN_COUNT][2][BUTTON_EVENT_COUNT] = {
+    // NONE, 1_SHORT, 1_LONG, 2_SHORT, 2_LONG, 1_DOUBLE, 1_REPEAT, 2_DOUBLE, 2_REPEAT
+    {   // SCREEN_HOME
+        {___, T(START_SESSION, SCREEN_SESSION), T(CHANGE_MODE, STAY),
+              T(NAVIGATE_NEXT, SCREEN_STATS), T(SHOW_DIAGNOSTICS, STAY),
+              ___, ___, ___, ___},
+        {___, T(STOP_SESSION, STAY), T(STOP_SESSION, STAY),
+              T(NAVIGATE_NEXT, SCREEN_TELEMETRY), T(NAVIGATE_NEXT, SCREEN_TELEMETRY),
+              ___, ___, ___, ___}
+    },
+    {   // SCREEN_SESSION
+        {___, T(START_SESSION, SCREEN_SESSION), T(CHANGE_MODE, STAY),
+              T(NAVIGATE_NEXT, SCREEN_STATS), T(SHOW_DIAGNOSTICS, STAY),
+              ___, ___, ___, ___},
+        {___, T(STOP_SESSION, STAY), T(STOP_SESSION, STAY),
+              T(NAVIGATE_NEXT, SCREEN_TELEMETRY), T(NAVIGATE_NEXT, SCREEN_TELEMETRY),
+              ___, ___, ___, ___}
+    },
+    {   // SCREEN_STATS
+        {___, T(NAVIGATE_PREV, SCREEN_HOME), T(NAVIGATE_PREV, SCREEN_HOME),
+              T(NAVIGATE_NEXT, SCREEN_SETTINGS), T(NAVIGATE_NEXT, SCREEN_SETTINGS),
+              T(GO_HOME, SCREEN_HOME), ___, ___, ___},
+        {___, T(STOP_SESSION, STAY), T(STOP_SESSION, STAY),
+              T(NAVIGATE_NEXT, SCREEN_TELEMETRY), T(NAVIGATE_NEXT, SCREEN_TELEMETRY),
+              ___, ___, ___, ___}
+    },
+    {   // SCREEN_SETTINGS: button 2 highlights the next mode, button 1 sets it
+        {___, T(CONFIRM_SETTING, SCREEN_HOME), T(NAVIGATE_PREV, SCREEN_STATS),
+              T(SELECT_SETTING, STAY), T(NAVIGATE_NEXT, SCREEN_BATTERY),
+              T(GO_HOME, SCREEN_HOME), ___, ___, T(SELECT_SETTING, STAY)},
+        {___, T(STOP_SESSION, STAY), T(STOP_SESSION, STAY),
+              T(NAVIGATE_NEXT, SCREEN_TELEMETRY), T(NAVIGATE_NEXT, SCREEN_TELEMETRY),
+              ___, ___, ___, ___}
+    },
+    {   // SCREEN_BATTERY
+        {___, T(NAVIGATE_PREV, SCREEN_SETTINGS), T(NAVIGATE_PREV, SCREEN_SETTINGS),
+              T(NAVIGATE_NEXT, SCREEN_SAFETY), T(NAVIGATE_NEXT, SCREEN_SAFETY),
+              T(GO_HOME, SCREEN_HOME), ___, ___, ___},
+        {___, T(STOP_SESSION, STAY), T(STOP_SESSION, STAY),
+              T(NAVIGATE_NEXT, SCREEN_TELEMETRY), T(NAVIGATE_NEXT, SCREEN_TELEMETRY),
+              ___, ___, ___, ___}
+    },
+    {   // SCREEN_SAFETY
+        {___, T(NAVIGATE_PREV, SCREEN_BATTERY), T(NAVIGATE_PREV, SCREEN_BATTERY),
+              T(NAVIGATE_NEXT, SCREEN_TELEMETRY), T(NAVIGATE_NEXT, SCREEN_TELEMETRY),
+              T(GO_HOME, SCREEN_HOME), ___, ___, ___},
+        {___, T(STOP_SESSION, STAY), T(STOP_SESSION, STAY),
+              T(NAVIGATE_NEXT, SCREEN_TELEMETRY), T(NAVIGATE_NEXT, SCREEN_TELEMETRY),
+              ___, ___, ___, ___}
+    },
+    {   // SCREEN_TELEMETRY: a long press switches the window
+        {___, T(NAVIGATE_PREV, SCREEN_SAFETY), T(NAVIGATE_PREV, SCREEN_SAFETY),
+              T(NAVIGATE_NEXT, SCREEN_HISTORY), T(TOGGLE_RANGE, STAY),
+              T(GO_HOME, SCREEN_HOME), ___, ___, ___},
+        {___, T(STOP_SESSION, STAY), T(STOP_SESSION, STAY),
+              T(NAVIGATE_PREV, SCREEN_SESSION), T(TOGGLE_RANGE, STAY),
+              ___, ___, ___, ___}
+    },
+    {   // SCREEN_HISTORY: pages, leaving past either end
+        {___, T(PAGE_NEWER, SCREEN_TELEMETRY), T(PAGE_NEWER, SCREEN_TELEMETRY),
+              T(PAGE_OLDER, SCREEN_HOME), T(PAGE_OLDER, SCREEN_HOME),
+              T(GO_HOME, SCREEN_HOME), T(PAGE_NEWER, STAY), ___, T(PAGE_OLDER, STAY)},
+        {___, T(STOP_SESSION, STAY), T(STOP_SESSION, STAY),
+              T(NAVIGATE_NEXT, SCREEN_TELEMETRY), T(NAVIGATE_NEXT, SCREEN_TELEMETRY),
+              ___, ___, ___, ___}
+    }
+};
+
+static_assert(sizeof(transitions) / sizeof(transitions[0]) == SCREEN_COUNT,
+              "one transition row per screen");
+
+#undef T
+#undef STAY
+#undef ___
+
 // =============================================================================
 // INITIALIZATION
 // =============================================================================
@@ -14,7 +102,8 @@ void ui_init(UIState* state) {
     state->session_active = false;
     state->current_mode = UI_MODE_DUAL;
     state->selected_mode = UI_MODE_DUAL;
-    state->settings_index = 0;
+    state->history_page = 0;
+    state->history_pages = 1;
     state->screen_changed = true;  // Force initial draw
 }
 
@@ -40,6 +129,11 @@ void ui_prev_screen(UIState* state) {
 
 void ui_goto_screen(UIState* state, Screen screen) {
     if (screen < SCREEN_COUNT) {
+        // Lists open at the top: the newest history, the mode in use
+        if (screen != state->current_screen) {
+            state->history_page = 0;
+            state->selected_mode = state->current_mode;
+        }
         state->previous_screen = state->current_screen;
         state->current_screen = screen;
         state->screen_changed = true;
@@ -88,69 +182,73 @@ UITreatmentMode ui_prev_mode(UITreatmentMode current) {
 // BUTTON HANDLING
 // =============================================================================
 
-UIAction ui_handle_button(UIState* state, ButtonEvent event) {
-    if (event == BUTTON_NONE) {
-        return ACTION_NONE;
+UITransition ui_transition(Screen screen, bool session_active, ButtonEvent event) {
+    if (screen >= SCREEN_COUNT || event >= BUTTON_EVENT_COUNT) {
+        UITransition none = {ACTION_NONE, UI_STAY};
+        return none;
     }
+    return transitions[screen][session_active ? 1 : 0][event];
+}
 
-    // Button 2 always navigates (except in settings)
-    if (event == BUTTON_2_SHORT) {
-        if (state->current_screen == SCREEN_SETTINGS) {
-            // In settings, Button 2 cycles through options
-            state->selected_mode = ui_next_mode(state->selected_mode);
-            state->screen_changed = true;
-            return ACTION_SELECT_SETTING;
-        } else {
-            ui_next_screen(state);
-            return ACTION_NAVIGATE_NEXT;
-        }
+bool ui_handles(const UIState* state, ButtonEvent event) {
+    return ui_transition(state->current_screen, state->session_active, event).action != ACTION_NONE;
+}
+
+void ui_set_history_pages(UIState* state, uint32_t pages) {
+    state->history_pages = (pages > 0) ? pages : 1;
+    if (state->history_page >= state->history_pages) {
+        state->history_page = state->history_pages - 1;
     }
+}
+
+UIAction ui_handle_button(UIState* state, ButtonEvent event) {
+    UITransition t = ui_transition(state->current_screen, state->session_active, event);
+    UIAction action = (UIAction)t.action;
 
-    // Button 1 behavior depends on screen and session state
-    if (event == BUTTON_1_SHORT) {
-        switch (state->current_screen) {
-            case SCREEN_HOME:
-                if (!state->session_active) {
-                    return ACTION_START_SESSION;
-                }
-                break;
-
-            case SCREEN_SESSION:
-                if (state->session_active) {
-                    return ACTION_STOP_SESSION;
-                } else {
-                    return ACTION_START_SESSION;
-                }
-                break;
-
-            case SCREEN_SETTINGS:
-                // Confirm mode selection
-                state->current_mode = state->selected_mode;
+    switch (action) {
+        case ACTION_PAGE_NEWER:
+            if (state->history_page > 0) {
+                state->history_page--;
                 state->screen_changed = true;
-                return ACTION_CONFIRM_SETTING;
+                return action;
+            }
+            action = (t.next == UI_STAY) ? ACTION_NONE : ACTION_NAVIGATE_PREV;
+            break;
 
-            case SCREEN_STATS:
-            case SCREEN_BATTERY:
-            case SCREEN_SAFETY:
-                // No primary action on info screens
-                break;
+        case ACTION_PAGE_OLDER:
+            if (state->history_page + 1 < state->history_pages) {
+                state->history_page++;
+                state->screen_changed = true;
+                return action;
+            }
+            action = (t.next == UI_STAY) ? ACTION_NONE : ACTION_NAVIGATE_NEXT;
+            break;
 
-            default:
-                break;
-        }
-    }
+        case ACTION_SELECT_SETTING:
+            state->selected_mode = ui_next_mode(state->selected_mode);
+            state->screen_changed = true;
+            break;
+
+        case ACTION_CONFIRM_SETTING:
+            state->current_mode = state->selected_mode;
+            state->screen_changed = true;
+            break;
 
-    // Long press Button 1 - quick mode change from home
-    if (event == BUTTON_1_LONG) {
-        if (state->current_screen == SCREEN_HOME && !state->session_active) {
+        case ACTION_CHANGE_MODE:
+            // Quick mode change from home
             state->current_mode = ui_next_mode(state->current_mode);
             state->selected_mode = state->current_mode;
             state->screen_changed = true;
-            return ACTION_CHANGE_MODE;
-        }
+            break;
+
+        default:
+            break;
     }
 
-    return ACTION_NONE;
+    if (t.next != UI_STAY) {
+        ui_goto_screen(state, (Screen)t.next);
+    }
+    return action;
 }
 
 // =============================================================================
@@ -170,12 +268,14 @@ const char* ui_get_mode_name(UITreatmentMode mode) {
 
 const char* ui_get_screen_name(Screen screen) {
     switch (screen) {
-        case SCREEN_HOME:     return "Home";
-        case SCREEN_SESSION:  return "Session";
-        case SCREEN_STATS:    return "Stats";
-        case SCREEN_SETTINGS: return "Settings";
-        case SCREEN_BATTERY:  return "Battery";
-        case SCREEN_SAFETY:   return "Safety";
-        default:              return "Unknown";
+        case SCREEN_HOME:      return "Home";
+        case SCREEN_SESSION:   return "Session";
+        case SCREEN_STATS:     return "Stats";
+        case SCREEN_SETTINGS:  return "Settings";
+        case SCREEN_BATTERY:   return "Battery";
+        case SCREEN_SAFETY:    return "Safety";
+        case SCREEN_TELEMETRY: return "Telemetry";
+        case SCREEN_HISTORY:   return "History";
+        default:               return "Unknown";
     }
 }
@@ -1,7 +1,9 @@
 /**
  * Roxy RedLight v2.0 - UI State Machine
  *
- * Testable UI logic separated from display rendering
+ * Testable UI logic separated from display rendering. Button handling is a
+ * compile-time transition table indexed by (screen, session running, event),
+ * shared by the firmware and the native tests.
  */
 
 #ifndef UI_H
@@ -15,12 +17,14 @@
 // =============================================================================
 
 typedef enum {
-    SCREEN_HOME = 0,
-    SCREEN_SESSION,
-    SCREEN_STATS,
-    SCREEN_SETTINGS,
-    SCREEN_BATTERY,
-    SCREEN_SAFETY,
+    SCREEN_HOME = 0,    // Main idle screen
+    SCREEN_SESSION,     // Active session display
+    SCREEN_STATS,       // Usage statistics
+    SCREEN_SETTINGS,    // Mode selection
+    SCREEN_BATTERY,     // Battery details
+    SCREEN_SAFETY,      // Safety status
+    SCREEN_TELEMETRY,   // Voltage, temperature and LED duty traces
+    SCREEN_HISTORY,     // Past sessions, a page at a time
     SCREEN_COUNT
 } Screen;
 
@@ -46,7 +50,12 @@ typedef enum {
     BUTTON_1_SHORT,     // Primary action
     BUTTON_1_LONG,      // Secondary action
     BUTTON_2_SHORT,     // Navigation
-    BUTTON_2_LONG       // Reserved
+    BUTTON_2_LONG,      // Reserved
+    BUTTON_1_DOUBLE,    // Two short presses in quick succession
+    BUTTON_1_REPEAT,    // Still held after a long press, every repeat period
+    BUTTON_2_DOUBLE,
+    BUTTON_2_REPEAT,
+    BUTTON_EVENT_COUNT
 } ButtonEvent;
 
 // =============================================================================
@@ -61,9 +70,27 @@ typedef enum {
     ACTION_NAVIGATE_NEXT,
     ACTION_NAVIGATE_PREV,
     ACTION_SELECT_SETTING,
-    ACTION_CONFIRM_SETTING
+    ACTION_CONFIRM_SETTING,
+    ACTION_GO_HOME,
+    ACTION_PAGE_NEWER,          // History: a screenful newer
+    ACTION_PAGE_OLDER,          // History: a screenful older
+    ACTION_TOGGLE_RANGE,        // Telemetry: session or last hour
+    ACTION_SHOW_DIAGNOSTICS     // Hidden render profile screen
 } UIAction;
 
+// =============================================================================
+// TRANSITION TABLE
+// =============================================================================
+
+#define UI_STAY             0xFF        // UITransition.next: keep the screen
+
+// What an event does on a screen. The next screen applies after the action;
+// for the history page actions it applies only once past the last page.
+typedef struct {
+    uint8_t action;             // UIAction
+    uint8_t next;               // Screen, or UI_STAY
+} UITransition;
+
 // =============================================================================
 // UI STATE
 // =============================================================================
@@ -73,8 +100,9 @@ typedef struct {
     Screen previous_screen;
     bool session_active;
     UITreatmentMode current_mode;
-    UITreatmentMode selected_mode;      // In settings screen
-    uint8_t settings_index;             // Which setting is highlighted
+    UITreatmentMode selected_mode;      // Highlighted in settings screen
+    uint32_t history_page;              // Screenful shown, 0 = newest
+    uint32_t history_pages;             // Screenfuls of history stored
     bool screen_changed;                // Flag for display update
 } UIState;
 
@@ -96,6 +124,31 @@ void ui_init(UIState* state);
  */
 UIAction ui_handle_button(UIState* state, ButtonEvent event);
 
+/**
+ * Look up a transition in the table
+ * @param screen Current screen
+ * @param session_active Whether a session is running
+ * @param event Button event
+ * @return Transition (ACTION_NONE and UI_STAY if the event does nothing)
+ */
+UITransition ui_transition(Screen screen, bool session_active, ButtonEvent event);
+
+/**
+ * Check whether an event does anything in the current state (e.g. to only
+ * wait for double-clicks where they are used)
+ * @param state Pointer to UI state
+ * @param event Button event
+ * @return true if the event has an action
+ */
+bool ui_handles(const UIState* state, ButtonEvent event);
+
+/**
+ * Set how many screenfuls of history can be paged through
+ * @param state Pointer to UI state
+ * @param pages Screenful count (at least 1)
+ */
+void ui_set_history_pages(UIState* state, uint32_t pages);
+
 /**
  * Navigate to next screen
  * @param state Pointer to UI state
@@ -0,0 +1,91 @@
+/**
+ * Roxy RedLight v2.0 - Retained Widgets Implementation
+ */
+
+#include "widget.h"
+#include <stddef.h>
+
+// =============================================================================
+// SIGNATURES
+// =============================================================================
+
+uint32_t widget_sig(const WidgetValue* value) {
+    // FNV-1a over the fields, then the data by content: equal views give
+    // equal signatures wherever they are held
+    const uint8_t* p = (const uint8_t*)value;
+    uint32_t h = 2166136261UL;
+    for (size_t i = 0; i < offsetof(WidgetValue, data); i++) {
+        h ^= p[i];
+        h *= 16777619UL;
+    }
+    for (uint16_t i = 0; value->data && i < value->dataLen; i++) {
+        h ^= value->data[i];
+        h *= 16777619UL;
+    }
+    h ^= value->dataLen;
+    h *= 16777619UL;
+    return h ? h : 1;
+}
+
+// =============================================================================
+// STATE
+// =============================================================================
+
+void widget_reset(WidgetState* state) {
+    for (uint8_t b = 0; b < WIDGET_BUFFERS; b++) {
+        widget_invalidate(state, b);
+    }
+    DirtyRect none = {0, 0, 0, 0};
+    state->shownSig = 0;
+    state->shownBounds = none;
+}
+
+void widget_invalidate(WidgetState* state, uint8_t buffer) {
+    DirtyRect none = {0, 0, 0, 0};
+    state->sig[buffer] = 0;
+    state->bounds[buffer] = none;
+}
+
+bool widget_stale(const WidgetState* state, uint8_t buffer, uint32_t sig) {
+    return state->sig[buffer] != sig;
+}
+
+void widget_painted(WidgetState* state, uint8_t buffer, uint32_t sig, DirtyRect bounds) {
+    state->sig[buffer] = sig;
+    state->bounds[buffer] = bounds;
+}
+
+bool widget_show(WidgetState* state, uint32_t sig, DirtyRect bounds, DirtyRegion* dirty) {
+    if (state->shownSig == sig) {
+        return false;
+    }
+
+    // Old pixels must be overwritten and new pixels shown
+    DirtyRect old = state->shownBounds;
+    dirty_add(dirty, old.x, old.y, old.w, old.h);
+    dirty_add(dirty, bounds.x, bounds.y, bounds.w, bounds.h);
+
+    state->shownSig = sig;
+    state->shownBounds = bounds;
+    return true;
+}
+
+// =============================================================================
+// GEOMETRY
+// =============================================================================
+
+DirtyRect widget_text_bounds(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t datum) {
+    if (w <= 0) {
+        DirtyRect none = {x, y, 0, 0};
+        return none;
+    }
+
+    int16_t bx = x - ((datum % 3) * w) / 2;
+    int16_t by = y - ((datum / 3) * h) / 2;
+
+    DirtyRect r = {
+        (int16_t)(bx - WIDGET_TEXT_PAD), (int16_t)(by - WIDGET_TEXT_PAD),
+        (int16_t)(w + 2 * WIDGET_TEXT_PAD), (int16_t)(h + 2 * WIDGET_TEXT_PAD)
+    };
+    return r;
+}
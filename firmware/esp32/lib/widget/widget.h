@@ -0,0 +1,140 @@
+/**
+ * Roxy RedLight v2.0 - Retained Widgets
+ *
+ * Testable bookkeeping for screens declared as static widget tables:
+ * what each widget showed, where, in which frame buffer and on the panel
+ */
+
+#ifndef WIDGET_H
+#define WIDGET_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "dirty.h"
+
+// =============================================================================
+// LIMITS
+// =============================================================================
+
+#define WIDGET_BUFFERS      2       // Frame buffers a widget can be painted in
+#define WIDGET_TEXT_PAD     2       // Glyph overhang around measured text
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+typedef enum {
+    WIDGET_LABEL = 0,   // Text in a built-in font at an anchor and datum
+    WIDGET_VALUE,       // Numeric text blitted from a glyph atlas
+    WIDGET_PROGRESS,    // Rounded bar filled left to right (level in permille)
+    WIDGET_LEVEL,       // Box filled from the bottom (level in percent)
+    WIDGET_BATTERY,     // Small battery icon (level in percent, flag: charging)
+    WIDGET_LEDS,        // Red/NIR indicator pair (flags: bit 0 red, bit 1 NIR,
+                        // bit 2 lit lamps pulse)
+    WIDGET_OPTION,      // Menu or list row: text, detail (flags: bit 0 selected,
+                        // bit 1 current)
+    WIDGET_CHART        // Min/max trace: data holds (top, bottom) rows per column,
+                        // text and detail the top and bottom range labels
+} WidgetType;
+
+// What a widget shows this frame, filled in by its binding. Zero it before
+// binding: the signature covers every byte, and data by content.
+typedef struct {
+    char text[24];
+    char detail[32];
+    uint16_t fg;
+    uint16_t bg;
+    int16_t level;
+    uint8_t flags;
+    const uint8_t* data;    // Bulk data in the view (charts), NULL if none
+    uint16_t dataLen;
+} WidgetValue;
+
+// Reads a widget's value out of a view snapshot
+typedef void (*WidgetBind)(const void* view, WidgetValue* value);
+
+// One node of a screen table (const, lives in flash)
+typedef struct {
+    uint8_t type;       // WidgetType
+    uint8_t font;       // Text font (labels, values, options)
+    uint8_t datum;      // Text datum, TL_DATUM..BR_DATUM (0-8)
+    int16_t x;          // Text anchor, or top-left of the box
+    int16_t y;
+    int16_t w;          // Box size (0 for text: measured per value)
+    int16_t h;
+    WidgetBind bind;
+} Widget;
+
+// Per-widget memory of what was drawn where
+typedef struct {
+    uint32_t sig[WIDGET_BUFFERS];       // Value painted in each buffer (0 = none)
+    DirtyRect bounds[WIDGET_BUFFERS];   // Pixels it covers there
+    uint32_t shownSig;                  // Value on the panel (0 = unknown)
+    DirtyRect shownBounds;
+} WidgetState;
+
+// =============================================================================
+// STATE FUNCTIONS
+// =============================================================================
+
+/**
+ * Signature of a value (never 0, which marks "nothing painted")
+ * @param value Pointer to value
+ * @return Hash of every field of the value and the data it points to
+ */
+uint32_t widget_sig(const WidgetValue* value);
+
+/**
+ * Forget everything: not painted in any buffer, unknown on the panel
+ * @param state Pointer to state
+ */
+void widget_reset(WidgetState* state);
+
+/**
+ * Forget one buffer's contents (it was overwritten)
+ * @param state Pointer to state
+ * @param buffer Buffer index
+ */
+void widget_invalidate(WidgetState* state, uint8_t buffer);
+
+/**
+ * Check if a buffer holds anything other than this value
+ * @param state Pointer to state
+ * @param buffer Buffer index
+ * @param sig Signature of the value to show
+ * @return true if the widget must be repainted in the buffer
+ */
+bool widget_stale(const WidgetState* state, uint8_t buffer, uint32_t sig);
+
+/**
+ * Record a repaint in a buffer
+ * @param state Pointer to state
+ * @param buffer Buffer index
+ * @param sig Signature painted
+ * @param bounds Pixels covered
+ */
+void widget_painted(WidgetState* state, uint8_t buffer, uint32_t sig, DirtyRect bounds);
+
+/**
+ * Record the value the panel will show, marking old and new pixels dirty
+ * if it changed
+ * @param state Pointer to state
+ * @param sig Signature of the new value
+ * @param bounds Pixels the new value covers
+ * @param dirty Region to add changed pixels to
+ * @return true if the value changed
+ */
+bool widget_show(WidgetState* state, uint32_t sig, DirtyRect bounds, DirtyRegion* dirty);
+
+/**
+ * Bounds of text placed like TFT_eSPI's drawString, padded for overhang
+ * @param x Anchor x
+ * @param y Anchor y
+ * @param w Measured text width
+ * @param h Font height
+ * @param datum TL_DATUM..BR_DATUM (columns L/C/R, rows T/M/B)
+ * @return Padded bounding rect
+ */
+DirtyRect widget_text_bounds(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t datum);
+
+#endif // WIDGET_H
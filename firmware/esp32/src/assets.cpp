@@ -0,0 +1,74 @@
+/**
+ * Roxy RedLight v2.0 - Image Assets
+ *
+ * Generated by tools/asset_tool.cpp from assets/ - do not edit.
+ */
+
+#include "assets.h"
+
+// logo.ppm: 120x72, 6 colors, 679 bytes (17280 as RGB565)
+static const uint16_t paletteLogo[] = {0xF81F, 0x8410, 0x2104, 0xF800, 0x7800, 0xFFFF};
+
+static const uint8_t dataLogo[] = {
+    0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xD7, 0x1D, 0x0F, 0x54, 0x1F, 0x0A, 0x0F,
+    0x4A, 0x1F, 0x12, 0x0F, 0x44, 0x1F, 0x16, 0x0F, 0x3F, 0x1E, 0x25, 0x31,
+    0x25, 0x1E, 0x0F, 0x3A, 0x1B, 0x28, 0x35, 0x28, 0x1B, 0x0F, 0x36, 0x19,
+    0x2C, 0x35, 0x2C, 0x19, 0x0F, 0x32, 0x18, 0x21, 0x43, 0x28, 0x37, 0x28,
+    0x43, 0x21, 0x18, 0x0F, 0x2E, 0x18, 0x22, 0x45, 0x51, 0x25, 0x37, 0x27,
+    0x45, 0x22, 0x18, 0x0F, 0x2B, 0x17, 0x24, 0x42, 0x54, 0x26, 0x35, 0x28,
+    0x45, 0x24, 0x17, 0x0F, 0x28, 0x17, 0x25, 0x40, 0x55, 0x40, 0x27, 0x35,
+    0x27, 0x47, 0x25, 0x17, 0x0F, 0x25, 0x16, 0x25, 0x55, 0x42, 0x2A, 0x31,
+    0x2A, 0x46, 0x27, 0x16, 0x0F, 0x23, 0x16, 0x24, 0x54, 0x45, 0x2F, 0x08,
+    0x45, 0x29, 0x16, 0x0F, 0x21, 0x15, 0x25, 0x53, 0x22, 0x43, 0x2F, 0x0A,
+    0x43, 0x2C, 0x15, 0x0F, 0x1E, 0x16, 0x24, 0x53, 0x2F, 0x25, 0x16, 0x0F,
+    0x1B, 0x15, 0x21, 0x32, 0x53, 0x2F, 0x22, 0x34, 0x21, 0x15, 0x0F, 0x19,
+    0x15, 0x22, 0x31, 0x53, 0x2F, 0x22, 0x35, 0x22, 0x15, 0x0F, 0x17, 0x15,
+    0x22, 0x31, 0x52, 0x31, 0x2F, 0x22, 0x36, 0x22, 0x15, 0x0F, 0x15, 0x15,
+    0x23, 0x53, 0x32, 0x2F, 0x08, 0x31, 0x2F, 0x08, 0x36, 0x23, 0x15, 0x0F,
+    0x14, 0x14, 0x23, 0x52, 0x34, 0x2F, 0x06, 0x35, 0x2F, 0x06, 0x36, 0x24,
+    0x14, 0x0F, 0x13, 0x14, 0x23, 0x52, 0x35, 0x2F, 0x06, 0x35, 0x2F, 0x06,
+    0x35, 0x26, 0x14, 0x0F, 0x11, 0x14, 0x23, 0x52, 0x21, 0x32, 0x2C, 0x41,
+    0x27, 0x37, 0x27, 0x41, 0x2C, 0x32, 0x28, 0x14, 0x0F, 0x0F, 0x14, 0x23,
+    0x52, 0x2F, 0x01, 0x45, 0x25, 0x37, 0x25, 0x45, 0x2F, 0x08, 0x14, 0x0F,
+    0x0D, 0x14, 0x23, 0x52, 0x2F, 0x02, 0x45, 0x26, 0x35, 0x26, 0x45, 0x2F,
+    0x09, 0x14, 0x0F, 0x0C, 0x14, 0x22, 0x52, 0x2F, 0x02, 0x47, 0x25, 0x35,
+    0x25, 0x47, 0x2F, 0x08, 0x14, 0x0F, 0x0B, 0x14, 0x23, 0x51, 0x2F, 0x03,
+    0x47, 0x27, 0x31, 0x27, 0x47, 0x2F, 0x09, 0x14, 0x0F, 0x09, 0x14, 0x23,
+    0x51, 0x2F, 0x05, 0x45, 0x2F, 0x04, 0x45, 0x2F, 0x05, 0x41, 0x23, 0x14,
+    0x0F, 0x08, 0x14, 0x21, 0x40, 0x52, 0x40, 0x2F, 0x04, 0x45, 0x2F, 0x04,
+    0x45, 0x2F, 0x04, 0x44, 0x21, 0x14, 0x0F, 0x07, 0x14, 0x22, 0x52, 0x42,
+    0x2F, 0x05, 0x41, 0x2F, 0x08, 0x41, 0x2F, 0x05, 0x45, 0x22, 0x14, 0x0F,
+    0x06, 0x13, 0x22, 0x40, 0x51, 0x43, 0x2F, 0x36, 0x46, 0x22, 0x13, 0x0F,
+    0x05, 0x14, 0x22, 0x52, 0x43, 0x28, 0x34, 0x2F, 0x1A, 0x34, 0x28, 0x46,
+    0x22, 0x14, 0x0F, 0x04, 0x13, 0x23, 0x51, 0x44, 0x27, 0x36, 0x2F, 0x18,
+    0x36, 0x27, 0x45, 0x24, 0x13, 0x0F, 0x03, 0x14, 0x22, 0x51, 0x44, 0x28,
+    0x36, 0x2F, 0x18, 0x36, 0x28, 0x44, 0x24, 0x14, 0x0F, 0x02, 0x13, 0x22,
+    0x52, 0x21, 0x41, 0x29, 0x36, 0x2F, 0x18, 0x36, 0x29, 0x41, 0x27, 0x13,
+    0x0F, 0x01, 0x14, 0x22, 0x51, 0x2E, 0x36, 0x2B, 0x43, 0x27, 0x33, 0x2B,
+    0x36, 0x2F, 0x04, 0x14, 0x0F, 0x00, 0x13, 0x22, 0x52, 0x2F, 0x00, 0x34,
+    0x2B, 0x45, 0x25, 0x35, 0x2B, 0x34, 0x2F, 0x06, 0x13, 0x0F, 0x00, 0x13,
+    0x2F, 0x07, 0x32, 0x2B, 0x46, 0x25, 0x36, 0x2B, 0x32, 0x2F, 0x07, 0x13,
+    0x0E, 0x13, 0x2F, 0x17, 0x46, 0x25, 0x36, 0x2F, 0x17, 0x13, 0x0D, 0x13,
+    0x2F, 0x18, 0x45, 0x25, 0x35, 0x2F, 0x18, 0x13, 0x0C, 0x14, 0x2F, 0x18,
+    0x45, 0x25, 0x35, 0x2F, 0x18, 0x14, 0x0B, 0x13, 0x2F, 0x1A, 0x42, 0x29,
+    0x32, 0x2F, 0x1A, 0x13, 0x0B, 0x13, 0x23, 0x34, 0x2F, 0x42, 0x34, 0x23,
+    0x13, 0x0B, 0x13, 0x23, 0x35, 0x28, 0x43, 0x2A, 0x31, 0x2F, 0x0C, 0x41,
+    0x2A, 0x43, 0x28, 0x35, 0x23, 0x13, 0x0A, 0x14, 0x22, 0x36, 0x27, 0x45,
+    0x28, 0x34, 0x2F, 0x08, 0x44, 0x28, 0x45, 0x27, 0x36, 0x22, 0x14, 0x09,
+    0x13, 0x23, 0x36, 0x26, 0x46, 0x27, 0x36, 0x2F, 0x06, 0x46, 0x27, 0x46,
+    0x26, 0x36, 0x23, 0x13, 0x09, 0x13, 0x23, 0x36, 0x26, 0x46, 0x27, 0x36,
+    0x2F, 0x06, 0x46, 0x27, 0x46, 0x26, 0x36, 0x23, 0x13, 0x09, 0x13, 0x24,
+    0x35, 0x26, 0x46, 0x27, 0x36, 0x2F, 0x06, 0x46, 0x27, 0x46, 0x26, 0x35,
+    0x24, 0x13, 0x09, 0x13, 0x25, 0x32, 0x29, 0x45, 0x27, 0x35, 0x2F, 0x08,
+    0x45, 0x27, 0x45, 0x29, 0x32, 0x25, 0x13, 0x09, 0x13, 0x2F, 0x04, 0x42,
+    0x2A, 0x34, 0x2F, 0x08, 0x44, 0x2A, 0x42, 0x2F, 0x04, 0x13, 0x08, 0x13,
+    0x2F, 0x58, 0x13, 0x07, 0x13, 0x2F, 0x58, 0x13, 0x07, 0x13, 0x2F, 0x58,
+    0x13, 0x07, 0x13, 0x2F, 0x58, 0x13, 0x07, 0x13, 0x2F, 0x58, 0x13, 0x07,
+    0x13, 0x2F, 0x58, 0x13, 0x07, 0x13, 0x2F, 0x58, 0x13, 0x05, 0x1F, 0x64,
+    0x03, 0x1F, 0x64, 0x03, 0x1F, 0x64, 0x03, 0x1F, 0x64, 0x03, 0x1F, 0x64,
+    0x03, 0x1F, 0x64, 0x0F, 0xFF, 0x0F, 0xC3
+};
+
+const Asset assetLogo = {
+    120, 72, 6, 0, paletteLogo, dataLogo, sizeof(dataLogo)
+};
@@ -5,18 +5,216 @@
  */
 
 #include "display.h"
+#include "assets.h"
+#include <math.h>
+#include <stdarg.h>
+#include <time.h>
+
+#ifdef ARDUINO
+#include <esp_heap_caps.h>
+#else
+#include "host_port.h"
+#endif
 
 // Global instance
 Display display;
 
+// Frame timing hooks, empty unless DISPLAY_PROFILE
+#if DISPLAY_PROFILE
+#define PROFILE_BEGIN(slot)     profileBegin(slot)
+#define PROFILE_MARK(phase)     profileMark(phase)
+#define PROFILE_END()           profileEnd()
+#else
+#define PROFILE_BEGIN(slot)
+#define PROFILE_MARK(phase)
+#define PROFILE_END()
+#endif
+
+// Strip rendering: frames are drawn STRIP_LINES rows at a time (one strip
+// covering the whole screen when DISPLAY_STRIP_LINES is 0)
+#if DISPLAY_STRIP_LINES
+#define STRIP_LINES     DISPLAY_STRIP_LINES
+#else
+#define STRIP_LINES     TFT_HEIGHT
+#endif
+#define STRIP_COUNT     ((TFT_HEIGHT + STRIP_LINES - 1) / STRIP_LINES)
+#define ROW_BYTES       (TFT_WIDTH * DISPLAY_COLOR_DEPTH / 8)
+
+// Over i80 the DMA can read 16 bpp frames in PSRAM as they are, in runs
+// of whole 16-byte blocks: bands start and end on 4-row boundaries
+// (4 x 340 bytes) of a 16-byte aligned frame
+#define STREAM_FRAMES   (DISPLAY_BUS_I80 && DISPLAY_COLOR_DEPTH == 16)
+#define STREAM_ROWS     4
+#define STREAM_ALIGN    16
+
+// Screen bodies run once per strip pass, drawing the whole screen each time
+#define FOR_EACH_STRIP  for (bool pass = firstStrip(); pass; pass = nextStrip())
+
+// Rows in the strip starting at top (the last one may be short)
+static int16_t stripRows(int16_t top) {
+    return (top + STRIP_LINES > TFT_HEIGHT) ? TFT_HEIGHT - top : STRIP_LINES;
+}
+
+// =============================================================================
+// PALETTE
+// =============================================================================
+
+// Every color the UI draws with. In 4-bit mode the sprites hold indices
+// into this table and the push path expands them back to RGB565.
+static const uint16_t palette[16] = {
+    COLOR_BG, COLOR_TEXT, COLOR_RED, COLOR_NIR,
+    COLOR_GREEN, COLOR_YELLOW, COLOR_ORANGE, COLOR_HEADER,
+    COLOR_PANEL, COLOR_BORDER, COLOR_GRAY, COLOR_RED_OFF,
+    COLOR_RED_RIM_OFF, COLOR_NIR_OFF, COLOR_NIR_RIM, COLOR_BG  // Spare
+};
+
+// Palette in panel byte order (sprites store RGB565 byte-swapped)
+static uint16_t panelPalette[16];
+
+// Sprite color for an RGB565 value: itself, or its palette index
+static uint16_t ink(uint16_t color) {
+    #if DISPLAY_COLOR_DEPTH == 4
+    uint8_t best = 0;
+    int32_t bestDist = INT32_MAX;
+    for (uint8_t i = 0; i < 16; i++) {
+        if (palette[i] == color) {
+            return i;
+        }
+        // Not in the table: fall back to the nearest entry
+        int32_t dr = (int32_t)(palette[i] >> 11) - (color >> 11);
+        int32_t dg = (int32_t)((palette[i] >> 5) & 0x3F) - ((color >> 5) & 0x3F);
+        int32_t db = (int32_t)(palette[i] & 0x1F) - (color & 0x1F);
+        int32_t dist = 4*dr*dr + dg*dg + 4*db*db;
+        if (dist < bestDist) {
+            bestDist = dist;
+            best = i;
+        }
+    }
+    return best;
+    #else
+    return color;
+    #endif
+}
+
+// =============================================================================
+// PRIMITIVE SIGNATURES
+// =============================================================================
+
+// Primitive type tags mixed into each signature
+enum {
+    PRIM_FILL_SCREEN = 1,
+    PRIM_FILL_RECT,
+    PRIM_DRAW_RECT,
+    PRIM_FILL_ROUND_RECT,
+    PRIM_DRAW_ROUND_RECT,
+    PRIM_FILL_CIRCLE,
+    PRIM_DRAW_CIRCLE,
+    PRIM_STRING,
+    PRIM_CHROME,
+    PRIM_GLYPH,
+    PRIM_ASSET
+};
+
+// FNV-1a, good enough to tell frames apart
+static uint32_t hashBytes(uint32_t h, const void* data, size_t len) {
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 16777619UL;
+    }
+    return h;
+}
+
+static uint32_t hashPrim(uint8_t type, int a, int b, int c, int d, int e, uint16_t color) {
+    int32_t args[7] = {type, a, b, c, d, e, color};
+    return hashBytes(2166136261UL, args, sizeof(args));
+}
+
 // =============================================================================
 // CONSTRUCTOR & INIT
 // =============================================================================
 
-Display::Display() : sprite(&tft) {
+Display::Display() : frameA(&tft), frameB(&tft) {
+    draw = &frameA;
+    flight = &frameA;
     currentScreen = SCREEN_HOME;
     needsRedraw = true;
     lastUpdate = 0;
+
+    dirty_init(&dirty, TFT_WIDTH, TFT_HEIGHT);
+    recordCount = 0;
+    prevRecordCount = 0;
+    recordOverflow = false;
+    pushBytes = 0;
+
+    bandCount = 0;
+    bandIndex = 0;
+    bandRow = 0;
+    stageBuf[0] = NULL;
+    stageBuf[1] = NULL;
+    stageIndex = 0;
+    dmaActive = false;
+    chunkStaged = false;
+    stagedData = NULL;
+    stagedY = 0;
+    stagedRows = 0;
+    streamFrames = false;
+
+    for (uint8_t i = 0; i < CHROME_COUNT; i++) {
+        chrome[i] = NULL;
+    }
+    bigDigits.font = 7;
+    smallDigits.font = 2;
+    for (uint8_t i = 0; i < GLYPH_COUNT; i++) {
+        bigDigits.bits[i] = NULL;
+        smallDigits.bits[i] = NULL;
+    }
+
+    frameBytes = (size_t)TFT_WIDTH * TFT_HEIGHT * DISPLAY_COLOR_DEPTH / 8;
+
+    for (uint8_t i = 0; i < DISPLAY_MAX_WIDGETS; i++) {
+        widget_reset(&widgetState[i]);
+    }
+    bufferChrome[0] = CHROME_NONE;
+    bufferChrome[1] = CHROME_NONE;
+    shownChrome = CHROME_NONE;
+    retained = false;
+
+    for (uint8_t i = 0; i < DISPLAY_MAX_WIDGETS; i++) {
+        tween_set(&tweens[i], 0);
+    }
+    wipeDir = 0;
+    wipeStart = 0;
+    wipeRows = 0;
+    moving = false;
+    pacer_init(&pacer, 1000000UL / DISPLAY_ANIM_FPS, DISPLAY_ANIM_MAX_LOAD);
+    tracking = true;
+    stripNo = 0;
+    replay = false;
+
+    notice_init(&notices);
+    notice = NULL;
+    shownNotice = 0;
+
+    memset(&lastView, 0, sizeof(lastView));
+    viewValid = false;
+    frameStats.rendered = 0;
+    frameStats.skipped = 0;
+    frameStats.lastFrameMicros = 0;
+    frameStats.dropped = 0;
+    frameStart = 0;
+
+    textFont = 1;
+    textDatum = TL_DATUM;
+    textFg = COLOR_TEXT;
+    textBg = COLOR_BG;
+
+    #if DISPLAY_PROFILE
+    resetProfile();
+    profileSlot = PROFILE_NONE;
+    profileStart = 0;
+    profileLast = 0;
+    #endif
 }
 
 void Display::begin() {
@@ -24,9 +222,64 @@ void Display::begin() {
     tft.setRotation(TFT_ROTATION);
     tft.fillScreen(COLOR_BG);
 
-    // Create sprite for flicker-free rendering
-    sprite.createSprite(TFT_WIDTH, TFT_HEIGHT);
-    sprite.setTextDatum(MC_DATUM);
+    for (uint8_t i = 0; i < 16; i++) {
+        panelPalette[i] = (palette[i] >> 8) | (palette[i] << 8);
+    }
+
+    uint32_t heapBefore = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    uint32_t psramBefore = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+
+    // Create sprite for flicker-free rendering (or the strip buffer)
+    createFrame(frameA);
+
+    // Staging buffers in internal RAM: DMA cannot read the PSRAM sprites,
+    // and palette frames must be expanded to RGB565 before they are sent
+    #if DISPLAY_DMA_ENABLED || DISPLAY_COLOR_DEPTH != 16 || DISPLAY_BUS_I80
+    size_t chunkBytes = TFT_WIDTH * DISPLAY_DMA_LINES * sizeof(uint16_t);
+    stageBuf[0] = (uint16_t*)heap_caps_malloc(chunkBytes, MALLOC_CAP_DMA);
+    stageBuf[1] = (uint16_t*)heap_caps_malloc(chunkBytes, MALLOC_CAP_DMA);
+    #endif
+
+    #if DISPLAY_DMA_ENABLED
+    // Second frame to render into while the first is pushed (strips are
+    // redrawn while the staging buffers are on the wire instead)
+    #if !DISPLAY_STRIP_LINES
+    createFrame(frameB);
+    #endif
+    if ((STRIP_COUNT > 1 || frameB.created()) && stageBuf[0] && stageBuf[1]) {
+        tft.initDMA();
+        tft.startWrite();   // Panel is the only SPI device: keep CS asserted
+        dmaActive = true;
+
+        #if STREAM_FRAMES && !DISPLAY_STRIP_LINES
+        streamFrames = ((uintptr_t)frameA.getPointer() % STREAM_ALIGN) == 0 &&
+                       ((uintptr_t)frameB.getPointer() % STREAM_ALIGN) == 0;
+        if (!streamFrames) {
+            Serial.println("Display frames unaligned, staging i80 pushes");
+        }
+        #endif
+    } else {
+        Serial.println("Display DMA unavailable, using blocking push");
+        frameB.destroy();
+    }
+    #endif
+
+    setTextDatum(MC_DATUM);
+
+    // Pre-rasterize digits for the countdown and stats values
+    buildAtlas(bigDigits, 7);
+    buildAtlas(smallDigits, 2);
+
+    // Pre-render static screen layers (emergency screen included)
+    cacheChrome();
+
+    Serial.printf("Display: %d-bit %dx%d %s, %u bytes each\n",
+                  DISPLAY_COLOR_DEPTH, TFT_WIDTH, STRIP_LINES,
+                  (STRIP_COUNT > 1) ? "strip" : "frames",
+                  (unsigned)(STRIP_LINES * ROW_BYTES));
+    Serial.printf("Display: internal heap %u -> %u, PSRAM %u -> %u\n",
+                  heapBefore, (uint32_t)heap_caps_get_free_size(MALLOC_CAP_INTERNAL),
+                  psramBefore, (uint32_t)heap_caps_get_free_size(MALLOC_CAP_SPIRAM));
 
     // Enable backlight
     pinMode(PIN_TFT_BL, OUTPUT);
@@ -35,8 +288,37 @@ void Display::begin() {
     Serial.println("Display initialized");
 }
 
+void Display::createFrame(FrameCanvas& frame) {
+    // A strip is small enough for internal RAM, whole frames go to PSRAM
+    frame.create(TFT_WIDTH, STRIP_LINES, DISPLAY_COLOR_DEPTH, palette, STRIP_COUNT > 1);
+}
+
 void Display::clear() {
-    sprite.fillSprite(COLOR_BG);
+    // Start of a frame: the sprite is redrawn in full, but only primitives
+    // that differ from the previous frame end up in the dirty region
+    if (!replay) {
+        startImmediate();
+    }
+    draw->fillScreen(ink(COLOR_BG));
+}
+
+void Display::startImmediate() {
+    frameStart = micros();
+    recordCount = 0;
+    recordOverflow = false;
+
+    // Drawn over whatever widgets this buffer and the panel held
+    bufferChrome[(draw == &frameB) ? 1 : 0] = CHROME_NONE;
+    shownChrome = CHROME_NONE;
+    if (retained) {
+        retained = false;
+        needsRedraw = true;     // No records of what the widget frame drew
+    }
+
+    // Alerts and diagnostics do not animate
+    wipeDir = 0;
+    moving = false;
+    pacer_idle(&pacer);
 }
 
 void Display::setBrightness(uint8_t level) {
@@ -49,6 +331,9 @@ void Display::setBrightness(uint8_t level) {
 
 void Display::setScreen(Screen screen) {
     if (screen != currentScreen) {
+        // Wipe forwards or backwards, whichever way round is shorter
+        int steps = (screen - currentScreen + SCREEN_COUNT) % SCREEN_COUNT;
+        wipeDir = (steps <= SCREEN_COUNT / 2) ? 1 : -1;
         currentScreen = screen;
         needsRedraw = true;
     }
@@ -60,6 +345,7 @@ Screen Display::getScreen() {
 
 void Display::nextScreen() {
     currentScreen = (Screen)((currentScreen + 1) % SCREEN_COUNT);
+    wipeDir = 1;
     needsRedraw = true;
 }
 
@@ -69,391 +355,1725 @@ void Display::prevScreen() {
     } else {
         currentScreen = (Screen)(currentScreen - 1);
     }
+    wipeDir = -1;
     needsRedraw = true;
 }
 
 void Display::update() {
-    sprite.pushSprite(0, 0);
+    if (!replay) {
+        PROFILE_MARK(PHASE_DRAW);
+
+        // Primitives drawn last frame but not this one leave stale pixels
+        for (uint8_t i = recordCount; i < prevRecordCount; i++) {
+            DirtyRect b = records[i].bounds;
+            dirty_add(&dirty, b.x, b.y, b.w, b.h);
+        }
+        prevRecordCount = recordCount;
+
+        if (needsRedraw || recordOverflow) {
+            dirty_add_all(&dirty);
+            needsRedraw = false;
+        }
+
+        pushBytes = dirty_area(&dirty) * sizeof(uint16_t);
+    }
+
+    #if DISPLAY_STRIP_LINES
+    // This strip's share of the dirty region; nextStrip() finishes the frame
+    int16_t top = stripNo * STRIP_LINES;
+    DirtyRect strip = {0, top, TFT_WIDTH, stripRows(top)};
+    DirtyRect part;
+    for (uint8_t i = 0; i < dirty.count; i++) {
+        if (dirty_rect_clip(dirty.rects[i], strip, &part)) {
+            pushRect(part, top);
+        }
+    }
+    #else
+    if (!dmaActive) {
+        // Blocking push of only the changed sub-rectangles of the sprite
+        for (uint8_t i = 0; i < dirty.count; i++) {
+            pushRect(dirty.rects[i], 0);
+        }
+        dirty_clear(&dirty);
+        PROFILE_END();
+        frameStats.lastFrameMicros = micros() - frameStart;
+        return;
+    }
+
+    // DMA: rows are contiguous in the sprite, so queue full-width bands and
+    // let service() feed them out while the next frame renders elsewhere
+    waitFrame();    // Only one frame in flight (callers normally check first)
+    bandCount = dirty_row_bands(&dirty, bands);
+    if (streamFrames) {
+        alignBands();
+    }
+    bandIndex = 0;
+    bandRow = bandCount ? bands[0].y : 0;
+    pushBytes = 0;
+    for (uint8_t i = 0; i < bandCount; i++) {
+        pushBytes += (uint32_t)bands[i].w * bands[i].h * sizeof(uint16_t);
+    }
+    dirty_clear(&dirty);
+
+    flight = draw;
+    draw = (draw == &frameA) ? &frameB : &frameA;
+
+    // Carry text state over to the other buffer
+    draw->setTextFont(textFont);
+    draw->setTextColor(ink(textFg), ink(textBg));
+    draw->setTextDatum(textDatum);
+
+    service();
+    PROFILE_END();
+    frameStats.lastFrameMicros = micros() - frameStart;
+    #endif
 }
 
 // =============================================================================
-// SCREEN: HOME (Idle)
+// STRIP PASSES
 // =============================================================================
 
-void Display::showHome(float voltage, uint8_t battPercent, TreatmentMode mode) {
-    clear();
+bool Display::firstStrip() {
+    stripNo = 0;
+    replay = false;
+    #if DISPLAY_STRIP_LINES
+    draw->setOffset(0, 0);
+    #endif
+    return true;
+}
 
-    drawHeader("FOLICULATOR");
+bool Display::nextStrip() {
+    #if DISPLAY_STRIP_LINES
+    // The first pass tracked the whole frame, so the dirty region is final:
+    // replay the screen only for strips with something to push
+    while (++stripNo < STRIP_COUNT) {
+        int16_t top = stripNo * STRIP_LINES;
+        DirtyRect strip = {0, top, TFT_WIDTH, stripRows(top)};
+        for (uint8_t i = 0; i < dirty.count; i++) {
+            if (dirty_rect_intersects(dirty.rects[i], strip)) {
+                replay = true;
+                draw->setOffset(0, top);
+                return true;
+            }
+        }
+    }
 
-    // Battery icon and percentage
-    drawBatteryIcon(TFT_WIDTH - 45, 8, battPercent, false);
+    replay = false;
+    draw->setOffset(0, 0);
+    dirty_clear(&dirty);
+    PROFILE_END();
+    frameStats.lastFrameMicros = micros() - frameStart;
+    #endif
+    return false;
+}
 
-    // Large mode display in center
-    sprite.setTextSize(1);
-    sprite.setTextFont(4);
-    sprite.setTextColor(COLOR_TEXT, COLOR_BG);
-    sprite.setTextDatum(MC_DATUM);
+// =============================================================================
+// PUSH PATH
+// =============================================================================
 
-    const char* modeNames[] = {"OFF", "RED", "NIR", "DUAL", "ALT"};
-    sprite.drawString(modeNames[mode], TFT_WIDTH/2, 100);
+void Display::expandRows(uint16_t* dst, Canvas* src, int x, int y, int w, int rows) {
+    #if DISPLAY_COLOR_DEPTH == 4
+    // Two pixels per byte, even x in the high nibble
+    const uint8_t* img = (const uint8_t*)src->getPointer();
+    for (int row = y; row < y + rows; row++) {
+        uint32_t index = (uint32_t)row * TFT_WIDTH + x;
+        for (int i = 0; i < w; i++, index++) {
+            uint8_t pair = img[index >> 1];
+            *dst++ = panelPalette[(index & 1) ? (pair & 0x0F) : (pair >> 4)];
+        }
+    }
+    #else
+    // Already RGB565 in panel byte order
+    const uint16_t* img = (const uint16_t*)src->getPointer();
+    for (int row = y; row < y + rows; row++) {
+        memcpy(dst, img + (uint32_t)row * TFT_WIDTH + x, w * sizeof(uint16_t));
+        dst += w;
+    }
+    #endif
+}
 
-    // Mode description
-    sprite.setTextFont(2);
-    const char* modeDesc[] = {
-        "Disabled",
-        "650nm Surface",
-        "850nm Deep",
-        "Full Spectrum",
-        "Alternating"
-    };
-    sprite.drawString(modeDesc[mode], TFT_WIDTH/2, 130);
+void Display::pushRect(const DirtyRect& r, int16_t top) {
+    if (stageBuf[0] == NULL) {
+        #ifdef ARDUINO
+        static_cast<FrameCanvas*>(draw)->sprite.pushSprite(r.x, r.y, r.x, r.y - top, r.w, r.h);
+        #endif
+        return;
+    }
 
-    // LED indicator
-    bool redOn = (mode == MODE_RED_ONLY || mode == MODE_DUAL || mode == MODE_ALTERNATING);
-    bool nirOn = (mode == MODE_NIR_ONLY || mode == MODE_DUAL || mode == MODE_ALTERNATING);
-    drawLEDIndicator(TFT_WIDTH/2, 170, redOn, nirOn);
+    // Expand through the staging buffer a few rows at a time
+    for (int y = r.y; y < r.y + r.h; y += DISPLAY_DMA_LINES) {
+        int rows = r.y + r.h - y;
+        if (rows > DISPLAY_DMA_LINES) {
+            rows = DISPLAY_DMA_LINES;
+        }
+        if (dmaActive) {
+            // Strips: expand into one buffer while the other is on the wire
+            expandRows(stageBuf[stageIndex], draw, r.x, y - top, r.w, rows);
+            tft.dmaWait();
+            tft.pushImageDMA(r.x, y, r.w, rows, stageBuf[stageIndex]);
+            stageIndex ^= 1;
+        } else {
+            expandRows(stageBuf[0], draw, r.x, y - top, r.w, rows);
+            tft.pushImage(r.x, y, r.w, rows, stageBuf[0]);
+        }
+    }
+}
 
-    // Ready text
-    sprite.setTextFont(2);
-    sprite.setTextColor(COLOR_GREEN, COLOR_BG);
-    sprite.drawString("READY", TFT_WIDTH/2, 220);
+// =============================================================================
+// ASYNCHRONOUS PUSH
+// =============================================================================
+
+void Display::stageChunk() {
+    if (chunkStaged || bandIndex >= bandCount) {
+        return;
+    }
 
-    sprite.setTextColor(COLOR_TEXT, COLOR_BG);
-    sprite.drawString("Press to Start", TFT_WIDTH/2, 245);
+    DirtyRect band = bands[bandIndex];
+    int16_t rows = band.y + band.h - bandRow;
+    if (streamFrames) {
+        // The whole band in one transfer, straight from the frame
+        stagedData = (uint16_t*)flight->getPointer() + (size_t)bandRow * TFT_WIDTH;
+    } else {
+        if (rows > DISPLAY_DMA_LINES) {
+            rows = DISPLAY_DMA_LINES;
+        }
+        expandRows(stageBuf[stageIndex], flight, 0, bandRow, TFT_WIDTH, rows);
+        stagedData = stageBuf[stageIndex];
+    }
+    stagedY = bandRow;
+    stagedRows = rows;
+    chunkStaged = true;
 
-    // Footer with battery voltage
-    char voltStr[16];
-    snprintf(voltStr, sizeof(voltStr), "%.2fV", voltage);
-    drawFooter("Menu", voltStr);
+    bandRow += rows;
+    if (bandRow >= band.y + band.h && ++bandIndex < bandCount) {
+        bandRow = bands[bandIndex].y;
+    }
+}
 
-    update();
+void Display::alignBands() {
+    // Widen each band to whole DMA blocks, merging any that now overlap
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < bandCount; i++) {
+        int16_t y0 = bands[i].y / STREAM_ROWS * STREAM_ROWS;
+        int16_t y1 = (bands[i].y + bands[i].h + STREAM_ROWS - 1) / STREAM_ROWS * STREAM_ROWS;
+        if (y1 > TFT_HEIGHT) {
+            y1 = TFT_HEIGHT;
+        }
+        int16_t end = (count > 0) ? bands[count - 1].y + bands[count - 1].h : -1;
+        if (y0 <= end) {
+            if (y1 > end) {
+                bands[count - 1].h = y1 - bands[count - 1].y;
+            }
+        } else {
+            bands[count].x = 0;
+            bands[count].y = y0;
+            bands[count].w = TFT_WIDTH;
+            bands[count].h = y1 - y0;
+            count++;
+        }
+    }
+    bandCount = count;
+}
+
+void Display::service() {
+    if (!dmaActive) {
+        return;
+    }
+
+    // Copy the next chunk while the current one is on the wire
+    stageChunk();
+    if (!chunkStaged || tft.dmaBusy()) {
+        return;
+    }
+
+    tft.pushImageDMA(0, stagedY, TFT_WIDTH, stagedRows, stagedData);
+    stageIndex ^= 1;
+    chunkStaged = false;
+    stageChunk();
+}
+
+bool Display::frameInFlight() {
+    if (!dmaActive) {
+        return false;
+    }
+    return chunkStaged || bandIndex < bandCount || tft.dmaBusy();
+}
+
+void Display::waitFrame() {
+    while (frameInFlight()) {
+        tft.dmaWait();
+        service();
+    }
+}
+
+uint32_t Display::lastPushBytes() {
+    return pushBytes;
+}
+
+Canvas& Display::canvas() {
+    return *draw;
 }
 
 // =============================================================================
-// SCREEN: SESSION (Active Treatment)
+// CHANGE-DRIVEN RENDERING
 // =============================================================================
 
-void Display::showSession(unsigned long elapsedSec, unsigned long totalSec,
-                          TreatmentMode mode, bool redOn, bool nirOn) {
-    clear();
+bool Display::viewChanged(const ViewModel& view) {
+    const Notice* n = notice_current(&notices, millis());
+    bool noticeChanged = (n ? n->id : 0) != shownNotice;
 
-    // Calculate remaining time
-    unsigned long remainingSec = (totalSec > elapsedSec) ? totalSec - elapsedSec : 0;
-    float progress = (float)elapsedSec / totalSec;
+    if (viewValid && !needsRedraw && !noticeChanged && !frameDue() &&
+        memcmp(&view, &lastView, sizeof(view)) == 0) {
+        frameStats.skipped++;
+        return false;
+    }
 
-    // Header with mode
-    const char* modeNames[] = {"OFF", "RED", "NIR", "DUAL", "ALT"};
-    char header[32];
-    snprintf(header, sizeof(header), "SESSION - %s", modeNames[mode]);
-    drawHeader(header);
+    lastView = view;
+    viewValid = true;
+    frameStats.rendered++;
+    return true;
+}
 
-    // Large countdown timer
-    sprite.setTextFont(7);
-    sprite.setTextColor(COLOR_GREEN, COLOR_BG);
-    sprite.setTextDatum(MC_DATUM);
+FrameStats Display::getFrameStats() {
+    return frameStats;
+}
 
-    char timeStr[16];
-    snprintf(timeStr, sizeof(timeStr), "%lu:%02lu",
-             remainingSec / 60, remainingSec % 60);
-    sprite.drawString(timeStr, TFT_WIDTH/2, 100);
+void Display::render(const ViewModel& view) {
+    // A notice appearing, changing or going away repaints the whole
+    // screen; one staying up is painted over the widgets every frame
+    notice = notice_current(&notices, millis());
+    uint32_t noticeId = notice ? notice->id : 0;
+    if (noticeId != shownNotice) {
+        needsRedraw = true;
+        shownNotice = noticeId;
+    }
 
-    // "remaining" label
-    sprite.setTextFont(2);
-    sprite.setTextColor(COLOR_TEXT, COLOR_BG);
-    sprite.drawString("remaining", TFT_WIDTH/2, 140);
+    // A latched trip holds the emergency screen over every view until acknowledged
+    if (notice && notice->level == NOTICE_CRITICAL && notice->duration == NOTICE_STICKY) {
+        if (needsRedraw) {
+            showEmergency(notice->text);
+            viewValid = true;       // Painted for this view: no repaint until it changes
+            needsRedraw = false;
+        }
+        pacer_idle(&pacer);
+        frameStats.dropped = pacer.dropped;
+        return;
+    }
 
-    // Progress bar
-    drawProgressBar(MARGIN, 165, TFT_WIDTH - 2*MARGIN, 20, progress, COLOR_GREEN);
+    setScreen(view.screen);
+    renderScreen((view.screen < SCREEN_COUNT) ? view.screen : SCREEN_HOME, view);
 
-    // Elapsed time
-    sprite.setTextFont(2);
-    char elapsedStr[32];
-    snprintf(elapsedStr, sizeof(elapsedStr), "Elapsed: %lu:%02lu",
-             elapsedSec / 60, elapsedSec % 60);
-    sprite.drawString(elapsedStr, TFT_WIDTH/2, 200);
+    // Keep frames coming on the pacer's grid while anything moves
+    if (moving) {
+        pacer_frame(&pacer, frameStart, micros());
+    } else {
+        pacer_idle(&pacer);
+    }
+    frameStats.dropped = pacer.dropped;
+}
 
-    // LED status indicator
-    drawLEDIndicator(TFT_WIDTH/2, 240, redOn, nirOn);
+bool Display::frameDue() {
+    return frameDelay() == 0;
+}
 
-    // Footer
-    drawFooter("Stop", "");
+uint32_t Display::frameDelay() {
+    uint32_t wait = pacer_wait(&pacer, micros());
 
-    update();
+    // Take the notice showing down when it expires
+    uint32_t expiry = notice_next(&notices, millis());
+    if (expiry != NOTICE_IDLE && expiry * 1000UL < wait) {
+        wait = expiry * 1000UL;
+    }
+    return wait;
 }
 
 // =============================================================================
-// SCREEN: STATS
+// STATIC CHROME
 // =============================================================================
 
-void Display::showStats(uint32_t sessions, uint32_t minutes, uint8_t dailySessions) {
-    clear();
+// Everything on a screen that never changes: drawn once into a PSRAM
+// cache at boot and restored with one memcpy at the start of each frame
+
+void Display::drawChrome(uint8_t id) {
+    switch (id) {
+        case SCREEN_HOME:
+            drawHeader("FOLICULATOR");
+
+            setTextFont(2);
+            setTextDatum(MC_DATUM);
+            setTextColor(COLOR_GREEN, COLOR_BG);
+            drawString("READY", TFT_WIDTH/2, 220);
+
+            setTextColor(COLOR_TEXT, COLOR_BG);
+            drawString("Press to Start", TFT_WIDTH/2, 245);
+
+            drawFooter("Menu", "");
+            break;
+
+        case SCREEN_SESSION:
+            drawHeader("");
+
+            setTextFont(2);
+            setTextColor(COLOR_TEXT, COLOR_BG);
+            setTextDatum(MC_DATUM);
+            drawString("remaining", TFT_WIDTH/2, 140);
+
+            drawFooter("Stop", "");
+            break;
+
+        case SCREEN_STATS: {
+            drawHeader("STATISTICS");
+
+            setTextFont(2);
+            setTextColor(COLOR_TEXT, COLOR_BG);
+            setTextDatum(TL_DATUM);
+
+            const char* labels[] = {
+                "Lifetime Sessions:", "Total Minutes:", "Total Hours:",
+                "Today's Sessions:", "Est. Total Dose:"
+            };
+            int y = HEADER_HEIGHT + 20;
+            for (int i = 0; i < 5; i++) {
+                drawString(labels[i], MARGIN, y);
+                y += 30;
+            }
+
+            drawFooter("<", ">");
+            break;
+        }
+
+        case SCREEN_SETTINGS:
+            drawHeader("SELECT MODE");
+            drawFooter("Set", "Next");
+            break;
+
+        case SCREEN_BATTERY: {
+            drawHeader("BATTERY");
+
+            // Battery outline
+            int iconX = TFT_WIDTH/2 - 30;
+            int iconY = 70;
+            drawRoundRect(iconX, iconY, 60, 100, 5, COLOR_TEXT);
+            fillRect(iconX + 20, iconY - 8, 20, 10, COLOR_TEXT);  // Top nub
 
-    drawHeader("STATISTICS");
+            drawFooter("<", ">");
+            break;
+        }
+
+        case SCREEN_SAFETY: {
+            drawHeader("SAFETY STATUS");
+
+            setTextFont(2);
+            setTextDatum(TL_DATUM);
+
+            int y = HEADER_HEIGHT + 20;
+            setTextColor(COLOR_TEXT, COLOR_BG);
+            drawString("Voltage:", MARGIN, y);
+            setTextColor(COLOR_GRAY, COLOR_BG);
+            drawString("Safe: 6.2V - 8.6V", MARGIN, y + 25);
+
+            y += 60;
+            setTextColor(COLOR_TEXT, COLOR_BG);
+            drawString("Temperature:", MARGIN, y);
+            setTextColor(COLOR_GRAY, COLOR_BG);
+            drawString("Max: 45C", MARGIN, y + 25);
+
+            drawFooter("<", ">");
+            break;
+        }
+
+        case SCREEN_TELEMETRY: {
+            drawHeader("TELEMETRY");
 
-    sprite.setTextFont(2);
-    sprite.setTextColor(COLOR_TEXT, COLOR_BG);
-    sprite.setTextDatum(TL_DATUM);
+            setTextFont(2);
+            setTextColor(COLOR_TEXT, COLOR_BG);
+            setTextDatum(TL_DATUM);
 
-    int y = HEADER_HEIGHT + 20;
-    int x = MARGIN;
+            const char* labels[] = {"Battery", "Temperature", "LED Duty"};
+            int y = HEADER_HEIGHT + 6;
+            for (int i = 0; i < SERIES_COUNT; i++) {
+                drawString(labels[i], MARGIN, y);
+                drawRect(MARGIN - 1, y + 19, TELEMETRY_COLUMNS + 2, TELEMETRY_CHART_H + 2,
+                         COLOR_BORDER);
+                y += 82;
+            }
 
-    sprite.drawString("Lifetime Sessions:", x, y);
-    sprite.setTextColor(COLOR_GREEN, COLOR_BG);
-    char buf[32];
-    snprintf(buf, sizeof(buf), "%lu", sessions);
-    sprite.drawString(buf, TFT_WIDTH - MARGIN - sprite.textWidth(buf), y);
-    y += 30;
+            drawFooter("<", ">");
+            break;
+        }
+
+        case SCREEN_HISTORY:
+            drawHeader("HISTORY");
+            drawFooter("<", ">");
+            break;
 
-    sprite.setTextColor(COLOR_TEXT, COLOR_BG);
-    sprite.drawString("Total Minutes:", x, y);
-    sprite.setTextColor(COLOR_GREEN, COLOR_BG);
-    snprintf(buf, sizeof(buf), "%lu", minutes);
-    sprite.drawString(buf, TFT_WIDTH - MARGIN - sprite.textWidth(buf), y);
-    y += 30;
+        case CHROME_EMERGENCY:
+            fillScreen(COLOR_DANGER);
 
-    sprite.setTextColor(COLOR_TEXT, COLOR_BG);
-    sprite.drawString("Total Hours:", x, y);
-    sprite.setTextColor(COLOR_GREEN, COLOR_BG);
-    snprintf(buf, sizeof(buf), "%.1f", minutes / 60.0);
-    sprite.drawString(buf, TFT_WIDTH - MARGIN - sprite.textWidth(buf), y);
-    y += 30;
+            setTextFont(4);
+            setTextColor(COLOR_TEXT, COLOR_DANGER);
+            setTextDatum(MC_DATUM);
+            drawString("EMERGENCY", TFT_WIDTH/2, 80);
 
-    sprite.setTextColor(COLOR_TEXT, COLOR_BG);
-    sprite.drawString("Today's Sessions:", x, y);
-    uint16_t color = (dailySessions >= MAX_DAILY_SESSIONS) ? COLOR_ORANGE : COLOR_GREEN;
-    sprite.setTextColor(color, COLOR_BG);
-    snprintf(buf, sizeof(buf), "%d/%d", dailySessions, MAX_DAILY_SESSIONS);
-    sprite.drawString(buf, TFT_WIDTH - MARGIN - sprite.textWidth(buf), y);
-    y += 30;
+            setTextFont(2);
+            drawString("SHUTDOWN", TFT_WIDTH/2, 120);
 
-    // Estimated dose
-    sprite.setTextColor(COLOR_TEXT, COLOR_BG);
-    sprite.drawString("Est. Total Dose:", x, y);
-    sprite.setTextColor(COLOR_GREEN, COLOR_BG);
-    float joules = minutes * 60 * 0.005;  // 5mW/cm² * seconds
-    snprintf(buf, sizeof(buf), "%.0f J/cm2", joules);
-    sprite.drawString(buf, TFT_WIDTH - MARGIN - sprite.textWidth(buf), y);
+            setTextColor(COLOR_BG, COLOR_DANGER);
+            drawString("LEDs DISABLED", TFT_WIDTH/2, 240);
 
-    drawFooter("<", ">");
+            setTextColor(COLOR_TEXT, COLOR_DANGER);
+            drawString("Press a button", TFT_WIDTH/2, 290);
+            break;
 
-    update();
+        default:
+            break;
+    }
+}
+
+void Display::beginFrame(uint8_t chromeId) {
+    PROFILE_BEGIN(chromeId);
+    if (!replay) {
+        startImmediate();
+    }
+
+    if (chrome[chromeId]) {
+        int16_t top = stripNo * STRIP_LINES;
+        memcpy(draw->getPointer(), chrome[chromeId] + (size_t)top * ROW_BYTES,
+               (size_t)stripRows(top) * ROW_BYTES);
+    } else {
+        // No PSRAM cache: draw the chrome, but track it as one primitive
+        tracking = false;
+        draw->fillScreen(ink(COLOR_BG));
+        drawChrome(chromeId);
+        tracking = true;
+    }
+    PROFILE_MARK(PHASE_CHROME);
+    track(hashPrim(PRIM_CHROME, chromeId, 0, 0, 0, 0, 0), 0, 0, TFT_WIDTH, TFT_HEIGHT);
+}
+
+void Display::cacheChrome() {
+    #if DISPLAY_CHROME_CACHE
+    tracking = false;
+    for (uint8_t id = 0; id < CHROME_COUNT; id++) {
+        chrome[id] = (uint8_t*)ps_malloc(frameBytes);
+        if (chrome[id] == NULL) {
+            Serial.println("Chrome cache: out of PSRAM");
+            break;
+        }
+
+        // Strip by strip when the frame buffer is only a strip
+        for (uint8_t s = 0; s < STRIP_COUNT; s++) {
+            int16_t top = s * STRIP_LINES;
+            draw->setOffset(0, top);
+            draw->fillScreen(ink(COLOR_BG));
+            drawChrome(id);
+            memcpy(chrome[id] + (size_t)top * ROW_BYTES, draw->getPointer(),
+                   (size_t)stripRows(top) * ROW_BYTES);
+        }
+    }
+    draw->setOffset(0, 0);
+    tracking = true;
+    #endif
 }
 
 // =============================================================================
-// SCREEN: SETTINGS
+// SCREEN LAYOUTS
 // =============================================================================
 
-void Display::showSettings(TreatmentMode mode, int selectedIndex) {
-    clear();
+// Each screen is a static widget table over its cached chrome. A binding
+// reads one widget's value out of the view model; only widgets whose value
+// changed are repainted and pushed.
+
+// LED indicator pair box: two r=15 lamps 40 px apart, their glow and
+// their labels
+#define LEDS_GLOW   3                   // Largest glow ring (px)
+#define LEDS_W      (2 * (20 + 15 + LEDS_GLOW) + 1)
+#define LEDS_H      50
+#define LEDS_TOP    (15 + LEDS_GLOW)    // Lamp centres below the box top
+
+static const char* const modeNames[] = {"OFF", "RED", "NIR", "DUAL", "ALT"};
+
+static const ViewModel& viewOf(const void* view) {
+    return *(const ViewModel*)view;
+}
+
+static void setText(WidgetValue* value, uint16_t fg, uint16_t bg, const char* fmt, ...)
+    __attribute__((format(printf, 4, 5)));
+
+static void setText(WidgetValue* value, uint16_t fg, uint16_t bg, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(value->text, sizeof(value->text), fmt, args);
+    va_end(args);
+    value->fg = fg;
+    value->bg = bg;
+}
+
+static uint8_t ledFlags(bool redOn, bool nirOn) {
+    return (redOn ? 0x1 : 0) | (nirOn ? 0x2 : 0);
+}
+
+// Lamps that are really on (in a session) pulse
+#define LEDS_PULSE  0x4
 
-    drawHeader("SELECT MODE");
+// --- Home --------------------------------------------------------------------
+
+static void bindHomeBattery(const void* view, WidgetValue* value) {
+    value->level = viewOf(view).home.battPercent;
+}
+
+static void bindHomeMode(const void* view, WidgetValue* value) {
+    setText(value, COLOR_TEXT, COLOR_BG, "%s", modeNames[viewOf(view).home.mode]);
+}
 
-    const char* modeNames[] = {"RED ONLY", "NIR ONLY", "DUAL", "ALTERNATING"};
+static void bindHomeDesc(const void* view, WidgetValue* value) {
     const char* modeDesc[] = {
+        "Disabled",
+        "650nm Surface",
+        "850nm Deep",
+        "Full Spectrum",
+        "Alternating"
+    };
+    setText(value, COLOR_TEXT, COLOR_BG, "%s", modeDesc[viewOf(view).home.mode]);
+}
+
+static void bindHomeLeds(const void* view, WidgetValue* value) {
+    uint8_t mode = viewOf(view).home.mode;
+    value->flags = ledFlags(mode == MODE_RED_ONLY || mode == MODE_DUAL || mode == MODE_ALTERNATING,
+                            mode == MODE_NIR_ONLY || mode == MODE_DUAL || mode == MODE_ALTERNATING);
+}
+
+static void bindHomeVolts(const void* view, WidgetValue* value) {
+    setText(value, COLOR_TEXT, COLOR_HEADER, "%.2fV", viewOf(view).home.centiVolts / 100.0f);
+}
+
+static const Widget homeWidgets[] = {
+    {WIDGET_BATTERY, 0, 0,        TFT_WIDTH - 45, 8, 33, 14,                  bindHomeBattery},
+    {WIDGET_LABEL,   4, MC_DATUM, TFT_WIDTH/2, 100, 0, 0,                     bindHomeMode},
+    {WIDGET_LABEL,   2, MC_DATUM, TFT_WIDTH/2, 130, 0, 0,                     bindHomeDesc},
+    {WIDGET_LEDS,    0, 0,        TFT_WIDTH/2 - LEDS_W/2, 170 - LEDS_TOP, LEDS_W, LEDS_H, bindHomeLeds},
+    {WIDGET_LABEL,   2, MR_DATUM, TFT_WIDTH - MARGIN, TFT_HEIGHT - FOOTER_HEIGHT/2, 0, 0,
+                                                                             bindHomeVolts}
+};
+
+// --- Session -----------------------------------------------------------------
+
+static void bindSessionTitle(const void* view, WidgetValue* value) {
+    setText(value, COLOR_TEXT, COLOR_HEADER, "SESSION - %s", modeNames[viewOf(view).session.mode]);
+}
+
+static void bindSessionCountdown(const void* view, WidgetValue* value) {
+    const ViewModel& v = viewOf(view);
+    uint32_t remaining = (v.session.totalSec > v.session.elapsedSec)
+                         ? v.session.totalSec - v.session.elapsedSec : 0;
+    setText(value, COLOR_GREEN, COLOR_BG, "%lu:%02lu",
+            (unsigned long)remaining / 60, (unsigned long)remaining % 60);
+}
+
+static void bindSessionProgress(const void* view, WidgetValue* value) {
+    const ViewModel& v = viewOf(view);
+    uint32_t permille = v.session.totalSec ? v.session.elapsedSec * 1000UL / v.session.totalSec : 0;
+    value->level = (permille > 1000) ? 1000 : permille;
+    value->fg = COLOR_GREEN;
+}
+
+static void bindSessionElapsed(const void* view, WidgetValue* value) {
+    uint32_t elapsed = viewOf(view).session.elapsedSec;
+    setText(value, COLOR_TEXT, COLOR_BG, "Elapsed: %lu:%02lu",
+            (unsigned long)elapsed / 60, (unsigned long)elapsed % 60);
+}
+
+static void bindSessionLeds(const void* view, WidgetValue* value) {
+    value->flags = ledFlags(viewOf(view).session.redOn, viewOf(view).session.nirOn) | LEDS_PULSE;
+}
+
+static const Widget sessionWidgets[] = {
+    {WIDGET_LABEL,    2, MC_DATUM, TFT_WIDTH/2, HEADER_HEIGHT/2, 0, 0,       bindSessionTitle},
+    {WIDGET_VALUE,    7, MC_DATUM, TFT_WIDTH/2, 100, 0, 0,                   bindSessionCountdown},
+    {WIDGET_PROGRESS, 0, 0,        MARGIN, 165, TFT_WIDTH - 2*MARGIN, 20,    bindSessionProgress},
+    {WIDGET_LABEL,    2, MC_DATUM, TFT_WIDTH/2, 200, 0, 0,                   bindSessionElapsed},
+    {WIDGET_LEDS,     0, 0,        TFT_WIDTH/2 - LEDS_W/2, 240 - LEDS_TOP, LEDS_W, LEDS_H, bindSessionLeds}
+};
+
+// --- Stats -------------------------------------------------------------------
+
+static void bindStatsSessions(const void* view, WidgetValue* value) {
+    setText(value, COLOR_GREEN, COLOR_BG, "%lu", (unsigned long)viewOf(view).stats.sessions);
+}
+
+static void bindStatsMinutes(const void* view, WidgetValue* value) {
+    setText(value, COLOR_GREEN, COLOR_BG, "%lu", (unsigned long)viewOf(view).stats.minutes);
+}
+
+static void bindStatsHours(const void* view, WidgetValue* value) {
+    setText(value, COLOR_GREEN, COLOR_BG, "%.1f", viewOf(view).stats.minutes / 60.0);
+}
+
+static void bindStatsDaily(const void* view, WidgetValue* value) {
+    uint8_t daily = viewOf(view).stats.dailySessions;
+    uint16_t color = (daily >= MAX_DAILY_SESSIONS) ? COLOR_ORANGE : COLOR_GREEN;
+    setText(value, color, COLOR_BG, "%d/%d", daily, MAX_DAILY_SESSIONS);
+}
+
+static void bindStatsDose(const void* view, WidgetValue* value) {
+    float joules = viewOf(view).stats.minutes * 60 * 0.005;  // 5mW/cm² * seconds
+    setText(value, COLOR_GREEN, COLOR_BG, "%.0f J/cm2", joules);
+}
+
+// Values right-aligned against the cached labels, one row every 30 px
+#define STATS_ROW(i)    (HEADER_HEIGHT + 20 + 30 * (i))
+
+static const Widget statsWidgets[] = {
+    {WIDGET_VALUE, 2, TR_DATUM, TFT_WIDTH - MARGIN, STATS_ROW(0), 0, 0, bindStatsSessions},
+    {WIDGET_VALUE, 2, TR_DATUM, TFT_WIDTH - MARGIN, STATS_ROW(1), 0, 0, bindStatsMinutes},
+    {WIDGET_VALUE, 2, TR_DATUM, TFT_WIDTH - MARGIN, STATS_ROW(2), 0, 0, bindStatsHours},
+    {WIDGET_VALUE, 2, TR_DATUM, TFT_WIDTH - MARGIN, STATS_ROW(3), 0, 0, bindStatsDaily},
+    {WIDGET_LABEL, 2, TR_DATUM, TFT_WIDTH - MARGIN, STATS_ROW(4), 0, 0, bindStatsDose}
+};
+
+// --- Settings ----------------------------------------------------------------
+
+static void bindOption(const void* view, WidgetValue* value, uint8_t index) {
+    const char* optionNames[] = {"RED ONLY", "NIR ONLY", "DUAL", "ALTERNATING"};
+    const char* optionDesc[] = {
         "650nm - Surface treatment",
         "850nm - Deep follicles",
         "Both - Comprehensive",
         "30s alternating cycle"
     };
+    const ViewModel& v = viewOf(view);
 
-    int y = HEADER_HEIGHT + 20;
+    setText(value, COLOR_TEXT, COLOR_BG, "%s", optionNames[index]);
+    snprintf(value->detail, sizeof(value->detail), "%s", optionDesc[index]);
+    value->flags = ((v.settings.selectedIndex == index) ? 0x1 : 0) |
+                   ((v.settings.mode == index + 1) ? 0x2 : 0);  // Skip MODE_OFF
+}
 
-    for (int i = 0; i < 4; i++) {
-        TreatmentMode m = (TreatmentMode)(i + 1);  // Skip MODE_OFF
+static void bindOption0(const void* view, WidgetValue* value) { bindOption(view, value, 0); }
+static void bindOption1(const void* view, WidgetValue* value) { bindOption(view, value, 1); }
+static void bindOption2(const void* view, WidgetValue* value) { bindOption(view, value, 2); }
+static void bindOption3(const void* view, WidgetValue* value) { bindOption(view, value, 3); }
 
-        // Highlight selected
-        if (i == selectedIndex) {
-            sprite.fillRoundRect(MARGIN - 5, y - 5, TFT_WIDTH - 2*MARGIN + 10, 50, 5, 0x2104);
-        }
+// Full-width rows (descriptions can run past the highlight), 55 px apart
+#define OPTION_ROW(i)   (HEADER_HEIGHT + 15 + 55 * (i))
 
-        // Checkmark for current mode
-        if (m == mode) {
-            sprite.setTextColor(COLOR_GREEN, (i == selectedIndex) ? 0x2104 : COLOR_BG);
-            sprite.drawString("*", MARGIN, y + 10);
-        }
+static const Widget settingsWidgets[] = {
+    {WIDGET_OPTION, 2, TL_DATUM, 0, OPTION_ROW(0), TFT_WIDTH, 50, bindOption0},
+    {WIDGET_OPTION, 2, TL_DATUM, 0, OPTION_ROW(1), TFT_WIDTH, 50, bindOption1},
+    {WIDGET_OPTION, 2, TL_DATUM, 0, OPTION_ROW(2), TFT_WIDTH, 50, bindOption2},
+    {WIDGET_OPTION, 2, TL_DATUM, 0, OPTION_ROW(3), TFT_WIDTH, 50, bindOption3}
+};
+
+// --- Battery -----------------------------------------------------------------
+
+static uint16_t levelColor(uint8_t percent) {
+    return (percent > 50) ? COLOR_GREEN : (percent > 20) ? COLOR_YELLOW : COLOR_DANGER;
+}
+
+static void bindBatteryLevel(const void* view, WidgetValue* value) {
+    value->level = viewOf(view).battery.percent;
+    value->fg = levelColor(value->level);
+}
+
+static void bindBatteryPercent(const void* view, WidgetValue* value) {
+    setText(value, COLOR_TEXT, COLOR_BG, "%d%%", viewOf(view).battery.percent);
+}
+
+static void bindBatteryVolts(const void* view, WidgetValue* value) {
+    setText(value, COLOR_TEXT, COLOR_BG, "%.2f V", viewOf(view).battery.centiVolts / 100.0f);
+}
+
+static void bindBatteryStatus(const void* view, WidgetValue* value) {
+    const ViewModel& v = viewOf(view);
+    if (v.battery.charging) {
+        setText(value, COLOR_GREEN, COLOR_BG, "CHARGING");
+    } else if (v.battery.percent < 20) {
+        setText(value, COLOR_DANGER, COLOR_BG, "LOW BATTERY");
+    }
+}
 
-        sprite.setTextFont(2);
-        sprite.setTextColor(COLOR_TEXT, (i == selectedIndex) ? 0x2104 : COLOR_BG);
-        sprite.setTextDatum(TL_DATUM);
-        sprite.drawString(modeNames[i], MARGIN + 15, y);
+static const Widget batteryWidgets[] = {
+    // Inside the cached 60x100 outline at (TFT_WIDTH/2 - 30, 70)
+    {WIDGET_LEVEL, 0, 0,        TFT_WIDTH/2 - 25, 75, 50, 90, bindBatteryLevel},
+    {WIDGET_LABEL, 4, MC_DATUM, TFT_WIDTH/2, 200, 0, 0,       bindBatteryPercent},
+    {WIDGET_LABEL, 2, MC_DATUM, TFT_WIDTH/2, 230, 0, 0,       bindBatteryVolts},
+    {WIDGET_LABEL, 2, MC_DATUM, TFT_WIDTH/2, 260, 0, 0,       bindBatteryStatus}
+};
+
+// --- Safety ------------------------------------------------------------------
+
+static void bindSafetyVolts(const void* view, WidgetValue* value) {
+    const ViewModel& v = viewOf(view);
+    float voltage = v.safety.centiVolts / 100.0f;
+    uint16_t color = (v.safety.overVoltage || v.safety.underVoltage) ? COLOR_DANGER :
+                     (voltage < VBAT_LOW) ? COLOR_YELLOW : COLOR_GREEN;
+    setText(value, color, COLOR_BG, "%.2fV", voltage);
+}
+
+static void bindSafetyTemp(const void* view, WidgetValue* value) {
+    #if TEMP_ENABLED
+    const ViewModel& v = viewOf(view);
+    float temp = v.safety.deciDegrees / 10.0f;
+    uint16_t color = v.safety.thermal ? COLOR_DANGER :
+                     (temp > TEMP_WARNING_C) ? COLOR_YELLOW : COLOR_GREEN;
+    setText(value, color, COLOR_BG, "%.1fC", temp);
+    #else
+    (void)view;     // No sensor: nothing in the view to show
+    setText(value, COLOR_GRAY, COLOR_BG, "N/A");
+    #endif
+}
+
+static void bindSafetyStatus(const void* view, WidgetValue* value) {
+    const ViewModel& v = viewOf(view);
+    if (v.safety.overVoltage || v.safety.underVoltage || v.safety.thermal) {
+        setText(value, COLOR_DANGER, COLOR_BG, "ERROR");
+    } else {
+        setText(value, COLOR_GREEN, COLOR_BG, "ALL OK");
+    }
+}
+
+static const Widget safetyWidgets[] = {
+    {WIDGET_LABEL, 2, TR_DATUM, TFT_WIDTH - MARGIN, HEADER_HEIGHT + 20, 0, 0, bindSafetyVolts},
+    {WIDGET_LABEL, 2, TR_DATUM, TFT_WIDTH - MARGIN, HEADER_HEIGHT + 80, 0, 0, bindSafetyTemp},
+    {WIDGET_LABEL, 4, MC_DATUM, TFT_WIDTH/2, 240, 0, 0,                     bindSafetyStatus}
+};
+
+// --- Telemetry ---------------------------------------------------------------
+
+// Three panels 82 px apart: a label row, then a chart in a 1 px frame
+#define TELEM_PANEL(i)  (HEADER_HEIGHT + 6 + 82 * (i))
+#define TELEM_CHART(i)  (TELEM_PANEL(i) + 20)
+
+static const uint16_t seriesColor[SERIES_COUNT] = {COLOR_GREEN, COLOR_ORANGE, COLOR_RED};
+
+// A series value as text, with its unit or bare (range labels)
+static void formatSeries(char* out, size_t len, uint8_t series, int16_t v, bool unit) {
+    switch (series) {
+        case SERIES_VOLTS:
+            snprintf(out, len, unit ? "%.2fV" : "%.2f", v / 100.0f);
+            break;
+        case SERIES_TEMP:
+            snprintf(out, len, unit ? "%.1fC" : "%.1f", v / 10.0f);
+            break;
+        default:
+            snprintf(out, len, unit ? "%d%%" : "%d", v);
+            break;
+    }
+}
+
+static void bindTelemetryValue(const void* view, WidgetValue* value, uint8_t series) {
+    #if !TEMP_ENABLED
+    if (series == SERIES_TEMP) {
+        setText(value, COLOR_GRAY, COLOR_BG, "N/A");
+        return;
+    }
+    #endif
+    formatSeries(value->text, sizeof(value->text), series,
+                 viewOf(view).telemetry.latest[series], true);
+    value->fg = COLOR_TEXT;
+    value->bg = COLOR_BG;
+}
+
+static void bindTelemetryChart(const void* view, WidgetValue* value, uint8_t series) {
+    const ViewModel& v = viewOf(view);
+    value->data = v.telemetry.rows[series][0];
+    value->dataLen = sizeof(v.telemetry.rows[series]);
+    value->fg = seriesColor[series];
+    value->bg = COLOR_BG;
+    if (v.telemetry.hi[series] > v.telemetry.lo[series]) {
+        formatSeries(value->text, sizeof(value->text), series, v.telemetry.hi[series], false);
+        formatSeries(value->detail, sizeof(value->detail), series, v.telemetry.lo[series], false);
+    }
+}
 
-        sprite.setTextFont(1);
-        sprite.setTextColor(0x8410, (i == selectedIndex) ? 0x2104 : COLOR_BG);  // Gray
-        sprite.drawString(modeDesc[i], MARGIN + 15, y + 22);
+static void bindVoltsValue(const void* view, WidgetValue* value) { bindTelemetryValue(view, value, SERIES_VOLTS); }
+static void bindTempValue(const void* view, WidgetValue* value) { bindTelemetryValue(view, value, SERIES_TEMP); }
+static void bindDutyValue(const void* view, WidgetValue* value) { bindTelemetryValue(view, value, SERIES_DUTY); }
+static void bindVoltsChart(const void* view, WidgetValue* value) { bindTelemetryChart(view, value, SERIES_VOLTS); }
+static void bindTempChart(const void* view, WidgetValue* value) { bindTelemetryChart(view, value, SERIES_TEMP); }
+static void bindDutyChart(const void* view, WidgetValue* value) { bindTelemetryChart(view, value, SERIES_DUTY); }
 
-        y += 55;
+static void bindTelemetryWindow(const void* view, WidgetValue* value) {
+    setText(value, COLOR_TEXT, COLOR_HEADER, "%s",
+            viewOf(view).telemetry.lastHour ? "LAST HOUR" : "SESSION");
+}
+
+static const Widget telemetryWidgets[] = {
+    {WIDGET_LABEL, 2, TR_DATUM, TFT_WIDTH - MARGIN, TELEM_PANEL(0), 0, 0, bindVoltsValue},
+    {WIDGET_CHART, 1, 0, MARGIN, TELEM_CHART(0), TELEMETRY_COLUMNS, TELEMETRY_CHART_H,
+                                                                         bindVoltsChart},
+    {WIDGET_LABEL, 2, TR_DATUM, TFT_WIDTH - MARGIN, TELEM_PANEL(1), 0, 0, bindTempValue},
+    {WIDGET_CHART, 1, 0, MARGIN, TELEM_CHART(1), TELEMETRY_COLUMNS, TELEMETRY_CHART_H,
+                                                                         bindTempChart},
+    {WIDGET_LABEL, 2, TR_DATUM, TFT_WIDTH - MARGIN, TELEM_PANEL(2), 0, 0, bindDutyValue},
+    {WIDGET_CHART, 1, 0, MARGIN, TELEM_CHART(2), TELEMETRY_COLUMNS, TELEMETRY_CHART_H,
+                                                                         bindDutyChart},
+    {WIDGET_LABEL, 2, MC_DATUM, TFT_WIDTH/2, TFT_HEIGHT - FOOTER_HEIGHT/2, 0, 0,
+                                                                         bindTelemetryWindow}
+};
+
+// --- History -----------------------------------------------------------------
+
+// Two-line rows: number, mode and duration; then when, dose and how it ended
+static void bindHistoryRow(const void* view, WidgetValue* value, uint8_t row) {
+    const ViewModel& v = viewOf(view);
+    if (row >= v.history.count) {
+        if (row == 0) {
+            setText(value, COLOR_TEXT, COLOR_BG, "No sessions yet");
+        }
+        return;
     }
 
-    drawFooter("Back", "Select");
+    const HistoryRecord& r = v.history.records[row];
+    setText(value, COLOR_TEXT, COLOR_BG, "#%lu %s %u:%02u",
+            (unsigned long)(v.history.newest - row),
+            (r.mode < MODE_COUNT) ? modeNames[r.mode] : "?",
+            r.durationSec / 60, r.durationSec % 60);
+
+    // Narrow fields so the compiler can bound the text: at most 20 chars
+    char when[24];
+    if (r.flags & HISTORY_WALL_CLOCK) {
+        time_t start = r.start;
+        struct tm t;
+        localtime_r(&start, &t);
+        snprintf(when, sizeof(when), "%02u-%02u %02u:%02u",
+                 (uint8_t)(t.tm_mon + 1), (uint8_t)t.tm_mday, (uint8_t)t.tm_hour, (uint8_t)t.tm_min);
+    } else {
+        // No clock: boot number and time since boot
+        snprintf(when, sizeof(when), "B%u+%u:%02u", (uint16_t)r.boot,
+                 (unsigned)(r.start / 3600), (uint8_t)(r.start / 60 % 60));
+    }
+    // Dose as on the stats screen; a tenth only below 10 to leave room
+    snprintf(value->detail, sizeof(value->detail), "%s %.*fJ/cm2 %s",
+             when, (r.doseMilliJ < 10000) ? 1 : 0, r.doseMilliJ / 1000.0f,
+             history_end_name(r.end));
+}
 
-    update();
+static void bindHistory0(const void* view, WidgetValue* value) { bindHistoryRow(view, value, 0); }
+static void bindHistory1(const void* view, WidgetValue* value) { bindHistoryRow(view, value, 1); }
+static void bindHistory2(const void* view, WidgetValue* value) { bindHistoryRow(view, value, 2); }
+static void bindHistory3(const void* view, WidgetValue* value) { bindHistoryRow(view, value, 3); }
+static void bindHistory4(const void* view, WidgetValue* value) { bindHistoryRow(view, value, 4); }
+static void bindHistory5(const void* view, WidgetValue* value) { bindHistoryRow(view, value, 5); }
+
+static void bindHistoryPage(const void* view, WidgetValue* value) {
+    const ViewModel& v = viewOf(view);
+    setText(value, COLOR_TEXT, COLOR_HEADER, "%lu/%lu", (unsigned long)(v.history.screen + 1),
+            (unsigned long)history_screen_count(v.history.total));
 }
 
+// Rows drawn as unselected options, one every 41 px
+#define HISTORY_ROW(i)  (HEADER_HEIGHT + 4 + 41 * (i))
+
+static const Widget historyWidgets[] = {
+    {WIDGET_OPTION, 2, TL_DATUM, 0, HISTORY_ROW(0), TFT_WIDTH, 40, bindHistory0},
+    {WIDGET_OPTION, 2, TL_DATUM, 0, HISTORY_ROW(1), TFT_WIDTH, 40, bindHistory1},
+    {WIDGET_OPTION, 2, TL_DATUM, 0, HISTORY_ROW(2), TFT_WIDTH, 40, bindHistory2},
+    {WIDGET_OPTION, 2, TL_DATUM, 0, HISTORY_ROW(3), TFT_WIDTH, 40, bindHistory3},
+    {WIDGET_OPTION, 2, TL_DATUM, 0, HISTORY_ROW(4), TFT_WIDTH, 40, bindHistory4},
+    {WIDGET_OPTION, 2, TL_DATUM, 0, HISTORY_ROW(5), TFT_WIDTH, 40, bindHistory5},
+    {WIDGET_LABEL, 2, MC_DATUM, TFT_WIDTH/2, TFT_HEIGHT - FOOTER_HEIGHT/2, 0, 0, bindHistoryPage}
+};
+
+// --- All screens (indexed by Screen) ----------------------------------------
+
+#define LAYOUT(table)   {table, sizeof(table) / sizeof(table[0])}
+
+static const ScreenLayout layouts[SCREEN_COUNT] = {
+    LAYOUT(homeWidgets),
+    LAYOUT(sessionWidgets),
+    LAYOUT(statsWidgets),
+    LAYOUT(settingsWidgets),
+    LAYOUT(batteryWidgets),
+    LAYOUT(safetyWidgets),
+    LAYOUT(telemetryWidgets),
+    LAYOUT(historyWidgets)
+};
+
 // =============================================================================
-// SCREEN: BATTERY
+// RETAINED RENDERING
 // =============================================================================
 
-void Display::showBattery(float voltage, uint8_t percent, bool charging) {
-    clear();
-
-    drawHeader("BATTERY");
-
-    // Large battery icon
-    int iconX = TFT_WIDTH/2 - 30;
-    int iconY = 70;
-    int iconW = 60;
-    int iconH = 100;
-
-    // Battery outline
-    sprite.drawRoundRect(iconX, iconY, iconW, iconH, 5, COLOR_TEXT);
-    sprite.fillRect(iconX + 20, iconY - 8, 20, 10, COLOR_TEXT);  // Top nub
-
-    // Fill level
-    int fillH = (iconH - 10) * percent / 100;
-    uint16_t fillColor = (percent > 50) ? COLOR_GREEN :
-                         (percent > 20) ? COLOR_YELLOW : COLOR_DANGER;
-    sprite.fillRect(iconX + 5, iconY + iconH - 5 - fillH, iconW - 10, fillH, fillColor);
-
-    // Percentage
-    sprite.setTextFont(4);
-    sprite.setTextColor(COLOR_TEXT, COLOR_BG);
-    sprite.setTextDatum(MC_DATUM);
-    char buf[16];
-    snprintf(buf, sizeof(buf), "%d%%", percent);
-    sprite.drawString(buf, TFT_WIDTH/2, 200);
-
-    // Voltage
-    sprite.setTextFont(2);
-    snprintf(buf, sizeof(buf), "%.2f V", voltage);
-    sprite.drawString(buf, TFT_WIDTH/2, 230);
-
-    // Status
-    if (charging) {
-        sprite.setTextColor(COLOR_GREEN, COLOR_BG);
-        sprite.drawString("CHARGING", TFT_WIDTH/2, 260);
-    } else if (percent < 20) {
-        sprite.setTextColor(COLOR_DANGER, COLOR_BG);
-        sprite.drawString("LOW BATTERY", TFT_WIDTH/2, 260);
+// Bound levels reduced to the pixels they fill, so a change too small to
+// move a pixel does not count as a change
+static void levelToPixels(const Widget& w, WidgetValue* value) {
+    if (w.type == WIDGET_PROGRESS) {
+        value->level = (w.w - 4) * value->level / 1000;
+    } else if (w.type == WIDGET_LEVEL) {
+        value->level = w.h * value->level / 100;
     }
+}
 
-    drawFooter("<", ">");
+void Display::renderScreen(uint8_t chromeId, const ViewModel& view) {
+    const ScreenLayout& layout = layouts[chromeId];
+    uint8_t count = (layout.count < DISPLAY_MAX_WIDGETS) ? layout.count : DISPLAY_MAX_WIDGETS;
+    WidgetValue values[DISPLAY_MAX_WIDGETS];
+    uint32_t sigs[DISPLAY_MAX_WIDGETS];
+    DirtyRect bounds[DISPLAY_MAX_WIDGETS];
+
+    PROFILE_BEGIN(chromeId);
+    frameStart = micros();
+    uint32_t now = millis();
+    moving = false;
+
+    // Widgets do their own change detection: no primitive records, and an
+    // immediate-mode frame after this one starts from a full redraw
+    retained = true;
+    tracking = false;
+    recordCount = 0;
+    prevRecordCount = 0;
+    recordOverflow = false;
+
+    // Panel shows something else (another screen, an alert, a notice coming
+    // or going, nothing yet). Widget states are per slot, so neither
+    // buffer's widgets can be reused.
+    if (needsRedraw || shownChrome != chromeId) {
+        for (uint8_t i = 0; i < DISPLAY_MAX_WIDGETS; i++) {
+            widget_reset(&widgetState[i]);
+        }
+        bufferChrome[0] = CHROME_NONE;
+        bufferChrome[1] = CHROME_NONE;
+        if (shownChrome != chromeId) {
+            for (uint8_t i = 0; i < DISPLAY_MAX_WIDGETS; i++) {
+                tween_set(&tweens[i], 0);   // Fills sweep in from empty
+            }
+        }
 
-    update();
+        if (wipeDir != 0 && shownChrome < SCREEN_COUNT) {
+            // The panel holds another menu screen: wipe this one over it
+            wipeStart = now;
+            wipeRows = 0;
+        } else {
+            wipeDir = 0;
+            dirty_add_all(&dirty);
+        }
+        needsRedraw = false;
+        shownChrome = chromeId;
+    }
+
+    // Bind every widget up front: the dirty region is final before any
+    // pixels are drawn, whatever the number of strip passes
+    for (uint8_t i = 0; i < count; i++) {
+        memset(&values[i], 0, sizeof(WidgetValue));
+        layout.widgets[i].bind(&view, &values[i]);
+        levelToPixels(layout.widgets[i], &values[i]);
+        animate(layout.widgets[i], i, &values[i], now);
+        sigs[i] = widget_sig(&values[i]);
+        bounds[i] = widgetBounds(layout.widgets[i], values[i]);
+        if (layout.widgets[i].type == WIDGET_VALUE &&
+            showDigits(layout.widgets[i], i, values[i], sigs[i], bounds[i])) {
+            widgetState[i].shownSig = sigs[i];
+        } else {
+            widget_show(&widgetState[i], sigs[i], bounds[i], &dirty);
+        }
+        shownValue[i] = values[i];
+    }
+    if (wipeDir != 0) {
+        wipe(now);
+    }
+
+    FOR_EACH_STRIP {
+        uint8_t buf = (draw == &frameB) ? 1 : 0;
+
+        // A whole cached frame keeps its widgets between frames and is
+        // patched in place; strips and uncached chrome start over
+        bool keep = (STRIP_COUNT == 1) && chrome[chromeId];
+        if (!keep || bufferChrome[buf] != chromeId) {
+            if (chrome[chromeId]) {
+                int16_t top = stripNo * STRIP_LINES;
+                memcpy(draw->getPointer(), chrome[chromeId] + (size_t)top * ROW_BYTES,
+                       (size_t)stripRows(top) * ROW_BYTES);
+            } else {
+                draw->fillScreen(ink(COLOR_BG));
+                drawChrome(chromeId);
+            }
+            for (uint8_t i = 0; i < count; i++) {
+                widget_invalidate(&widgetState[i], buf);
+            }
+            bufferChrome[buf] = keep ? chromeId : CHROME_NONE;
+        }
+        PROFILE_MARK(PHASE_CHROME);
+
+        paintWidgets(layout.widgets, count, values, sigs, bounds, buf, chromeId);
+        if (notice) {
+            paintNotice(*notice);
+        }
+        update();
+    }
+    tracking = true;
+}
+
+void Display::animate(const Widget& w, uint8_t slot, WidgetValue* value, uint32_t now) {
+    if (w.type == WIDGET_PROGRESS) {
+        // The fill glides to each new length instead of jumping
+        tween_to(&tweens[slot], value->level, now, DISPLAY_TWEEN_MS, EASE_OUT);
+        value->level = tween_value(&tweens[slot], now);
+        moving |= tween_active(&tweens[slot], now);
+    } else if (w.type == WIDGET_LEDS && (value->flags & LEDS_PULSE) && (value->flags & 0x3)) {
+        value->level = (anim_pulse(now, DISPLAY_PULSE_MS) * LEDS_GLOW + ANIM_ONE / 2) >> 16;
+        moving = true;
+    }
+}
+
+void Display::wipe(uint32_t now) {
+    uint32_t f = anim_ease(EASE_OUT, anim_progress(wipeStart, DISPLAY_WIPE_MS, now));
+    int16_t rows = anim_lerp(0, TFT_HEIGHT, f);
+
+    // Push widget changes inside the rows already uncovered, plus the rows
+    // uncovered this frame; the old screen stays on the rest of the panel
+    DirtyRect shown = {0, (int16_t)((wipeDir > 0) ? 0 : TFT_HEIGHT - wipeRows),
+                       TFT_WIDTH, wipeRows};
+    DirtyRegion changed = dirty;
+    DirtyRect part;
+    dirty_clear(&dirty);
+    for (uint8_t i = 0; i < changed.count; i++) {
+        if (dirty_rect_clip(changed.rects[i], shown, &part)) {
+            dirty_add(&dirty, part.x, part.y, part.w, part.h);
+        }
+    }
+    int16_t top = (wipeDir > 0) ? wipeRows : TFT_HEIGHT - rows;
+    dirty_add(&dirty, 0, top, TFT_WIDTH, rows - wipeRows);
+
+    wipeRows = rows;
+    if (rows >= TFT_HEIGHT) {
+        wipeDir = 0;
+    } else {
+        moving = true;
+    }
+}
+
+bool Display::showDigits(const Widget& w, uint8_t slot, const WidgetValue& value,
+                         uint32_t sig, DirtyRect bounds) {
+    // Only the text changed, to a string of the same width: mark just the
+    // glyph cells that differ, as drawNumber's per-glyph tracking did
+    const WidgetValue& shown = shownValue[slot];
+    const WidgetState& state = widgetState[slot];
+    if (state.shownSig == 0 || state.shownSig == sig ||
+        memcmp(&state.shownBounds, &bounds, sizeof(bounds)) != 0 ||
+        shown.fg != value.fg || shown.bg != value.bg ||
+        strlen(shown.text) != strlen(value.text)) {
+        return false;
+    }
+
+    const GlyphAtlas& atlas = (w.font == bigDigits.font) ? bigDigits : smallDigits;
+    uint8_t oldIndex[GLYPH_MAX_TEXT];
+    uint8_t newIndex[GLYPH_MAX_TEXT];
+    int oldW, newW;
+    if (!lookupGlyphs(atlas, shown.text, oldIndex, &oldW) ||
+        !lookupGlyphs(atlas, value.text, newIndex, &newW) || oldW != newW) {
+        return false;
+    }
+
+    int oldX = w.x - ((w.datum % 3) * newW) / 2;
+    int newX = oldX;
+    int gy = w.y - ((w.datum / 3) * atlas.height) / 2;
+    for (size_t i = 0; value.text[i]; i++) {
+        uint8_t og = oldIndex[i];
+        uint8_t ng = newIndex[i];
+        if (og != ng || oldX != newX) {
+            dirty_add(&dirty, oldX, gy, atlas.width[og], atlas.height);
+            dirty_add(&dirty, newX, gy, atlas.width[ng], atlas.height);
+        }
+        oldX += atlas.width[og];
+        newX += atlas.width[ng];
+    }
+    return true;
+}
+
+void Display::paintWidgets(const Widget* widgets, uint8_t count, const WidgetValue* values,
+                           const uint32_t* sigs, const DirtyRect* bounds,
+                           uint8_t buf, uint8_t chromeId) {
+    bool repaint[DISPLAY_MAX_WIDGETS];
+    for (uint8_t i = 0; i < count; i++) {
+        repaint[i] = widget_stale(&widgetState[i], buf, sigs[i]);
+    }
+
+    // Put the chrome back under stale widgets. Neighbours the erased or
+    // newly covered pixels overlap are repainted too, in table order.
+    for (uint8_t i = 0; i < count; i++) {
+        if (repaint[i]) {
+            restoreChrome(chromeId, widgetState[i].bounds[buf]);
+        }
+    }
+    bool grew = true;
+    while (grew) {
+        grew = false;
+        for (uint8_t i = 0; i < count; i++) {
+            if (!repaint[i]) {
+                continue;
+            }
+            for (uint8_t j = 0; j < count; j++) {
+                if (!repaint[j] &&
+                    (dirty_rect_intersects(widgetState[i].bounds[buf], widgetState[j].bounds[buf]) ||
+                     dirty_rect_intersects(bounds[i], widgetState[j].bounds[buf]))) {
+                    repaint[j] = true;
+                    grew = true;
+                }
+            }
+        }
+    }
+
+    int16_t top = stripNo * STRIP_LINES;
+    DirtyRect strip = {0, top, TFT_WIDTH, stripRows(top)};
+    for (uint8_t i = 0; i < count; i++) {
+        if (repaint[i] && dirty_rect_intersects(bounds[i], strip)) {
+            paintWidget(widgets[i], values[i]);
+        }
+        if (repaint[i]) {
+            widget_painted(&widgetState[i], buf, sigs[i], bounds[i]);
+        }
+    }
+}
+
+void Display::paintWidget(const Widget& w, const WidgetValue& value) {
+    switch (w.type) {
+        case WIDGET_LABEL:
+            setTextFont(w.font);
+            setTextColor(value.fg, value.bg);
+            setTextDatum(w.datum);
+            drawString(value.text, w.x, w.y);
+            break;
+
+        case WIDGET_VALUE:
+            setTextFont(w.font);
+            setTextColor(value.fg, value.bg);
+            setTextDatum(w.datum);
+            drawNumber((w.font == bigDigits.font) ? bigDigits : smallDigits, value.text, w.x, w.y);
+            break;
+
+        case WIDGET_PROGRESS:
+            // Mid-pixel fraction so the bar truncates back to the same fill
+            drawProgressBar(w.x, w.y, w.w, w.h, (value.level + 0.5f) / (w.w - 4), value.fg);
+            break;
+
+        case WIDGET_LEVEL:
+            fillRect(w.x, w.y + w.h - value.level, w.w, value.level, value.fg);
+            break;
+
+        case WIDGET_BATTERY:
+            drawBatteryIcon(w.x, w.y, value.level, value.flags & 0x1);
+            break;
+
+        case WIDGET_LEDS:
+            drawLEDIndicator(w.x + w.w/2, w.y + LEDS_TOP, value.flags & 0x1, value.flags & 0x2,
+                             value.level);
+            break;
+
+        case WIDGET_OPTION: {
+            // Highlight box, check mark for the current mode, name and detail
+            bool selected = value.flags & 0x1;
+            uint16_t bg = selected ? COLOR_PANEL : COLOR_BG;
+            int y = w.y + 5;
+            if (selected) {
+                fillRoundRect(MARGIN - 5, w.y, TFT_WIDTH - 2*MARGIN + 10, w.h, 5, COLOR_PANEL);
+            }
+            if (value.flags & 0x2) {
+                setTextFont(2);
+                setTextDatum(MC_DATUM);
+                setTextColor(COLOR_GREEN, bg);
+                drawString("*", MARGIN, y + 10);
+            }
+
+            setTextFont(w.font);
+            setTextColor(COLOR_TEXT, bg);
+            setTextDatum(TL_DATUM);
+            drawString(value.text, MARGIN + 15, y);
+
+            setTextFont(1);
+            setTextColor(COLOR_GRAY, bg);
+            drawString(value.detail, MARGIN + 15, y + 22);
+            break;
+        }
+
+        case WIDGET_CHART: {
+            // Each column a vertical run over the rows its min/max covers
+            for (int16_t i = 0; i < w.w && 2*i + 1 < value.dataLen; i++) {
+                uint8_t top = value.data[2*i];
+                uint8_t bottom = value.data[2*i + 1];
+                if (top != TELEMETRY_EMPTY) {
+                    fillRect(w.x + i, w.y + top, 1, bottom - top + 1, value.fg);
+                }
+            }
+
+            // Range labels in the top and bottom left corners
+            setTextFont(w.font);
+            setTextColor(COLOR_GRAY, value.bg);
+            setTextDatum(TL_DATUM);
+            drawString(value.text, w.x + 2, w.y + 2);
+            setTextDatum(BL_DATUM);
+            drawString(value.detail, w.x + 2, w.y + w.h - 1);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+DirtyRect Display::widgetBounds(const Widget& w, const WidgetValue& value) {
+    switch (w.type) {
+        case WIDGET_LABEL:
+            return widget_text_bounds(w.x, w.y, draw->textWidth(value.text, w.font),
+                                      draw->fontHeight(w.font), w.datum);
+
+        case WIDGET_VALUE: {
+            const GlyphAtlas& atlas = (w.font == bigDigits.font) ? bigDigits : smallDigits;
+            return widget_text_bounds(w.x, w.y, numberWidth(atlas, value.text),
+                                      draw->fontHeight(w.font), w.datum);
+        }
+
+        case WIDGET_LEVEL: {
+            // Just the filled part: a level change touches the difference
+            DirtyRect r = {w.x, (int16_t)(w.y + w.h - value.level), w.w, value.level};
+            return r;
+        }
+
+        default: {
+            DirtyRect r = {w.x, w.y, w.w, w.h};
+            return r;
+        }
+    }
+}
+
+void Display::restoreChrome(uint8_t chromeId, DirtyRect r) {
+    // Whole frames only: strip passes restore their full slice instead
+    if (chrome[chromeId] == NULL || r.w <= 0 || r.h <= 0) {
+        return;
+    }
+
+    // Clip to the screen and widen to whole bytes (pixel pairs at 4 bpp)
+    int x0 = (r.x < 0) ? 0 : r.x;
+    int y0 = (r.y < 0) ? 0 : r.y;
+    int x1 = (r.x + r.w > TFT_WIDTH) ? TFT_WIDTH : r.x + r.w;
+    int y1 = (r.y + r.h > TFT_HEIGHT) ? TFT_HEIGHT : r.y + r.h;
+    #if DISPLAY_COLOR_DEPTH == 4
+    x0 &= ~1;
+    x1 = (x1 + 1) & ~1;
+    #endif
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    size_t offset = (size_t)x0 * DISPLAY_COLOR_DEPTH / 8;
+    size_t len = (size_t)(x1 - x0) * DISPLAY_COLOR_DEPTH / 8;
+    uint8_t* dst = (uint8_t*)draw->getPointer();
+    for (int y = y0; y < y1; y++) {
+        memcpy(dst + (size_t)y * ROW_BYTES + offset,
+               chrome[chromeId] + (size_t)y * ROW_BYTES + offset, len);
+    }
 }
 
 // =============================================================================
-// SCREEN: SAFETY
+// SCREEN RENDERERS
 // =============================================================================
 
+void buildTelemetryView(ViewModel& view, const TelemetryTrace& trace,
+                        const TelemetrySample& latest, bool lastHour) {
+    // Voltage and temperature autoscale (at least 0.2 V and 2 C high),
+    // duty always spans 0-100 %
+    static const int16_t minSpan[SERIES_COUNT] = {20, 20, 0};
+
+    view.screen = SCREEN_TELEMETRY;
+    view.telemetry.lastHour = lastHour;
+    for (uint8_t s = 0; s < SERIES_COUNT; s++) {
+        int16_t lo = 0;
+        int16_t hi = 100;
+        #if !TEMP_ENABLED
+        if (s == SERIES_TEMP) {
+            hi = 0;     // No sensor: empty chart
+        }
+        #endif
+        if (s != SERIES_DUTY && hi > lo) {
+            telemetry_trace_range(&trace, s, minSpan[s], &lo, &hi);
+        }
+        view.telemetry.latest[s] = latest.value[s];
+        view.telemetry.lo[s] = lo;
+        view.telemetry.hi[s] = hi;
+        telemetry_trace_plot(&trace, s, lo, hi, TELEMETRY_CHART_H, view.telemetry.rows[s]);
+    }
+}
+
+void buildHistoryView(ViewModel& view, const HistoryPage& page, uint32_t total,
+                      uint32_t screen) {
+    view.screen = SCREEN_HISTORY;
+    view.history.total = total;
+    view.history.screen = screen;
+    view.history.newest = page.page * HISTORY_PAGE_RECORDS + page.count;
+    view.history.count = page.count;
+    for (uint8_t i = 0; i < page.count; i++) {
+        view.history.records[i] = page.records[page.count - 1 - i];
+    }
+}
+
+// Direct entry points: build the view the screen's widgets bind to
+
+void Display::showHome(float voltage, uint8_t battPercent, TreatmentMode mode) {
+    ViewModel view;
+    memset(&view, 0, sizeof(view));
+    view.screen = SCREEN_HOME;
+    view.home.centiVolts = (uint16_t)lroundf(voltage * 100.0f);
+    view.home.battPercent = battPercent;
+    view.home.mode = mode;
+    render(view);
+}
+
+void Display::showSession(unsigned long elapsedSec, unsigned long totalSec,
+                          TreatmentMode mode, bool redOn, bool nirOn) {
+    ViewModel view;
+    memset(&view, 0, sizeof(view));
+    view.screen = SCREEN_SESSION;
+    view.session.elapsedSec = elapsedSec;
+    view.session.totalSec = totalSec;
+    view.session.mode = mode;
+    view.session.redOn = redOn;
+    view.session.nirOn = nirOn;
+    render(view);
+}
+
+void Display::showStats(uint32_t sessions, uint32_t minutes, uint8_t dailySessions) {
+    ViewModel view;
+    memset(&view, 0, sizeof(view));
+    view.screen = SCREEN_STATS;
+    view.stats.sessions = sessions;
+    view.stats.minutes = minutes;
+    view.stats.dailySessions = dailySessions;
+    render(view);
+}
+
+void Display::showSettings(TreatmentMode mode, int selectedIndex) {
+    ViewModel view;
+    memset(&view, 0, sizeof(view));
+    view.screen = SCREEN_SETTINGS;
+    view.settings.mode = mode;
+    view.settings.selectedIndex = selectedIndex;
+    render(view);
+}
+
+void Display::showBattery(float voltage, uint8_t percent, bool charging) {
+    ViewModel view;
+    memset(&view, 0, sizeof(view));
+    view.screen = SCREEN_BATTERY;
+    view.battery.centiVolts = (uint16_t)lroundf(voltage * 100.0f);
+    view.battery.percent = percent;
+    view.battery.charging = charging;
+    render(view);
+}
+
 void Display::showSafety(float voltage, float temp, bool overVoltage,
                          bool underVoltage, bool thermal) {
-    clear();
-
-    drawHeader("SAFETY STATUS");
-
-    sprite.setTextFont(2);
-    sprite.setTextDatum(TL_DATUM);
-
-    int y = HEADER_HEIGHT + 20;
-    int x = MARGIN;
-
-    // Voltage status
-    sprite.setTextColor(COLOR_TEXT, COLOR_BG);
-    sprite.drawString("Voltage:", x, y);
-    char buf[32];
-    snprintf(buf, sizeof(buf), "%.2fV", voltage);
-    uint16_t vColor = overVoltage ? COLOR_DANGER :
-                      underVoltage ? COLOR_DANGER :
-                      (voltage < VBAT_LOW) ? COLOR_YELLOW : COLOR_GREEN;
-    sprite.setTextColor(vColor, COLOR_BG);
-    sprite.drawString(buf, TFT_WIDTH - MARGIN - sprite.textWidth(buf), y);
-    y += 25;
-
-    // Voltage range
-    sprite.setTextColor(0x8410, COLOR_BG);
-    sprite.drawString("Safe: 6.2V - 8.6V", x, y);
-    y += 35;
-
-    // Temperature status
-    sprite.setTextColor(COLOR_TEXT, COLOR_BG);
-    sprite.drawString("Temperature:", x, y);
-    #if TEMP_ENABLED
-    snprintf(buf, sizeof(buf), "%.1fC", temp);
-    uint16_t tColor = thermal ? COLOR_DANGER :
-                      (temp > TEMP_WARNING_C) ? COLOR_YELLOW : COLOR_GREEN;
-    #else
-    snprintf(buf, sizeof(buf), "N/A");
-    uint16_t tColor = 0x8410;
-    #endif
-    sprite.setTextColor(tColor, COLOR_BG);
-    sprite.drawString(buf, TFT_WIDTH - MARGIN - sprite.textWidth(buf), y);
-    y += 25;
-
-    sprite.setTextColor(0x8410, COLOR_BG);
-    sprite.drawString("Max: 45C", x, y);
-    y += 35;
-
-    // Overall status
-    sprite.setTextFont(4);
-    sprite.setTextDatum(MC_DATUM);
-    if (overVoltage || underVoltage || thermal) {
-        sprite.setTextColor(COLOR_DANGER, COLOR_BG);
-        sprite.drawString("ERROR", TFT_WIDTH/2, 240);
+    ViewModel view;
+    memset(&view, 0, sizeof(view));
+    view.screen = SCREEN_SAFETY;
+    view.safety.centiVolts = (uint16_t)lroundf(voltage * 100.0f);
+    view.safety.deciDegrees = (int16_t)lroundf(temp * 10.0f);
+    view.safety.overVoltage = overVoltage;
+    view.safety.underVoltage = underVoltage;
+    view.safety.thermal = thermal;
+    render(view);
+}
+
+// =============================================================================
+// ALERTS
+// =============================================================================
+
+void Display::showTelemetry(const TelemetryTrace& trace, const TelemetrySample& latest,
+                            bool lastHour) {
+    ViewModel view;
+    memset(&view, 0, sizeof(view));
+    buildTelemetryView(view, trace, latest, lastHour);
+    render(view);
+}
+
+void Display::showHistory(const HistoryPage& page, uint32_t total, uint32_t screen) {
+    ViewModel view;
+    memset(&view, 0, sizeof(view));
+    buildHistoryView(view, page, total, screen);
+    render(view);
+}
+
+void Display::notify(uint8_t level, const char* title, const char* text,
+                     uint16_t color, uint32_t durationMs) {
+    notice_post(&notices, level, title, text, color, durationMs);
+}
+
+bool Display::acknowledgeNotice() {
+    return notice_acknowledge(&notices);
+}
+
+void Display::paintNotice(const Notice& n) {
+    setTextFont(2);
+    setTextDatum(MC_DATUM);
+
+    if (n.level == NOTICE_CRITICAL) {
+        // Alert box mid-screen
+        int boxY = TFT_HEIGHT/2 - 60;
+        fillRoundRect(10, boxY, TFT_WIDTH - 20, 120, 10, COLOR_PANEL);
+        drawRoundRect(10, boxY, TFT_WIDTH - 20, 120, 10, n.color);
+
+        setTextColor(n.color, COLOR_PANEL);
+        drawString(n.title, TFT_WIDTH/2, boxY + 30);
+        setTextColor(COLOR_TEXT, COLOR_PANEL);
+        drawString(n.text, TFT_WIDTH/2, boxY + 70);
     } else {
-        sprite.setTextColor(COLOR_GREEN, COLOR_BG);
-        sprite.drawString("ALL OK", TFT_WIDTH/2, 240);
+        // Toast just above the footer
+        int boxY = TFT_HEIGHT - FOOTER_HEIGHT - 50;
+        fillRoundRect(6, boxY, TFT_WIDTH - 12, 46, 6, COLOR_PANEL);
+        drawRoundRect(6, boxY, TFT_WIDTH - 12, 46, 6, n.color);
+
+        setTextColor(n.color, COLOR_PANEL);
+        drawString(n.title, TFT_WIDTH/2, boxY + 13);
+        setTextColor(COLOR_TEXT, COLOR_PANEL);
+        drawString(n.text, TFT_WIDTH/2, boxY + 32);
     }
+}
+
+void Display::showSplash(const char* message) {
+    viewValid = false;
+
+    FOR_EACH_STRIP {
+        PROFILE_BEGIN(PROFILE_ALERT);
+        clear();
+        PROFILE_MARK(PHASE_CHROME);
+
+        drawAsset(assetLogo, (TFT_WIDTH - assetLogo.width) / 2, 80);
 
-    drawFooter("<", ">");
+        setTextFont(4);
+        setTextColor(COLOR_TEXT, COLOR_BG);
+        setTextDatum(MC_DATUM);
+        drawString("FOLICULATOR", TFT_WIDTH/2, 190);
 
-    update();
+        setTextFont(2);
+        setTextColor(COLOR_GRAY, COLOR_BG);
+        drawString(message, TFT_WIDTH/2, 225);
+
+        update();
+    }
+    waitFrame();
+}
+
+void Display::showEmergency(const char* reason) {
+    viewValid = false;
+
+    FOR_EACH_STRIP {
+        // Cached at boot: the whole layout is one blit plus the reason line
+        beginFrame(CHROME_EMERGENCY);
+
+        setTextFont(2);
+        setTextColor(COLOR_BG, COLOR_DANGER);
+        setTextDatum(MC_DATUM);
+        drawString(reason, TFT_WIDTH/2, 180);
+
+        update();
+    }
+    waitFrame();
 }
 
 // =============================================================================
-// ALERTS
+// RENDER PROFILE
 // =============================================================================
 
-void Display::showAlert(const char* title, const char* message, uint16_t color) {
-    clear();
+#if DISPLAY_PROFILE
+
+static const char* profileNames[] = {
+    "HOME", "SESSION", "STATS", "SETTINGS", "BATTERY", "SAFETY", "TELEMETRY", "HISTORY",
+    "EMERGENCY", "ALERT"
+};
+static_assert(sizeof(profileNames) / sizeof(profileNames[0]) == SCREEN_COUNT + 2,
+              "one profile name per screen, then EMERGENCY and ALERT");
 
-    // Alert box
-    int boxY = TFT_HEIGHT/2 - 60;
-    sprite.fillRoundRect(10, boxY, TFT_WIDTH - 20, 120, 10, 0x2104);
-    sprite.drawRoundRect(10, boxY, TFT_WIDTH - 20, 120, 10, color);
+static const char* phaseNames[PHASE_COUNT] = {"chrome", "draw", "push", "total"};
 
-    // Title
-    sprite.setTextFont(2);
-    sprite.setTextColor(color, 0x2104);
-    sprite.setTextDatum(MC_DATUM);
-    sprite.drawString(title, TFT_WIDTH/2, boxY + 30);
+static uint32_t cyclesToMicros(uint32_t cycles) {
+    return cycles / ESP.getCpuFreqMHz();
+}
+
+void Display::profileBegin(uint8_t slot) {
+    if (replay) {
+        return;     // Later strip of a frame already being timed
+    }
+    profileSlot = slot;
+    profileStart = ESP.getCycleCount();
+    profileLast = profileStart;
+}
 
-    // Message
-    sprite.setTextColor(COLOR_TEXT, 0x2104);
-    sprite.drawString(message, TFT_WIDTH/2, boxY + 70);
+void Display::profileMark(uint8_t phase) {
+    if (profileSlot == PROFILE_NONE || replay) {
+        return;     // Frame not being timed (diagnostics screen), or a replay
+    }
+    uint32_t now = ESP.getCycleCount();
+    perf_record(&profile[profileSlot][phase], now - profileLast);
+    profileLast = now;
+}
 
-    update();
+void Display::profileEnd() {
+    if (profileSlot == PROFILE_NONE) {
+        return;
+    }
+    profileMark(PHASE_PUSH);
+    perf_record(&profile[profileSlot][PHASE_TOTAL], profileLast - profileStart);
+    profileSlot = PROFILE_NONE;
 }
 
-void Display::showEmergency(const char* reason) {
-    clear();
+void Display::resetProfile() {
+    for (uint8_t s = 0; s < PROFILE_SLOTS; s++) {
+        for (uint8_t p = 0; p < PHASE_COUNT; p++) {
+            perf_init(&profile[s][p]);
+        }
+    }
+}
+
+void Display::dumpProfile() {
+    Serial.printf("Render profile (us, %lu MHz)\n", (unsigned long)ESP.getCpuFreqMHz());
+    Serial.printf("%-10s %-7s %7s %7s %7s %7s %7s\n",
+                  "screen", "phase", "frames", "min", "avg", "max", "p99");
+
+    for (uint8_t s = 0; s < PROFILE_SLOTS; s++) {
+        if (profile[s][PHASE_TOTAL].count == 0) {
+            continue;
+        }
+        for (uint8_t p = 0; p < PHASE_COUNT; p++) {
+            const PerfHist* h = &profile[s][p];
+            Serial.printf("%-10s %-7s %7lu %7lu %7lu %7lu %7lu\n",
+                          (p == 0) ? profileNames[s] : "", phaseNames[p],
+                          (unsigned long)h->count,
+                          (unsigned long)cyclesToMicros(perf_min(h)),
+                          (unsigned long)cyclesToMicros(perf_avg(h)),
+                          (unsigned long)cyclesToMicros(perf_max(h)),
+                          (unsigned long)cyclesToMicros(perf_percentile(h, 99)));
+        }
+    }
+}
+
+void Display::showDiagnostics() {
+    viewValid = false;      // Hidden screen: repaint whatever comes next
+
+    FOR_EACH_STRIP {
+        clear();
+
+        fillRect(0, 0, TFT_WIDTH, HEADER_HEIGHT, COLOR_HEADER);
+        drawHeaderTitle("RENDER PROFILE");
+
+        // Two lines per screen: frames and p99/max of the whole frame, then
+        // the average split chrome / draw / push (all in microseconds)
+        setTextFont(1);
+        setTextDatum(TL_DATUM);
+
+        int y = HEADER_HEIGHT + 6;
+        char line[40];
+        for (uint8_t s = 0; s < PROFILE_SLOTS; s++) {
+            const PerfHist* total = &profile[s][PHASE_TOTAL];
+            if (total->count == 0) {
+                continue;
+            }
+
+            setTextColor(COLOR_TEXT, COLOR_BG);
+            snprintf(line, sizeof(line), "%-9s %5lu p99 %lu", profileNames[s],
+                     (unsigned long)total->count,
+                     (unsigned long)cyclesToMicros(perf_percentile(total, 99)));
+            drawString(line, MARGIN / 2, y);
+
+            setTextColor(COLOR_GRAY, COLOR_BG);
+            snprintf(line, sizeof(line), " c%lu d%lu p%lu max%lu",
+                     (unsigned long)cyclesToMicros(perf_avg(&profile[s][PHASE_CHROME])),
+                     (unsigned long)cyclesToMicros(perf_avg(&profile[s][PHASE_DRAW])),
+                     (unsigned long)cyclesToMicros(perf_avg(&profile[s][PHASE_PUSH])),
+                     (unsigned long)cyclesToMicros(perf_max(total)));
+            drawString(line, MARGIN / 2, y + 10);
+            y += 26;
+        }
+
+        drawFooter("Back", "");
+        update();
+    }
+}
+
+#endif // DISPLAY_PROFILE
+
+// =============================================================================
+// GLYPH ATLAS
+// =============================================================================
+
+static const char glyphChars[GLYPH_COUNT + 1] = "0123456789:./";
+
+void Display::buildAtlas(GlyphAtlas& atlas, uint8_t font) {
+    // Rasterize each glyph once into a 1 bpp scratch cell (taller than a
+    // strip for font 7) whose buffer already has the drawBitmap layout
+    FrameCanvas cell(&tft);
+    atlas.font = font;
+    atlas.height = draw->fontHeight(font);
+
+    for (uint8_t i = 0; i < GLYPH_COUNT; i++) {
+        char str[2] = {glyphChars[i], 0};
+        atlas.width[i] = draw->textWidth(str, font);
+
+        if (atlas.width[i] == 0) {
+            continue;  // Not in this font (font 7 has no '/')
+        }
 
-    sprite.fillScreen(COLOR_DANGER);
+        size_t bytes = (size_t)(atlas.width[i] + 7) / 8 * atlas.height;
+        atlas.bits[i] = (uint8_t*)ps_malloc(bytes);
+        if (atlas.bits[i] == NULL ||
+            !cell.create(atlas.width[i], atlas.height, 1, NULL, true)) {
+            Serial.printf("Glyph atlas: font %d unavailable\n", font);
+            free(atlas.bits[i]);
+            atlas.bits[i] = NULL;
+            return;
+        }
 
-    sprite.setTextFont(4);
-    sprite.setTextColor(COLOR_TEXT, COLOR_DANGER);
-    sprite.setTextDatum(MC_DATUM);
-    sprite.drawString("EMERGENCY", TFT_WIDTH/2, 80);
+        cell.fillScreen(0);
+        cell.setTextFont(font);
+        cell.setTextColor(1, 0);
+        cell.setTextDatum(TL_DATUM);
+        cell.drawString(str, 0, 0);
+        memcpy(atlas.bits[i], cell.getPointer(), bytes);
+        cell.destroy();
+    }
+}
 
-    sprite.setTextFont(2);
-    sprite.drawString("SHUTDOWN", TFT_WIDTH/2, 120);
+bool Display::lookupGlyphs(const GlyphAtlas& atlas, const char* text,
+                           uint8_t* index, int* width) {
+    size_t len = strlen(text);
+    *width = 0;
+    for (size_t i = 0; i < len; i++) {
+        const char* pos = (i < GLYPH_MAX_TEXT) ? strchr(glyphChars, text[i]) : NULL;
+        if (pos == NULL || text[i] == 0 || atlas.bits[pos - glyphChars] == NULL) {
+            return false;
+        }
+        index[i] = pos - glyphChars;
+        *width += atlas.width[index[i]];
+    }
+    return true;
+}
 
-    sprite.setTextFont(2);
-    sprite.setTextColor(COLOR_BG, COLOR_DANGER);
-    sprite.drawString(reason, TFT_WIDTH/2, 180);
+int Display::numberWidth(const GlyphAtlas& atlas, const char* text) {
+    uint8_t index[GLYPH_MAX_TEXT];
+    int w;
+    return lookupGlyphs(atlas, text, index, &w) ? w : draw->textWidth(text, atlas.font);
+}
 
-    sprite.drawString("LEDs DISABLED", TFT_WIDTH/2, 240);
+void Display::drawNumber(const GlyphAtlas& atlas, const char* text, int x, int y) {
+    // Look up every glyph first; anything outside the atlas uses the font
+    uint8_t index[GLYPH_MAX_TEXT];
+    size_t len = strlen(text);
+    int w;
+    if (!lookupGlyphs(atlas, text, index, &w)) {
+        setTextFont(atlas.font);
+        drawString(text, x, y);
+        return;
+    }
 
-    update();
+    // Same placement as drawString for the current datum
+    int gx = x - ((textDatum % 3) * w) / 2;
+    int gy = y - ((textDatum / 3) * atlas.height) / 2;
+
+    for (size_t i = 0; i < len; i++) {
+        uint8_t g = index[i];
+        draw->drawBitmap(gx, gy, atlas.bits[g], atlas.width[g], atlas.height,
+                         ink(textFg), ink(textBg));
+        track(hashPrim(PRIM_GLYPH, gx, gy, atlas.font, g, textBg, textFg),
+              gx, gy, atlas.width[g], atlas.height);
+        gx += atlas.width[g];
+    }
 }
 
 // =============================================================================
@@ -461,80 +2081,240 @@ void Display::showEmergency(const char* reason) {
 // =============================================================================
 
 void Display::drawHeader(const char* title) {
-    sprite.fillRect(0, 0, TFT_WIDTH, HEADER_HEIGHT, 0x1082);  // Dark blue-gray
-    sprite.setTextFont(2);
-    sprite.setTextColor(COLOR_TEXT, 0x1082);
-    sprite.setTextDatum(MC_DATUM);
-    sprite.drawString(title, TFT_WIDTH/2, HEADER_HEIGHT/2);
+    fillRect(0, 0, TFT_WIDTH, HEADER_HEIGHT, COLOR_HEADER);
+    drawHeaderTitle(title);
+}
+
+void Display::drawHeaderTitle(const char* title) {
+    setTextFont(2);
+    setTextColor(COLOR_TEXT, COLOR_HEADER);
+    setTextDatum(MC_DATUM);
+    drawString(title, TFT_WIDTH/2, HEADER_HEIGHT/2);
 }
 
 void Display::drawFooter(const char* left, const char* right) {
     int y = TFT_HEIGHT - FOOTER_HEIGHT;
-    sprite.fillRect(0, y, TFT_WIDTH, FOOTER_HEIGHT, 0x1082);
+    fillRect(0, y, TFT_WIDTH, FOOTER_HEIGHT, COLOR_HEADER);
+
+    setTextFont(2);
+    setTextColor(COLOR_TEXT, COLOR_HEADER);
 
-    sprite.setTextFont(2);
-    sprite.setTextColor(COLOR_TEXT, 0x1082);
+    setTextDatum(ML_DATUM);
+    drawString(left, MARGIN, y + FOOTER_HEIGHT/2);
 
-    sprite.setTextDatum(ML_DATUM);
-    sprite.drawString(left, MARGIN, y + FOOTER_HEIGHT/2);
+    drawFooterRight(right);
+}
 
-    sprite.setTextDatum(MR_DATUM);
-    sprite.drawString(right, TFT_WIDTH - MARGIN, y + FOOTER_HEIGHT/2);
+void Display::drawFooterRight(const char* right) {
+    setTextFont(2);
+    setTextColor(COLOR_TEXT, COLOR_HEADER);
+    setTextDatum(MR_DATUM);
+    drawString(right, TFT_WIDTH - MARGIN, TFT_HEIGHT - FOOTER_HEIGHT/2);
 }
 
 void Display::drawBatteryIcon(int x, int y, uint8_t percent, bool charging) {
     int w = 30, h = 14;
 
     // Outline
-    sprite.drawRect(x, y, w, h, COLOR_TEXT);
-    sprite.fillRect(x + w, y + 3, 3, h - 6, COLOR_TEXT);  // Nub
+    drawRect(x, y, w, h, COLOR_TEXT);
+    fillRect(x + w, y + 3, 3, h - 6, COLOR_TEXT);  // Nub
 
     // Fill
     int fillW = (w - 4) * percent / 100;
     uint16_t color = (percent > 50) ? COLOR_GREEN :
                      (percent > 20) ? COLOR_YELLOW : COLOR_DANGER;
-    sprite.fillRect(x + 2, y + 2, fillW, h - 4, color);
+    fillRect(x + 2, y + 2, fillW, h - 4, color);
 
     // Charging indicator
     if (charging) {
-        sprite.setTextFont(1);
-        sprite.setTextColor(COLOR_BG, color);
-        sprite.setTextDatum(MC_DATUM);
-        sprite.drawString("+", x + w/2, y + h/2);
+        setTextFont(1);
+        setTextColor(COLOR_BG, color);
+        setTextDatum(MC_DATUM);
+        drawString("+", x + w/2, y + h/2);
     }
 }
 
 void Display::drawProgressBar(int x, int y, int w, int h,
                                float progress, uint16_t color) {
     // Background
-    sprite.fillRoundRect(x, y, w, h, h/2, 0x2104);
+    fillRoundRect(x, y, w, h, h/2, COLOR_PANEL);
 
     // Progress fill
     int fillW = (w - 4) * constrain(progress, 0.0f, 1.0f);
     if (fillW > 0) {
-        sprite.fillRoundRect(x + 2, y + 2, fillW, h - 4, (h-4)/2, color);
+        fillRoundRect(x + 2, y + 2, fillW, h - 4, (h-4)/2, color);
     }
 
     // Border
-    sprite.drawRoundRect(x, y, w, h, h/2, 0x4208);
+    drawRoundRect(x, y, w, h, h/2, COLOR_BORDER);
 }
 
-void Display::drawLEDIndicator(int x, int y, bool redOn, bool nirOn) {
+void Display::drawLEDIndicator(int x, int y, bool redOn, bool nirOn, uint8_t glow) {
     int r = 15;
     int spacing = 40;
 
-    // RED LED
+    // RED LED (lit lamps can glow: a halo in the darker rim shade)
     int redX = x - spacing/2;
-    sprite.fillCircle(redX, y, r, redOn ? COLOR_RED : 0x4000);
-    sprite.drawCircle(redX, y, r, redOn ? 0xFFFF : 0x8000);
-    sprite.setTextFont(1);
-    sprite.setTextColor(COLOR_TEXT, COLOR_BG);
-    sprite.setTextDatum(MC_DATUM);
-    sprite.drawString("RED", redX, y + r + 12);
+    if (redOn && glow) {
+        fillCircle(redX, y, r + glow, COLOR_RED_RIM_OFF);
+    }
+    fillCircle(redX, y, r, redOn ? COLOR_RED : COLOR_RED_OFF);
+    drawCircle(redX, y, r, redOn ? COLOR_TEXT : COLOR_RED_RIM_OFF);
+    setTextFont(1);
+    setTextColor(COLOR_TEXT, COLOR_BG);
+    setTextDatum(MC_DATUM);
+    drawString("RED", redX, y + r + 12);
 
     // NIR LED
     int nirX = x + spacing/2;
-    sprite.fillCircle(nirX, y, r, nirOn ? COLOR_NIR : 0x2000);
-    sprite.drawCircle(nirX, y, r, nirOn ? 0xC000 : 0x4000);
-    sprite.drawString("NIR", nirX, y + r + 12);
+    if (nirOn && glow) {
+        fillCircle(nirX, y, r + glow, COLOR_NIR_RIM_OFF);
+    }
+    fillCircle(nirX, y, r, nirOn ? COLOR_NIR : COLOR_NIR_OFF);
+    drawCircle(nirX, y, r, nirOn ? COLOR_NIR_RIM : COLOR_NIR_RIM_OFF);
+    drawString("NIR", nirX, y + r + 12);
+}
+
+// =============================================================================
+// DIRTY-TRACKED PRIMITIVES
+// =============================================================================
+
+void Display::track(uint32_t sig, int x, int y, int w, int h) {
+    if (!tracking || replay) {
+        return;     // Drawing cached chrome, or a strip of a tracked frame
+    }
+    if (recordCount >= DISPLAY_MAX_PRIMITIVES) {
+        recordOverflow = true;
+        return;
+    }
+
+    DrawRecord& rec = records[recordCount];
+    if (recordCount >= prevRecordCount || rec.sig != sig) {
+        // Old pixels must be overwritten and new pixels shown
+        if (recordCount < prevRecordCount) {
+            dirty_add(&dirty, rec.bounds.x, rec.bounds.y, rec.bounds.w, rec.bounds.h);
+        }
+        dirty_add(&dirty, x, y, w, h);
+
+        rec.sig = sig;
+        rec.bounds.x = x;
+        rec.bounds.y = y;
+        rec.bounds.w = w;
+        rec.bounds.h = h;
+    }
+    recordCount++;
+}
+
+void Display::fillScreen(uint16_t color) {
+    draw->fillScreen(ink(color));
+    track(hashPrim(PRIM_FILL_SCREEN, 0, 0, 0, 0, 0, color), 0, 0, TFT_WIDTH, TFT_HEIGHT);
+}
+
+void Display::fillRect(int x, int y, int w, int h, uint16_t color) {
+    draw->fillRect(x, y, w, h, ink(color));
+    track(hashPrim(PRIM_FILL_RECT, x, y, w, h, 0, color), x, y, w, h);
+}
+
+void Display::drawRect(int x, int y, int w, int h, uint16_t color) {
+    draw->drawRect(x, y, w, h, ink(color));
+    track(hashPrim(PRIM_DRAW_RECT, x, y, w, h, 0, color), x, y, w, h);
+}
+
+void Display::fillRoundRect(int x, int y, int w, int h, int r, uint16_t color) {
+    draw->fillRoundRect(x, y, w, h, r, ink(color));
+    track(hashPrim(PRIM_FILL_ROUND_RECT, x, y, w, h, r, color), x, y, w, h);
+}
+
+void Display::drawRoundRect(int x, int y, int w, int h, int r, uint16_t color) {
+    draw->drawRoundRect(x, y, w, h, r, ink(color));
+    track(hashPrim(PRIM_DRAW_ROUND_RECT, x, y, w, h, r, color), x, y, w, h);
+}
+
+void Display::fillCircle(int x, int y, int r, uint16_t color) {
+    draw->fillCircle(x, y, r, ink(color));
+    track(hashPrim(PRIM_FILL_CIRCLE, x, y, r, 0, 0, color),
+          x - r, y - r, 2*r + 1, 2*r + 1);
+}
+
+void Display::drawCircle(int x, int y, int r, uint16_t color) {
+    draw->drawCircle(x, y, r, ink(color));
+    track(hashPrim(PRIM_DRAW_CIRCLE, x, y, r, 0, 0, color),
+          x - r, y - r, 2*r + 1, 2*r + 1);
+}
+
+void Display::drawAsset(const Asset& asset, int x, int y) {
+    // Asset palette to sprite values (16 bpp sprites hold panel byte order)
+    #if DISPLAY_COLOR_DEPTH == 4
+    uint8_t map[ASSET_MAX_COLORS];
+    #else
+    uint16_t map[ASSET_MAX_COLORS];
+    #endif
+    for (uint8_t i = 0; i < asset.colors && i < ASSET_MAX_COLORS; i++) {
+        uint16_t value = ink(asset.palette[i]);
+        #if DISPLAY_COLOR_DEPTH == 4
+        map[i] = value;
+        #else
+        map[i] = (value >> 8) | (value << 8);
+        #endif
+    }
+
+    // Decode only the rows inside this strip, straight into the buffer
+    int16_t top = stripNo * STRIP_LINES;
+    int y0 = (y > top) ? y : top;
+    int y1 = (y + asset.height < top + stripRows(top)) ? y + asset.height : top + stripRows(top);
+    if (y0 < y1) {
+        AssetReader reader;
+        asset_begin(&reader, &asset);
+        asset_skip_rows(&reader, y0 - y);
+
+        uint8_t* buf = (uint8_t*)draw->getPointer();
+        for (int row = y0; row < y1; row++) {
+            uint8_t* dst = buf + (size_t)(row - top) * ROW_BYTES;
+            #if DISPLAY_COLOR_DEPTH == 4
+            asset_decode_row4(&reader, dst, x, TFT_WIDTH, map);
+            #else
+            asset_decode_row16(&reader, (uint16_t*)dst, x, TFT_WIDTH, map);
+            #endif
+        }
+    }
+
+    const Asset* id = &asset;
+    uint32_t sig = hashPrim(PRIM_ASSET, x, y, asset.width, asset.height, 0, 0);
+    track(hashBytes(sig, &id, sizeof(id)), x, y, asset.width, asset.height);
+}
+
+void Display::setTextFont(uint8_t font) {
+    textFont = font;
+    draw->setTextFont(font);
+}
+
+void Display::setTextColor(uint16_t fg, uint16_t bg) {
+    textFg = fg;
+    textBg = bg;
+    draw->setTextColor(ink(fg), ink(bg));
+}
+
+void Display::setTextDatum(uint8_t datum) {
+    textDatum = datum;
+    draw->setTextDatum(datum);
+}
+
+int16_t Display::textWidth(const char* text) {
+    return draw->textWidth(text);
+}
+
+void Display::drawString(const char* text, int x, int y) {
+    draw->drawString(text, x, y);
+
+    // Bounding box from datum: columns L/C/R, rows T/M/B (TL_DATUM..BR_DATUM)
+    int w = draw->textWidth(text);
+    int h = draw->fontHeight();
+    int bx = x - ((textDatum % 3) * w) / 2;
+    int by = y - ((textDatum / 3) * h) / 2;
+
+    uint32_t sig = hashPrim(PRIM_STRING, x, y, textFont, textDatum, textBg, textFg);
+    sig = hashBytes(sig, text, strlen(text));
+
+    // Pad for glyph overhang and rounding of centred datums
+    track(sig, bx - 2, by - 2, w + 4, h + 4);
 }
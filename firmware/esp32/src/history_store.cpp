@@ -0,0 +1,80 @@
+/**
+ * Roxy RedLight v2.0 - Session History Store Implementation
+ */
+
+#include "config.h"
+
+#ifdef ARDUINO
+
+#include "history_store.h"
+#include <Arduino.h>
+#include <LittleFS.h>
+
+HistoryStore historyStore;
+
+HistoryStore::HistoryStore() {
+    mounted = false;
+    records = 0;
+}
+
+bool HistoryStore::begin() {
+    mounted = LittleFS.begin(true);
+    if (!mounted) {
+        Serial.println("History: filesystem unavailable");
+        return false;
+    }
+
+    File file = LittleFS.open(HISTORY_FILE, "r");
+    if (file) {
+        records = file.size() / sizeof(HistoryRecord);  // A torn last write is ignored
+        file.close();
+    }
+    Serial.printf("History: %lu sessions\n", (unsigned long)records);
+    return true;
+}
+
+bool HistoryStore::append(const HistoryRecord& record) {
+    if (!mounted) {
+        return false;
+    }
+
+    File file = LittleFS.open(HISTORY_FILE, "r+");
+    if (!file) {
+        file = LittleFS.open(HISTORY_FILE, "w");
+    }
+    if (!file) {
+        return false;
+    }
+
+    // Write at the last whole record, over any torn tail
+    bool ok = file.seek(records * sizeof(HistoryRecord)) &&
+              file.write((const uint8_t*)&record, sizeof(record)) == sizeof(record);
+    file.close();
+    if (ok) {
+        records++;
+    }
+    return ok;
+}
+
+uint16_t HistoryStore::read(void* ctx, uint32_t first, HistoryRecord* out, uint16_t count) {
+    HistoryStore* self = (HistoryStore*)ctx;
+    if (!self->mounted || first >= self->records) {
+        return 0;
+    }
+    if (count > self->records - first) {
+        count = self->records - first;
+    }
+
+    File file = LittleFS.open(HISTORY_FILE, "r");
+    if (!file) {
+        return 0;
+    }
+    size_t bytes = 0;
+    if (file.seek(first * sizeof(HistoryRecord))) {
+        bytes = file.read((uint8_t*)out, count * sizeof(HistoryRecord));
+    }
+    file.close();
+    return bytes / sizeof(HistoryRecord);
+}
+
+#endif // ARDUINO
@@ -0,0 +1,180 @@
+/**
+ * Roxy RedLight v2.0 - Parallel Panel Driver Implementation
+ */
+
+#include "config.h"
+
+#if defined(ARDUINO) && DISPLAY_BUS_I80
+
+#include "i80_panel.h"
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <esp_lcd_panel_vendor.h>
+#include <esp32s3/rom/cache.h>
+#if ESP_IDF_VERSION_MAJOR >= 5
+#include <esp_memory_utils.h>
+#else
+#include <soc/soc_memory_layout.h>
+#endif
+
+#if TEMP_ENABLED && PIN_TEMP_ADC == PIN_LCD_DC
+#error "The thermistor input shares its GPIO with the i80 DC line"
+#endif
+
+// The ST7789 has 240x320 of RAM; the 170-column glass sits in the middle
+#define PANEL_GAP       35
+
+// Transfers the esp_lcd queue holds (Display keeps at most two in flight)
+#define QUEUE_DEPTH     4
+
+// Guards the pending count shared with the transfer-done ISR
+static portMUX_TYPE pendingLock = portMUX_INITIALIZER_UNLOCKED;
+
+I80Panel::I80Panel() : TFT_eSPI(TFT_WIDTH, TFT_HEIGHT) {
+    bus = NULL;
+    io = NULL;
+    panel = NULL;
+    pending = 0;
+}
+
+void I80Panel::init() {
+    pinMode(PIN_LCD_RD, OUTPUT);
+    digitalWrite(PIN_LCD_RD, HIGH);   // Never read back
+
+    esp_lcd_i80_bus_config_t busConfig = {};
+    busConfig.dc_gpio_num = PIN_LCD_DC;
+    busConfig.wr_gpio_num = PIN_LCD_WR;
+    busConfig.clk_src = LCD_CLK_SRC_PLL160M;
+    const int dataPins[8] = {
+        PIN_LCD_D0, PIN_LCD_D1, PIN_LCD_D2, PIN_LCD_D3,
+        PIN_LCD_D4, PIN_LCD_D5, PIN_LCD_D6, PIN_LCD_D7
+    };
+    for (uint8_t i = 0; i < 8; i++) {
+        busConfig.data_gpio_nums[i] = dataPins[i];
+    }
+    busConfig.bus_width = 8;
+    busConfig.max_transfer_bytes = TFT_WIDTH * TFT_HEIGHT * sizeof(uint16_t);
+    busConfig.psram_trans_align = 64;
+    busConfig.sram_trans_align = 4;
+    if (esp_lcd_new_i80_bus(&busConfig, &bus) != ESP_OK) {
+        Serial.println("i80 bus unavailable");
+        bus = NULL;
+        return;
+    }
+
+    esp_lcd_panel_io_i80_config_t ioConfig = {};
+    ioConfig.cs_gpio_num = PIN_LCD_CS;
+    ioConfig.pclk_hz = DISPLAY_I80_PCLK_HZ;
+    ioConfig.trans_queue_depth = QUEUE_DEPTH;
+    ioConfig.on_color_trans_done = onDone;
+    ioConfig.user_ctx = this;
+    ioConfig.lcd_cmd_bits = 8;
+    ioConfig.lcd_param_bits = 8;
+    ioConfig.dc_levels.dc_idle_level = 0;
+    ioConfig.dc_levels.dc_cmd_level = 0;
+    ioConfig.dc_levels.dc_dummy_level = 0;
+    ioConfig.dc_levels.dc_data_level = 1;
+    esp_lcd_new_panel_io_i80(bus, &ioConfig, &io);
+
+    esp_lcd_panel_dev_config_t panelConfig = {};
+    panelConfig.reset_gpio_num = PIN_LCD_RST;
+    #if ESP_IDF_VERSION_MAJOR >= 5
+    panelConfig.rgb_endian = LCD_RGB_ENDIAN_RGB;
+    #else
+    panelConfig.color_space = ESP_LCD_COLOR_SPACE_RGB;
+    #endif
+    panelConfig.bits_per_pixel = 16;
+    esp_lcd_new_panel_st7789(io, &panelConfig, &panel);
+
+    esp_lcd_panel_reset(panel);
+    esp_lcd_panel_init(panel);
+    esp_lcd_panel_invert_color(panel, true);
+    setRotation(TFT_ROTATION);
+    #if ESP_IDF_VERSION_MAJOR >= 5
+    esp_lcd_panel_disp_on_off(panel, true);
+    #else
+    esp_lcd_panel_disp_off(panel, false);
+    #endif
+}
+
+void I80Panel::setRotation(uint8_t rotation) {
+    if (panel == NULL) {
+        return;
+    }
+
+    // Same orientations as TFT_eSPI's ST7789 driver
+    rotation &= 3;
+    bool landscape = rotation & 1;
+    esp_lcd_panel_swap_xy(panel, landscape);
+    esp_lcd_panel_mirror(panel, rotation == 1 || rotation == 2, rotation >= 2);
+    esp_lcd_panel_set_gap(panel, landscape ? 0 : PANEL_GAP, landscape ? PANEL_GAP : 0);
+    _width = landscape ? TFT_HEIGHT : TFT_WIDTH;
+    _height = landscape ? TFT_WIDTH : TFT_HEIGHT;
+}
+
+void I80Panel::fillScreen(uint32_t color) {
+    size_t pixels = (size_t)_width * DISPLAY_DMA_LINES;
+    uint16_t* band = (uint16_t*)heap_caps_malloc(pixels * sizeof(uint16_t), MALLOC_CAP_DMA);
+    if (band == NULL) {
+        return;
+    }
+
+    uint16_t value = (uint16_t)((color >> 8) | (color << 8));   // Panel byte order
+    for (size_t i = 0; i < pixels; i++) {
+        band[i] = value;
+    }
+    for (int32_t y = 0; y < _height; y += DISPLAY_DMA_LINES) {
+        int32_t rows = (y + DISPLAY_DMA_LINES > _height) ? _height - y : DISPLAY_DMA_LINES;
+        pushImage(0, y, _width, rows, band);
+    }
+    free(band);
+}
+
+void I80Panel::pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t* data) {
+    if (panel == NULL || w <= 0 || h <= 0) {
+        return;
+    }
+
+    // The DMA reads PSRAM behind the cache: write dirty lines out first
+    if (esp_ptr_external_ram(data)) {
+        Cache_WriteBack_Addr((uint32_t)(uintptr_t)data, (uint32_t)(w * h * sizeof(uint16_t)));
+    }
+
+    portENTER_CRITICAL(&pendingLock);
+    pending++;
+    portEXIT_CRITICAL(&pendingLock);
+
+    if (esp_lcd_panel_draw_bitmap(panel, x, y, x + w, y + h, data) != ESP_OK) {
+        portENTER_CRITICAL(&pendingLock);
+        pending--;
+        portEXIT_CRITICAL(&pendingLock);
+    }
+}
+
+void I80Panel::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t* data) {
+    pushImageDMA(x, y, w, h, data);
+    dmaWait();
+}
+
+void I80Panel::dmaWait() {
+    while (pending != 0) {
+        // Spin: a chunk takes about a millisecond on the wire
+    }
+}
+
+#if ESP_IDF_VERSION_MAJOR >= 5
+bool IRAM_ATTR I80Panel::onDone(esp_lcd_panel_io_handle_t io,
+                                esp_lcd_panel_io_event_data_t* event, void* ctx) {
+#else
+bool IRAM_ATTR I80Panel::onDone(esp_lcd_panel_io_handle_t io, void* ctx, void* event) {
+#endif
+    I80Panel* self = (I80Panel*)ctx;
+    portENTER_CRITICAL_ISR(&pendingLock);
+    if (self->pending) {
+        self->pending--;
+    }
+    portEXIT_CRITICAL_ISR(&pendingLock);
+    return false;   // No task woken
+}
+
+#endif // ARDUINO && DISPLAY_BUS_I80
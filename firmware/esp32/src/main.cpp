@@ -21,8 +21,22 @@
 #include <Arduino.h>
 #include <Preferences.h>
 #include <TFT_eSPI.h>
+#include <driver/ledc.h>
+#include <driver/gpio.h>
+#include <hal/gpio_ll.h>
+#include <esp_sleep.h>
+#include <esp_pm.h>
 #include "config.h"
 #include "display.h"
+#include "sched.h"
+#include "melody.h"
+#include "input.h"
+#include "perf.h"
+#include "telemetry.h"
+#include "history.h"
+#include "history_store.h"
+#include "supervisor.h"
+#include "device_state.h"
 
 // =============================================================================
 // GLOBAL STATE
@@ -30,47 +44,105 @@
 
 Preferences prefs;
 
-// Current state
-volatile bool sessionActive = false;
-volatile TreatmentMode currentMode = DEFAULT_MODE;
-volatile uint8_t brightness = 255;  // 0-255
-
-// Session tracking
-unsigned long sessionStartTime = 0;
-unsigned long totalSessionSeconds = 0;
-uint32_t lifetimeSessions = 0;
-uint32_t lifetimeMinutes = 0;
-
-// Button state (two buttons on T-Display S3)
-volatile bool button1Pressed = false;
-volatile bool button2Pressed = false;
-unsigned long button1PressTime = 0;
-unsigned long button2PressTime = 0;
-bool button1Handled = false;
-bool button2Handled = false;
-
-// Menu state
-int menuSelectedIndex = 0;
-unsigned long lastDisplayUpdate = 0;
-#define DISPLAY_UPDATE_INTERVAL 100  // ms
-
-// Battery
-float batteryVoltage = 0.0;
-bool lowBatteryWarning = false;
-bool overVoltageError = false;
-
-// Thermal (optional)
-float temperature = 0.0;
-bool thermalWarning = false;
-
-// Safety tracking
-uint8_t dailySessionCount = 0;
-unsigned long lastSessionEndTime = 0;
-unsigned long dayStartTime = 0;
-
-// Alternating mode state
-unsigned long lastAlternateTime = 0;
-bool alternatePhase = false;  // false = red, true = NIR
+// Device state: loop() owns dev and publishes a copy at the end of each
+// pass; the safety task publishes its sensor readings, which loop() pulls in
+// at the start of the next. Other tasks read snapshots, never dev itself.
+DeviceState dev = {
+    .sessionActive = false,
+    .currentMode = DEFAULT_MODE,
+    .brightness = 255,
+};
+DeviceStateChannel deviceChannel;
+SensorChannel sensorChannel;
+
+// Buttons (two on T-Display S3): the ISRs queue timestamped edges, and
+// loop() turns them into gestures
+InputRing inputRing;
+InputRecognizer inputRecognizer;
+PerfHist inputLatency;              // Gesture complete to action done (us)
+
+// Menu state: navigation runs on the lib/ui transition table; the renderer
+// only sees snapshots
+UIState ui;
+static_assert((int)MODE_COUNT == (int)UI_MODE_COUNT, "UI modes mirror TreatmentMode");
+bool emergencyLatched = false;      // Trip screen up until a button acknowledges it
+#if DISPLAY_PROFILE
+bool diagnosticsVisible = false;    // Hidden render profile screen
+#endif
+#define DISPLAY_UPDATE_INTERVAL 1000    // ms: clocks and readings; UI changes refresh at once
+#define BATTERY_CHECK_INTERVAL  5000    // ms
+#define THERMAL_CHECK_INTERVAL  2000    // ms
+#define PROGRESS_LOG_INTERVAL   30000   // ms
+
+#if RENDER_TASK_ENABLED
+// Latest view snapshot for the render task (one-slot mailbox), and the
+// lock loop() takes to draw alerts itself
+QueueHandle_t viewQueue = NULL;
+SemaphoreHandle_t displayLock = NULL;
+ViewModel postedView;               // Last snapshot sent: an identical one is not
+bool postedViewValid = false;       // worth waking the render task for
+bool refreshPending = false;        // refreshDisplay() asked: send even if unchanged
+#endif
+
+// Cooperative scheduler: loop() runs the jobs that are due, then sleeps
+// until the next deadline or a button interrupt
+Scheduler scheduler;
+SchedJob displayJob;        // Snapshot for the renderer
+SchedJob refreshJob;        // Extra snapshot as soon as something visible changes
+SchedJob frameJob;          // Extra snapshot when an animation frame is due
+SchedJob telemetryJob;
+SchedJob batteryJob;
+SchedJob thermalJob;
+SchedJob sessionEndJob;     // Session jobs: armed only while one runs
+SchedJob progressJob;
+SchedJob alternateJob;
+SchedJob toneJob;           // Next note boundary of the playing melody
+SchedJob blinkJob;          // Next edge of the status LED blink pattern
+TaskHandle_t loopTask = NULL;
+TaskHandle_t safetyTaskHandle = NULL;
+bool safetyFast = false;            // Told the safety task the LEDs may light
+
+// Buzzer: melodies queue here and play in the background
+MelodySeq melodySeq;
+
+// Status LED blink pattern in progress
+uint8_t blinkEdges = 0;     // Edges still to come
+uint16_t blinkOnMs = 0;
+uint16_t blinkOffMs = 0;
+
+// Tone patterns: {Hz, ms}, MELODY_REST for pauses
+static const ToneNote MELODY_COMPLETE[] = {
+    {TONE_COMPLETE, 500}, {MELODY_REST, 200}, {TONE_COMPLETE, 500}
+};
+static const ToneNote MELODY_ALARM[] = {
+    {TONE_LOW_BAT, 200}, {MELODY_REST, 200}, {TONE_LOW_BAT, 200}, {MELODY_REST, 200},
+    {TONE_LOW_BAT, 200}, {MELODY_REST, 200}, {TONE_LOW_BAT, 200}, {MELODY_REST, 200},
+    {TONE_LOW_BAT, 200}, {MELODY_REST, 200}
+};
+static const ToneNote MELODY_CLICK_LEFT[] = {{1000, 50}};
+static const ToneNote MELODY_CLICK_RIGHT[] = {{1200, 50}};
+#define MELODY_LENGTH(m)    ((uint8_t)(sizeof(m) / sizeof(m[0])))
+
+// Safety supervisor task: samples and cuts the LEDs on a fault; loop()
+// follows up each trip. ledLock keeps loop() from relighting LEDs the task
+// has just cut.
+Supervisor supervisor;
+SemaphoreHandle_t ledLock = NULL;
+uint32_t safetyTripsHandled = 0;
+static_assert(MAX_SESSION_MINUTES * 60 == SAFETY_MAX_SESSION_SEC, "supervisor enforces the hard limit");
+
+// Telemetry: loop() samples into the ring, updateDisplay() folds the new
+// samples into the session trace and the sliding last-hour trace
+TelemetryRing telemetryRing;
+TelemetryTrace sessionTrace;
+TelemetryTrace hourTrace;
+uint32_t telemetryCursor = 0;
+TelemetrySample lastSample;
+bool telemetryLastHour = false;     // Window shown on the telemetry screen
+
+// Session history: pages come through a small cache so scrolling rarely
+// waits on flash
+HistoryCache historyCache;
 
 // =============================================================================
 // FUNCTION PROTOTYPES
@@ -79,16 +151,18 @@ bool alternatePhase = false;  // false = red, true = NIR
 void setupPWM();
 void setupButton();
 void setupBattery();
+void setupPower();
 void loadPreferences();
 void savePreferences();
 
+void writePWM(uint8_t channel, uint32_t duty);
 void setLEDs(uint8_t red, uint8_t nir);
 void applyMode(TreatmentMode mode);
 void updateAlternating();
 
 void startSession();
-void stopSession();
-void cycleMode();
+void stopSession(HistoryEnd end);
+void setMode(TreatmentMode mode);
 
 float readBatteryVoltage();
 void checkBattery();
@@ -96,12 +170,38 @@ float readTemperature();
 void checkThermal();
 bool checkSafetyLimits();
 void emergencyShutdown(const char* reason);
+void setupSafety();
+void safetyTask(void* arg);
+void handleSafetyTrip();
+void pullSensorState();
 
 void blinkStatus(int count, int onTime, int offTime);
+void setupBuzzer();
 void playTone(int freq, int duration);
+void playMelody(const ToneNote* notes, uint8_t count, uint8_t priority);
+
+void sampleTelemetry();
+void drainTelemetry();
+
+void setupHistory();
+void recordSession(HistoryEnd end);
+
+void setupScheduler();
+void startSessionJobs();
+void stopSessionJobs();
+void logProgress();
 
 void updateDisplay();
+void refreshDisplay();
+void renderTask(void* arg);
+void lockDisplay();
+void unlockDisplay();
+void postNotice(uint8_t level, const char* title, const char* text, uint16_t color);
 void handleButtons();
+void handleButtonEvent(ButtonEvent event);
+#if DISPLAY_PROFILE
+void handleSerialCommands();
+#endif
 void IRAM_ATTR button1ISR();
 void IRAM_ATTR button2ISR();
 
@@ -112,6 +212,7 @@ void IRAM_ATTR button2ISR();
 void setup() {
     Serial.begin(115200);
     delay(100);
+    loopTask = xTaskGetCurrentTaskHandle();     // setup() and loop() share a task
 
     Serial.println();
     Serial.println("=================================");
@@ -127,27 +228,39 @@ void setup() {
 
     // Initialize display first
     display.begin();
-    display.showAlert("FOLICULATOR", "Initializing...", COLOR_GREEN);
-    delay(500);
+
+    #if RENDER_TASK_ENABLED
+    viewQueue = xQueueCreate(1, sizeof(ViewModel));
+    displayLock = xSemaphoreCreateMutex();
+    xTaskCreatePinnedToCore(renderTask, "render", RENDER_TASK_STACK, NULL,
+                            RENDER_TASK_PRIORITY, NULL, RENDER_TASK_CORE);
+    #endif
+
+    lockDisplay();
+    display.showSplash("Initializing...");  // Up until the first display update
+    unlockDisplay();
+
+    // Jobs run from loop(); sounds and session jobs may be armed from here on
+    setupScheduler();
 
     // Initialize hardware
     setupPWM();
     setupButton();
     setupBattery();
-
-    // Buzzer (optional)
-    pinMode(PIN_BUZZER, OUTPUT);
-    digitalWrite(PIN_BUZZER, LOW);
+    setupBuzzer();
+    setupPower();
 
     // Load saved data
     loadPreferences();
+    setupHistory();
 
-    // Initial battery check
-    batteryVoltage = readBatteryVoltage();
-    Serial.printf("Battery: %.2fV\n", batteryVoltage);
-    Serial.printf("Lifetime sessions: %lu\n", lifetimeSessions);
-    Serial.printf("Lifetime minutes: %lu\n", lifetimeMinutes);
-    Serial.printf("Current mode: %d\n", currentMode);
+    // Initial battery check; the safety task samples from here on
+    dev.batteryVoltage = readBatteryVoltage();
+    dev.temperature = readTemperature();
+    Serial.printf("Battery: %.2fV\n", dev.batteryVoltage);
+    Serial.printf("Lifetime sessions: %lu\n", dev.lifetimeSessions);
+    Serial.printf("Lifetime minutes: %lu\n", dev.lifetimeMinutes);
+    Serial.printf("Current mode: %d\n", dev.currentMode);
 
     // Startup indication
     playTone(TONE_START, 100);
@@ -156,8 +269,17 @@ void setup() {
     setLEDs(0, 0);
 
     // Show home screen
-    display.setScreen(SCREEN_HOME);
-    dayStartTime = millis();  // Initialize daily counter
+    ui_init(&ui);
+    ui.current_mode = ui.selected_mode = (UITreatmentMode)dev.currentMode;
+    dev.dayStartTime = millis();  // Initialize daily counter
+
+    telemetry_ring_init(&telemetryRing);
+    telemetry_trace_init(&sessionTrace, 1, true);
+    telemetry_trace_init(&hourTrace,
+        TELEMETRY_WINDOW_SEC * 1000UL / TELEMETRY_PERIOD_MS / TELEMETRY_COLUMNS, false);
+
+    device_state_publish(&deviceChannel, &dev);     // Before the safety task reads it
+    setupSafety();
 
     Serial.println("Ready. Press button to start session.");
     Serial.println();
@@ -168,71 +290,277 @@ void setup() {
 // =============================================================================
 
 void loop() {
+    #if !RENDER_TASK_ENABLED
+    // Keep the display DMA queue moving
+    display.service();
+    #endif
+
+    pullSensorState();
+
+    // Follow up a fault the safety task has already cut the LEDs for
+    handleSafetyTrip();
+
     // Handle button presses
     handleButtons();
 
-    // Session active logic
-    if (sessionActive) {
-        // Update alternating mode
-        if (currentMode == MODE_ALTERNATING) {
-            updateAlternating();
-        }
+    #if DISPLAY_PROFILE
+    handleSerialCommands();
+    #endif
 
-        // Check session duration
-        unsigned long elapsed = (millis() - sessionStartTime) / 1000;
-        unsigned long targetSeconds = DEFAULT_SESSION_MINUTES * 60;
-
-        if (elapsed >= targetSeconds) {
-            // Session complete
-            Serial.println("Session complete!");
-            playTone(TONE_COMPLETE, 500);
-            delay(200);
-            playTone(TONE_COMPLETE, 500);
-            stopSession();
-            display.showAlert("COMPLETE", "Session finished!", COLOR_GREEN);
-            delay(2000);
-        }
+    sched_run(&scheduler, millis());
+
+    // Sleep until the next job or gesture timer is due; button edges wake
+    // us early
+    uint32_t wait = sched_next(&scheduler, millis());
+    uint32_t inputUs = input_wait(&inputRecognizer, micros());
+    if (inputUs != INPUT_IDLE) {
+        wait = min(wait, (inputUs + 999) / 1000);
+    }
+    #if !RENDER_TASK_ENABLED
+    if (display.frameInFlight()) {
+        wait = min(wait, (uint32_t)1);
+    }
+    #endif
+
+    // Everything this pass changed, in one snapshot
+    device_state_publish(&deviceChannel, &dev);
+
+    // Idle, the safety task checks slowly: once the LEDs may light, wake
+    // it to resume fast checks (after the publish, so it sees why)
+    bool lit = dev.sessionActive || dev.ledDuty > 0;
+    if (lit && !safetyFast) {
+        xTaskNotifyGive(safetyTaskHandle);
+    }
+    safetyFast = lit;
 
-        // Safety: max session limit
-        if (elapsed >= MAX_SESSION_MINUTES * 60) {
-            Serial.println("Max session time reached - safety shutoff");
-            stopSession();
+    if (wait > 0) {
+        ulTaskNotifyTake(pdTRUE, (wait == SCHED_IDLE) ? portMAX_DELAY : pdMS_TO_TICKS(wait));
+    }
+}
+
+// =============================================================================
+// SCHEDULED JOBS
+// =============================================================================
+
+static void runDisplayUpdate(void* arg) {
+    updateDisplay();
+
+    // While animating, the next frame may come before the next update
+    uint32_t frameUs = display.frameDelay();
+    if (frameUs != PACER_IDLE && frameUs < DISPLAY_UPDATE_INTERVAL * 1000UL) {
+        sched_start(&scheduler, &frameJob, millis(), (frameUs + 999) / 1000, 0);
+    }
+}
+
+static void runTelemetrySample(void* arg) {
+    sampleTelemetry();      // Folded into the traces on the next display update
+}
+
+static void runBatteryCheck(void* arg) {
+    checkBattery();
+}
+
+static void runThermalCheck(void* arg) {
+    checkThermal();
+}
+
+static void runSessionEnd(void* arg) {
+    Serial.println("Session complete!");
+    playMelody(MELODY_COMPLETE, MELODY_LENGTH(MELODY_COMPLETE), MELODY_PRIORITY_EVENT);
+    stopSession(HISTORY_END_COMPLETE);
+    postNotice(NOTICE_INFO, "COMPLETE", "Session finished!", COLOR_GREEN);
+}
+
+static void runProgressLog(void* arg) {
+    logProgress();
+}
+
+static void runAlternate(void* arg) {
+    updateAlternating();
+}
+
+// Status LED: one edge of the blink pattern, then wait for the next
+static void runBlink(void* arg) {
+    bool lit = (blinkEdges % 2) == 0;   // Even count left: turn back on
+    digitalWrite(PIN_STATUS_LED, lit ? HIGH : LOW);
+    if (--blinkEdges > 0) {
+        sched_start(&scheduler, &blinkJob, millis(), lit ? blinkOnMs : blinkOffMs, 0);
+    }
+}
+
+// Retune the buzzer at each note boundary, then wait for the next one
+static void runTone(void* arg) {
+    uint32_t now = millis();
+    if (melody_update(&melodySeq, now)) {
+        if (melodySeq.freq > 0) {
+            ledc_set_freq(LEDC_LOW_SPEED_MODE, (ledc_timer_t)PWM_TIMER_BUZZER, melodySeq.freq);
         }
+        writePWM(PWM_CHANNEL_BUZZER, melodySeq.freq > 0 ? (1 << (PWM_RESOLUTION - 1)) : 0);  // Square wave or silence
+    }
+    uint32_t next = melody_next(&melodySeq, now);
+    if (next != MELODY_IDLE) {
+        sched_start(&scheduler, &toneJob, now, next, 0);
+    }
+}
+
+void setupScheduler() {
+    uint32_t now = millis();
+    sched_init(&scheduler, now);
+
+    sched_job_init(&displayJob, "display", runDisplayUpdate, NULL);
+    sched_job_init(&refreshJob, "refresh", runDisplayUpdate, NULL);
+    sched_job_init(&frameJob, "frame", runDisplayUpdate, NULL);
+    sched_job_init(&telemetryJob, "telemetry", runTelemetrySample, NULL);
+    sched_job_init(&batteryJob, "battery", runBatteryCheck, NULL);
+    sched_job_init(&thermalJob, "thermal", runThermalCheck, NULL);
+    sched_job_init(&sessionEndJob, "session", runSessionEnd, NULL);
+    sched_job_init(&progressJob, "progress", runProgressLog, NULL);
+    sched_job_init(&alternateJob, "alternate", runAlternate, NULL);
+    sched_job_init(&toneJob, "tone", runTone, NULL);
+    sched_job_init(&blinkJob, "blink", runBlink, NULL);
+
+    sched_start(&scheduler, &displayJob, now, 0, DISPLAY_UPDATE_INTERVAL);
+    sched_start(&scheduler, &telemetryJob, now, TELEMETRY_PERIOD_MS, TELEMETRY_PERIOD_MS);
+    sched_start(&scheduler, &batteryJob, now, BATTERY_CHECK_INTERVAL, BATTERY_CHECK_INTERVAL);
+    #if TEMP_ENABLED
+    sched_start(&scheduler, &thermalJob, now, THERMAL_CHECK_INTERVAL, THERMAL_CHECK_INTERVAL);
+    #endif
+}
 
-        // Print progress every 30 seconds
-        static unsigned long lastProgress = 0;
-        if (millis() - lastProgress > 30000) {
-            unsigned long remaining = targetSeconds - elapsed;
-            Serial.printf("Session: %lu:%02lu elapsed, %lu:%02lu remaining\n",
-                         elapsed / 60, elapsed % 60,
-                         remaining / 60, remaining % 60);
-            lastProgress = millis();
+void startSessionJobs() {
+    uint32_t now = millis();
+
+    // Clock and telemetry tick together on the session's seconds: one wake
+    // serves both
+    sched_start(&scheduler, &displayJob, now, 0, DISPLAY_UPDATE_INTERVAL);
+    sched_start(&scheduler, &telemetryJob, now, TELEMETRY_PERIOD_MS, TELEMETRY_PERIOD_MS);
+    sched_start(&scheduler, &sessionEndJob, now, DEFAULT_SESSION_MINUTES * 60000UL, 0);
+    sched_start(&scheduler, &progressJob, now, PROGRESS_LOG_INTERVAL, PROGRESS_LOG_INTERVAL);
+    if (dev.currentMode == MODE_ALTERNATING) {
+        sched_start(&scheduler, &alternateJob, now, ALTERNATE_PERIOD_SEC * 1000UL,
+                    ALTERNATE_PERIOD_SEC * 1000UL);
+    }
+}
+
+void stopSessionJobs() {
+    sched_stop(&scheduler, &sessionEndJob);
+    sched_stop(&scheduler, &progressJob);
+    sched_stop(&scheduler, &alternateJob);
+}
+
+void logProgress() {
+    unsigned long elapsed = (millis() - dev.sessionStartTime) / 1000;
+    unsigned long targetSeconds = DEFAULT_SESSION_MINUTES * 60;
+    unsigned long remaining = (elapsed < targetSeconds) ? targetSeconds - elapsed : 0;
+    Serial.printf("Session: %lu:%02lu elapsed, %lu:%02lu remaining\n",
+                 elapsed / 60, elapsed % 60,
+                 remaining / 60, remaining % 60);
+    FrameStats frames = display.getFrameStats();  // Counters only: no lock
+    Serial.printf("Display: %lu frames rendered, %lu skipped, %lu dropped, last %lu us\n",
+                 frames.rendered, frames.skipped, frames.dropped,
+                 frames.lastFrameMicros);
+
+    // Scheduling latency of the periodic jobs since the last report
+    SchedJob* jobs[] = {&displayJob, &frameJob, &telemetryJob, &batteryJob, &thermalJob,
+                        &alternateJob};
+    Serial.print("Jobs late avg/max ms (missed):");
+    for (uint8_t i = 0; i < sizeof(jobs) / sizeof(jobs[0]); i++) {
+        if (jobs[i]->runs == 0) {
+            continue;
         }
+        Serial.printf(" %s %lu/%lu (%lu)", jobs[i]->name, (unsigned long)sched_late_avg(jobs[i]),
+                      (unsigned long)jobs[i]->lateMax, (unsigned long)jobs[i]->missed);
+        sched_reset_stats(jobs[i]);
     }
+    Serial.println();
 
-    // Update display periodically
-    if (millis() - lastDisplayUpdate > DISPLAY_UPDATE_INTERVAL) {
-        updateDisplay();
-        lastDisplayUpdate = millis();
+    if (inputLatency.count > 0) {
+        Serial.printf("Input: %lu gestures, latency avg %lu p99 %lu max %lu us, %lu lost\n",
+                     (unsigned long)inputLatency.count, (unsigned long)perf_avg(&inputLatency),
+                     (unsigned long)perf_percentile(&inputLatency, 99),
+                     (unsigned long)perf_max(&inputLatency),
+                     (unsigned long)(inputRing.overruns + inputRecognizer.dropped));
+        perf_init(&inputLatency);
     }
 
-    // Battery monitoring (every 5 seconds)
-    static unsigned long lastBatteryCheck = 0;
-    if (millis() - lastBatteryCheck > 5000) {
-        checkBattery();
-        lastBatteryCheck = millis();
+    // Copied without a lock: a torn figure only skews one report
+    Serial.printf("Safety: %lu checks, late max %lu us, response max %lu us, %lu missed, "
+                  "fault to LEDs off <= %lu us\n",
+                  (unsigned long)supervisor.runs, (unsigned long)supervisor.lateMaxUs,
+                  (unsigned long)supervisor.responseMaxUs, (unsigned long)supervisor.missed,
+                  (unsigned long)supervisor_worst_case(&supervisor));
+}
+
+// =============================================================================
+// TELEMETRY
+// =============================================================================
+
+// Latest readings; battery and temperature hold their last check's value
+void sampleTelemetry() {
+    TelemetrySample sample;
+    sample.value[SERIES_VOLTS] = (int16_t)lroundf(dev.batteryVoltage * 100.0f);
+    sample.value[SERIES_TEMP] = (int16_t)lroundf(dev.temperature * 10.0f);
+    sample.value[SERIES_DUTY] = dev.ledDuty;
+    telemetry_ring_push(&telemetryRing, &sample);
+}
+
+void drainTelemetry() {
+    TelemetrySample sample;
+    while (telemetry_ring_read(&telemetryRing, &telemetryCursor, &sample)) {
+        telemetry_trace_add(&hourTrace, &sample);
+        if (dev.sessionActive) {
+            telemetry_trace_add(&sessionTrace, &sample);
+        }
+        lastSample = sample;
     }
+}
 
-    // Thermal monitoring (every 2 seconds, if enabled)
-    #if TEMP_ENABLED
-    static unsigned long lastThermalCheck = 0;
-    if (millis() - lastThermalCheck > 2000) {
-        checkThermal();
-        lastThermalCheck = millis();
+// =============================================================================
+// SESSION HISTORY
+// =============================================================================
+
+void setupHistory() {
+    // Count boots: records made before the clock is set are placed by
+    // boot number and uptime
+    prefs.begin(PREFS_NAMESPACE, false);
+    dev.bootCount = prefs.getUShort(PREFS_KEY_BOOTS, 0) + 1;
+    prefs.putUShort(PREFS_KEY_BOOTS, dev.bootCount);
+    prefs.end();
+
+    historyStore.begin();
+    history_cache_init(&historyCache, HistoryStore::read, &historyStore);
+}
+
+// Append the running session; call before clearing dev.sessionActive
+void recordSession(HistoryEnd end) {
+    if (!dev.sessionActive) {
+        return;
     }
-    #endif
 
-    delay(10);  // Small delay to prevent tight loop
+    unsigned long elapsed = (millis() - dev.sessionStartTime) / 1000;
+    time_t now = time(NULL);
+
+    HistoryRecord record;
+    memset(&record, 0, sizeof(record));
+    if (now > 1600000000) {     // Clock set (2020 onwards)
+        record.start = (uint32_t)(now - elapsed);
+        record.flags = HISTORY_WALL_CLOCK;
+    } else {
+        record.start = dev.sessionStartTime / 1000;
+    }
+    record.boot = dev.bootCount;
+    record.durationSec = (uint16_t)min(elapsed, 65535UL);
+    // Nominal single-channel estimate, as on the stats screen: dual mode
+    // lighting both arrays is not counted twice
+    record.doseMilliJ = (uint16_t)min(elapsed * THERAPEUTIC_MW_CM2 * dev.brightness / 255, 65535UL);
+    record.mode = dev.currentMode;
+    record.end = end;
+
+    if (historyStore.append(record)) {
+        history_cache_invalidate(&historyCache, history_page_of(historyStore.count() - 1));
+    } else {
+        Serial.println("History: record not saved");
+    }
 }
 
 // =============================================================================
@@ -240,50 +568,193 @@ void loop() {
 // =============================================================================
 
 void updateDisplay() {
-    uint8_t battPercent = (uint8_t)constrain(
-        (batteryVoltage - VBAT_CUTOFF) / (VBAT_FULL - VBAT_CUTOFF) * 100, 0, 100);
-
-    Screen screen = display.getScreen();
-
-    if (sessionActive) {
-        // Always show session screen when active
-        unsigned long elapsed = (millis() - sessionStartTime) / 1000;
-        unsigned long total = DEFAULT_SESSION_MINUTES * 60;
-        bool redOn = (currentMode == MODE_RED_ONLY || currentMode == MODE_DUAL ||
-                     (currentMode == MODE_ALTERNATING && !alternatePhase));
-        bool nirOn = (currentMode == MODE_NIR_ONLY || currentMode == MODE_DUAL ||
-                     (currentMode == MODE_ALTERNATING && alternatePhase));
-        display.showSession(elapsed, total, currentMode, redOn, nirOn);
+    drainTelemetry();
+
+    #if !RENDER_TASK_ENABLED
+    // Never wait on the panel: try again next interval
+    if (display.frameInFlight()) {
         return;
     }
+    #endif
+
+    #if DISPLAY_PROFILE
+    if (diagnosticsVisible) {
+        return;     // Drawn once on entry; stays until a button closes it
+    }
+    #endif
+
+    uint8_t battPercent = (uint8_t)constrain(
+        (dev.batteryVoltage - VBAT_CUTOFF) / (VBAT_FULL - VBAT_CUTOFF) * 100, 0, 100);
+    uint16_t centiVolts = (uint16_t)lroundf(dev.batteryVoltage * 100.0f);
+
+    // Snapshot everything the visible screen shows; the renderer draws
+    // from this copy only and skips it if it matches the panel
+    ViewModel view;
+    memset(&view, 0, sizeof(view));
+
+    Screen screen = ui.current_screen;
+    if (dev.sessionActive && screen != SCREEN_TELEMETRY) {
+        screen = SCREEN_SESSION;    // Session screen when active, unless watching telemetry
+    } else if (screen == SCREEN_SESSION) {
+        screen = SCREEN_HOME;       // No session to show
+    }
+    view.screen = screen;
 
-    // Idle screens
     switch (screen) {
-        case SCREEN_HOME:
-            display.showHome(batteryVoltage, battPercent, currentMode);
+        case SCREEN_SESSION:
+            view.session.elapsedSec = (millis() - dev.sessionStartTime) / 1000;
+            view.session.totalSec = DEFAULT_SESSION_MINUTES * 60;
+            view.session.mode = dev.currentMode;
+            view.session.redOn = (dev.currentMode == MODE_RED_ONLY || dev.currentMode == MODE_DUAL ||
+                                 (dev.currentMode == MODE_ALTERNATING && !dev.alternatePhase));
+            view.session.nirOn = (dev.currentMode == MODE_NIR_ONLY || dev.currentMode == MODE_DUAL ||
+                                 (dev.currentMode == MODE_ALTERNATING && dev.alternatePhase));
             break;
 
         case SCREEN_STATS:
-            display.showStats(lifetimeSessions, lifetimeMinutes, dailySessionCount);
+            view.stats.sessions = dev.lifetimeSessions;
+            view.stats.minutes = dev.lifetimeMinutes;
+            view.stats.dailySessions = dev.dailySessionCount;
             break;
 
         case SCREEN_SETTINGS:
-            display.showSettings(currentMode, menuSelectedIndex);
+            view.settings.mode = dev.currentMode;
+            view.settings.selectedIndex = ui.selected_mode - UI_MODE_RED_ONLY;
             break;
 
         case SCREEN_BATTERY:
-            display.showBattery(batteryVoltage, battPercent, false);
+            view.battery.centiVolts = centiVolts;
+            view.battery.percent = battPercent;
+            view.battery.charging = false;
             break;
 
         case SCREEN_SAFETY:
-            display.showSafety(batteryVoltage, temperature,
-                              overVoltageError, batteryVoltage < VBAT_CUTOFF, thermalWarning);
+            view.safety.centiVolts = centiVolts;
+            view.safety.deciDegrees = (int16_t)lroundf(dev.temperature * 10.0f);
+            view.safety.overVoltage = dev.overVoltageError;
+            view.safety.underVoltage = dev.batteryVoltage < VBAT_CUTOFF;
+            view.safety.thermal = dev.thermalWarning;
+            break;
+
+        case SCREEN_HISTORY: {
+            uint32_t total = historyStore.count();
+            const HistoryPage* page =
+                history_cache_page(&historyCache, history_screen_page(total, ui.history_page));
+            buildHistoryView(view, *page, total, ui.history_page);
+            break;
+        }
+
+        case SCREEN_TELEMETRY: {
+            // The last session stays up until the next starts; before the
+            // first there is only the last hour
+            bool lastHour = telemetryLastHour || sessionTrace.count == 0;
+            buildTelemetryView(view, lastHour ? hourTrace : sessionTrace, lastSample, lastHour);
             break;
+        }
 
         default:
-            display.showHome(batteryVoltage, battPercent, currentMode);
+            view.screen = SCREEN_HOME;
+            view.home.centiVolts = centiVolts;
+            view.home.battPercent = battPercent;
+            view.home.mode = dev.currentMode;
             break;
     }
+
+    #if RENDER_TASK_ENABLED
+    // Replace any snapshot the render task has not picked up yet. Left
+    // asleep when nothing changed, unless asked: a notice or direct draw
+    // needs a frame for the same view
+    if (!refreshPending && postedViewValid && memcmp(&view, &postedView, sizeof(view)) == 0) {
+        return;
+    }
+    refreshPending = false;
+    postedView = view;
+    postedViewValid = true;
+    xQueueOverwrite(viewQueue, &view);
+    #else
+    if (display.viewChanged(view)) {
+        display.render(view);
+    }
+    #endif
+}
+
+// Snapshot on the next pass rather than waiting out the update interval
+void refreshDisplay() {
+    #if RENDER_TASK_ENABLED
+    refreshPending = true;
+    #endif
+    sched_start(&scheduler, &refreshJob, millis(), 0, 0);
+}
+
+// =============================================================================
+// RENDER TASK (core 0)
+// =============================================================================
+
+#if RENDER_TASK_ENABLED
+void renderTask(void* arg) {
+    ViewModel view;
+    TickType_t wait = portMAX_DELAY;
+
+    // Draw at full clock, then let the chip scale down and sleep
+    esp_pm_lock_handle_t fullSpeed = NULL;
+    #if CONFIG_PM_ENABLE
+    esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "render", &fullSpeed);
+    #endif
+
+    for (;;) {
+        // Sleep until a snapshot arrives or the next animation frame is
+        // due; while a DMA frame is still going out, wake every tick to
+        // feed it. The last snapshot is kept for animation frames.
+        bool fresh = xQueueReceive(viewQueue, &view, wait) == pdTRUE;
+
+        #if CONFIG_PM_ENABLE
+        esp_pm_lock_acquire(fullSpeed);
+        #endif
+        xSemaphoreTake(displayLock, portMAX_DELAY);
+        display.service();
+        if ((fresh || display.frameDue()) && display.viewChanged(view)) {
+            display.render(view);
+        }
+        uint32_t delayUs = display.frameDelay();
+        if (display.frameInFlight()) {
+            wait = 1;
+        } else if (delayUs == PACER_IDLE) {
+            wait = portMAX_DELAY;
+        } else {
+            wait = pdMS_TO_TICKS((delayUs + 999) / 1000);
+        }
+        xSemaphoreGive(displayLock);
+        #if CONFIG_PM_ENABLE
+        esp_pm_lock_release(fullSpeed);
+        #endif
+    }
+}
+#endif
+
+// Bracket direct display calls from loop(): waits out the frame being
+// drawn and drops the pending snapshot so it cannot paint over an alert
+void lockDisplay() {
+    #if RENDER_TASK_ENABLED
+    xSemaphoreTake(displayLock, portMAX_DELAY);
+    xQueueReset(viewQueue);
+    #endif
+}
+
+void unlockDisplay() {
+    #if RENDER_TASK_ENABLED
+    xSemaphoreGive(displayLock);
+    #endif
+}
+
+// Queue a notification; the next frame overlays it on the current screen
+void postNotice(uint8_t level, const char* title, const char* text, uint16_t color) {
+    uint32_t duration = (level == NOTICE_CRITICAL) ? NOTICE_ALERT_MS : NOTICE_TOAST_MS;
+    #if RENDER_TASK_ENABLED
+    xSemaphoreTake(displayLock, portMAX_DELAY);     // Keeps the pending snapshot
+    #endif
+    display.notify(level, title, text, color, duration);
+    unlockDisplay();
+    refreshDisplay();
 }
 
 // =============================================================================
@@ -291,99 +762,187 @@ void updateDisplay() {
 // =============================================================================
 
 void handleButtons() {
-    Screen screen = display.getScreen();
-
-    // Button 1 (GPIO0) - Primary action / Navigate left
-    if (button1Pressed && !button1Handled) {
-        if (digitalRead(PIN_BUTTON_1) == HIGH) {
-            // Button released
-            unsigned long pressDuration = millis() - button1PressTime;
-
-            if (sessionActive) {
-                // During session: stop
-                stopSession();
-            } else if (screen == SCREEN_HOME) {
-                // Home screen: start session
-                if (pressDuration < BUTTON_LONG_PRESS_MS) {
-                    startSession();
-                    display.setScreen(SCREEN_SESSION);
-                }
-            } else if (screen == SCREEN_SETTINGS) {
-                // Settings: navigate up or back
-                if (menuSelectedIndex > 0) {
-                    menuSelectedIndex--;
-                } else {
-                    display.setScreen(SCREEN_HOME);
-                }
-            } else {
-                // Other screens: go back/previous
-                display.prevScreen();
-            }
+    // Only wait for a second click where the table gives double-clicks a
+    // meaning; elsewhere clicks act at once (starting and stopping never wait)
+    input_double_click(&inputRecognizer, 0, ui_handles(&ui, BUTTON_1_DOUBLE));
+    input_double_click(&inputRecognizer, 1, ui_handles(&ui, BUTTON_2_DOUBLE));
+
+    InputEdge edge;
+    while (input_ring_pop(&inputRing, &edge)) {
+        input_feed(&inputRecognizer, &edge);
+    }
+    input_tick(&inputRecognizer, micros());
 
-            button1Pressed = false;
-            button1Handled = true;
-            playTone(1000, 50);
-        }
+    InputEvent event;
+    while (input_event(&inputRecognizer, &event)) {
+        handleButtonEvent(event.event);
+        perf_record(&inputLatency, micros() - event.us);    // Gesture to action done
     }
+}
 
-    // Button 2 (GPIO14) - Secondary action / Navigate right
-    if (button2Pressed && !button2Handled) {
-        if (digitalRead(PIN_BUTTON_2) == HIGH) {
-            // Button released
-
-            if (sessionActive) {
-                // During session: no action (or could toggle mode)
-            } else if (screen == SCREEN_HOME) {
-                // Home screen: go to menu
-                display.setScreen(SCREEN_STATS);
-            } else if (screen == SCREEN_SETTINGS) {
-                // Settings: navigate down or select
-                if (menuSelectedIndex < 3) {
-                    menuSelectedIndex++;
-                } else {
-                    // Select current mode
-                    currentMode = (TreatmentMode)(menuSelectedIndex + 1);
-                    savePreferences();
-                    display.setScreen(SCREEN_HOME);
-                    Serial.printf("Mode changed to: %d\n", currentMode);
-                }
-            } else {
-                // Other screens: go to next
-                display.nextScreen();
-            }
+void handleButtonEvent(ButtonEvent event) {
+    #if DISPLAY_PROFILE
+    // Any button closes the diagnostics screen (not the hold that opened it)
+    if (diagnosticsVisible) {
+        if (event != BUTTON_1_REPEAT && event != BUTTON_2_REPEAT) {
+            diagnosticsVisible = false;
+        }
+        return;
+    }
+    #endif
 
-            button2Pressed = false;
-            button2Handled = true;
-            playTone(1200, 50);
+    // A press on the emergency screen only acknowledges it (one per trip)
+    if (emergencyLatched) {
+        #if RENDER_TASK_ENABLED
+        xSemaphoreTake(displayLock, portMAX_DELAY);
+        #endif
+        bool cleared = display.acknowledgeNotice();
+        unlockDisplay();
+        if (cleared) {
+            refreshDisplay();
+            return;
         }
+        emergencyLatched = false;
+    }
+
+    // The transition table moves between screens and pages; the actions
+    // that reach beyond the UI are carried out here
+    ui_set_history_pages(&ui, history_screen_count(historyStore.count()));
+    UIAction action = ui_handle_button(&ui, event);
+
+    switch (action) {
+        case ACTION_NONE:
+            return;
+
+        case ACTION_START_SESSION:
+            startSession();
+            break;
+
+        case ACTION_STOP_SESSION:
+            stopSession(HISTORY_END_STOPPED);
+            break;
+
+        case ACTION_CHANGE_MODE:
+        case ACTION_CONFIRM_SETTING:
+            setMode((TreatmentMode)ui.current_mode);
+            break;
+
+        case ACTION_TOGGLE_RANGE:
+            // Telemetry: switch between session and last hour
+            telemetryLastHour = !telemetryLastHour;
+            break;
+
+        #if DISPLAY_PROFILE
+        case ACTION_SHOW_DIAGNOSTICS:
+            // Hidden: render profile
+            diagnosticsVisible = true;
+            lockDisplay();
+            display.showDiagnostics();
+            display.dumpProfile();
+            unlockDisplay();
+            break;
+        #endif
+
+        default:
+            break;
+    }
+    refreshDisplay();
+
+    // Held buttons scroll silently
+    switch (event) {
+        case BUTTON_1_SHORT:
+        case BUTTON_1_LONG:
+        case BUTTON_1_DOUBLE:
+            playMelody(MELODY_CLICK_LEFT, MELODY_LENGTH(MELODY_CLICK_LEFT), MELODY_PRIORITY_CLICK);
+            break;
+        case BUTTON_2_SHORT:
+        case BUTTON_2_LONG:
+        case BUTTON_2_DOUBLE:
+            playMelody(MELODY_CLICK_RIGHT, MELODY_LENGTH(MELODY_CLICK_RIGHT), MELODY_PRIORITY_CLICK);
+            break;
+        default:
+            break;
     }
+}
 
-    // Reset handled state when released
-    if (digitalRead(PIN_BUTTON_1) == HIGH) button1Handled = false;
-    if (digitalRead(PIN_BUTTON_2) == HIGH) button2Handled = false;
+#if DISPLAY_PROFILE
+// Single-character commands on the serial console
+void handleSerialCommands() {
+    while (Serial.available()) {
+        switch (Serial.read()) {
+            case 'p':
+                lockDisplay();
+                display.dumpProfile();
+                unlockDisplay();
+                break;
+            case 'r':
+                lockDisplay();
+                display.resetProfile();
+                unlockDisplay();
+                Serial.println("Render profile reset");
+                break;
+            default:
+                break;
+        }
+    }
 }
+#endif
 
 // =============================================================================
 // PWM SETUP AND CONTROL
 // =============================================================================
 
-void setupPWM() {
-    // Configure LEDC for red channel
-    ledcSetup(PWM_CHANNEL_RED, PWM_FREQ, PWM_RESOLUTION);
-    ledcAttachPin(PIN_RED_LED, PWM_CHANNEL_RED);
-    ledcWrite(PWM_CHANNEL_RED, 0);
+// LEDC timers run from RC_FAST rather than APB: it keeps running in light
+// sleep and frequency scaling leaves it alone, so the LEDs and buzzer hold
+// steady while the CPU sleeps. The chip has one LEDC clock for all timers,
+// so every channel is set up here rather than through ledcSetup().
+static void setupPWMTimer(uint8_t timer, uint32_t freq) {
+    ledc_timer_config_t config = {};
+    config.speed_mode = LEDC_LOW_SPEED_MODE;
+    config.duty_resolution = (ledc_timer_bit_t)PWM_RESOLUTION;
+    config.timer_num = (ledc_timer_t)timer;
+    config.freq_hz = freq;
+    config.clk_cfg = LEDC_USE_RTC8M_CLK;
+    ledc_timer_config(&config);
+}
+
+static void setupPWMChannel(uint8_t channel, uint8_t timer, int pin) {
+    ledc_channel_config_t config = {};
+    config.gpio_num = pin;
+    config.speed_mode = LEDC_LOW_SPEED_MODE;
+    config.channel = (ledc_channel_t)channel;
+    config.intr_type = LEDC_INTR_DISABLE;
+    config.timer_sel = (ledc_timer_t)timer;
+    config.duty = 0;
+    ledc_channel_config(&config);
+}
 
-    // Configure LEDC for NIR channel
-    ledcSetup(PWM_CHANNEL_NIR, PWM_FREQ, PWM_RESOLUTION);
-    ledcAttachPin(PIN_NIR_LED, PWM_CHANNEL_NIR);
-    ledcWrite(PWM_CHANNEL_NIR, 0);
+void setupPWM() {
+    // Red and NIR share a timer
+    setupPWMTimer(PWM_TIMER_LEDS, PWM_FREQ);
+    setupPWMChannel(PWM_CHANNEL_RED, PWM_TIMER_LEDS, PIN_RED_LED);
+    setupPWMChannel(PWM_CHANNEL_NIR, PWM_TIMER_LEDS, PIN_NIR_LED);
 
+    ledLock = xSemaphoreCreateMutex();     // Priority inheritance: the safety task never waits long
     Serial.println("PWM initialized (dual channel)");
 }
 
+// Duty out of 2^PWM_RESOLUTION; safe from any task
+void writePWM(uint8_t channel, uint32_t duty) {
+    ledc_set_duty(LEDC_LOW_SPEED_MODE, (ledc_channel_t)channel, duty);
+    ledc_update_duty(LEDC_LOW_SPEED_MODE, (ledc_channel_t)channel);
+}
+
 void setLEDs(uint8_t red, uint8_t nir) {
-    ledcWrite(PWM_CHANNEL_RED, red);
-    ledcWrite(PWM_CHANNEL_NIR, nir);
+    xSemaphoreTake(ledLock, portMAX_DELAY);
+    if (supervisor.fault != SAFETY_OK) {
+        red = 0;        // Held off until the supervisor's readings recover
+        nir = 0;
+    }
+    writePWM(PWM_CHANNEL_RED, (red == 255) ? (1 << PWM_RESOLUTION) : red);  // 255 is fully on
+    writePWM(PWM_CHANNEL_NIR, (nir == 255) ? (1 << PWM_RESOLUTION) : nir);
+    xSemaphoreGive(ledLock);
+    dev.ledDuty = (uint8_t)(((red > nir) ? red : nir) * 100 / 255);
 }
 
 void applyMode(TreatmentMode mode) {
@@ -392,20 +951,20 @@ void applyMode(TreatmentMode mode) {
             setLEDs(0, 0);
             break;
         case MODE_RED_ONLY:
-            setLEDs(brightness, 0);
+            setLEDs(dev.brightness, 0);
             break;
         case MODE_NIR_ONLY:
-            setLEDs(0, brightness);
+            setLEDs(0, dev.brightness);
             break;
         case MODE_DUAL:
-            setLEDs(brightness, brightness);
+            setLEDs(dev.brightness, dev.brightness);
             break;
         case MODE_ALTERNATING:
             // Handled in updateAlternating()
-            if (alternatePhase) {
-                setLEDs(0, brightness);
+            if (dev.alternatePhase) {
+                setLEDs(0, dev.brightness);
             } else {
-                setLEDs(brightness, 0);
+                setLEDs(dev.brightness, 0);
             }
             break;
         default:
@@ -414,19 +973,18 @@ void applyMode(TreatmentMode mode) {
     }
 }
 
+// Runs every ALTERNATE_PERIOD_SEC while an alternating session is active
 void updateAlternating() {
-    if (millis() - lastAlternateTime >= ALTERNATE_PERIOD_SEC * 1000) {
-        alternatePhase = !alternatePhase;
-        lastAlternateTime = millis();
+    dev.alternatePhase = !dev.alternatePhase;
 
-        if (alternatePhase) {
-            setLEDs(0, brightness);
-            Serial.println("Alternating: NIR phase");
-        } else {
-            setLEDs(brightness, 0);
-            Serial.println("Alternating: RED phase");
-        }
+    if (dev.alternatePhase) {
+        setLEDs(0, dev.brightness);
+        Serial.println("Alternating: NIR phase");
+    } else {
+        setLEDs(dev.brightness, 0);
+        Serial.println("Alternating: RED phase");
     }
+    refreshDisplay();
 }
 
 // =============================================================================
@@ -439,35 +997,40 @@ void startSession() {
         return;  // Safety check failed, reason already logged
     }
 
-    sessionActive = true;
-    dailySessionCount++;
-    sessionStartTime = millis();
-    lastAlternateTime = millis();
-    alternatePhase = false;
+    dev.sessionActive = true;
+    ui_set_session_active(&ui, true);
+    dev.dailySessionCount++;
+    dev.sessionStartTime = millis();
+    telemetry_trace_init(&sessionTrace, 1, true);
+    dev.alternatePhase = false;
 
-    applyMode(currentMode);
+    applyMode(dev.currentMode);
+    startSessionJobs();
 
-    lifetimeSessions++;
+    dev.lifetimeSessions++;
     savePreferences();
 
     const char* modeNames[] = {"OFF", "RED", "NIR", "DUAL", "ALT"};
     Serial.printf("Session started - Mode: %s, Duration: %d min\n",
-                 modeNames[currentMode], DEFAULT_SESSION_MINUTES);
+                 modeNames[dev.currentMode], DEFAULT_SESSION_MINUTES);
 
     playTone(TONE_START, 200);
     digitalWrite(PIN_STATUS_LED, HIGH);
 }
 
-void stopSession() {
-    sessionActive = false;
-    lastSessionEndTime = millis();  // Track for session gap enforcement
+void stopSession(HistoryEnd end) {
+    recordSession(end);
+    dev.sessionActive = false;
+    ui_set_session_active(&ui, false);
+    stopSessionJobs();
+    dev.lastSessionEndTime = millis();  // Track for session gap enforcement
 
     // Calculate session duration
-    unsigned long elapsed = (millis() - sessionStartTime) / 1000;
-    totalSessionSeconds += elapsed;
+    unsigned long elapsed = (millis() - dev.sessionStartTime) / 1000;
+    dev.totalSessionSeconds += elapsed;
 
     // Update lifetime minutes
-    lifetimeMinutes += elapsed / 60;
+    dev.lifetimeMinutes += elapsed / 60;
     savePreferences();
 
     // Turn off LEDs
@@ -476,27 +1039,23 @@ void stopSession() {
     Serial.printf("Session stopped. Duration: %lu:%02lu\n",
                  elapsed / 60, elapsed % 60);
     Serial.printf("Lifetime: %lu sessions, %lu minutes\n",
-                 lifetimeSessions, lifetimeMinutes);
-    Serial.printf("Daily sessions: %d/%d\n", dailySessionCount, MAX_DAILY_SESSIONS);
+                 dev.lifetimeSessions, dev.lifetimeMinutes);
+    Serial.printf("Daily sessions: %d/%d\n", dev.dailySessionCount, MAX_DAILY_SESSIONS);
 
     playTone(TONE_STOP, 200);
     digitalWrite(PIN_STATUS_LED, LOW);
 }
 
-void cycleMode() {
-    currentMode = (TreatmentMode)((currentMode + 1) % MODE_COUNT);
-    if (currentMode == MODE_OFF) {
-        currentMode = MODE_RED_ONLY;  // Skip OFF mode in cycle
-    }
-
+void setMode(TreatmentMode mode) {
+    dev.currentMode = mode;
     savePreferences();
 
     const char* modeNames[] = {"OFF", "RED", "NIR", "DUAL", "ALT"};
-    Serial.printf("Mode changed to: %s\n", modeNames[currentMode]);
+    Serial.printf("Mode changed to: %s\n", modeNames[dev.currentMode]);
 
     // Feedback: blink count indicates mode
-    blinkStatus(currentMode, 150, 150);
-    playTone(1000 + currentMode * 200, 100);
+    blinkStatus(dev.currentMode, 150, 150);
+    playTone(1000 + dev.currentMode * 200, 100);
 }
 
 // =============================================================================
@@ -504,35 +1063,97 @@ void cycleMode() {
 // =============================================================================
 
 void setupButton() {
+    input_ring_init(&inputRing);
+    input_init(&inputRecognizer, micros(), BUTTON_DEBOUNCE_MS, BUTTON_LONG_PRESS_MS,
+               BUTTON_DOUBLE_CLICK_MS, BUTTON_REPEAT_MS);
+    perf_init(&inputLatency);
+
+    // Level interrupts, flipped on each edge: a level is what wakes the
+    // chip from light sleep, and the GPIO wakeup shares the interrupt type
     pinMode(PIN_BUTTON_1, INPUT_PULLUP);
     pinMode(PIN_BUTTON_2, INPUT_PULLUP);
-    attachInterrupt(digitalPinToInterrupt(PIN_BUTTON_1), button1ISR, FALLING);
-    attachInterrupt(digitalPinToInterrupt(PIN_BUTTON_2), button2ISR, FALLING);
+    attachInterrupt(digitalPinToInterrupt(PIN_BUTTON_1), button1ISR, ONLOW_WE);
+    attachInterrupt(digitalPinToInterrupt(PIN_BUTTON_2), button2ISR, ONLOW_WE);
     Serial.println("Buttons initialized (2x on T-Display S3)");
 }
 
-void IRAM_ATTR button1ISR() {
-    static unsigned long lastInterrupt = 0;
-    unsigned long now = millis();
+// Wait for the opposite level: each interrupt is then one edge
+static inline void IRAM_ATTR armOppositeLevel(uint8_t pin, bool pressed) {
+    gpio_ll_set_intr_type(&GPIO, pin, pressed ? GPIO_INTR_HIGH_LEVEL : GPIO_INTR_LOW_LEVEL);
+}
 
-    // Debounce
-    if (now - lastInterrupt > BUTTON_DEBOUNCE_MS) {
-        button1Pressed = true;
-        button1PressTime = now;
-        lastInterrupt = now;
-    }
+// Both edges, bounces included: the recognizer debounces
+void IRAM_ATTR button1ISR() {
+    bool pressed = digitalRead(PIN_BUTTON_1) == LOW;
+    armOppositeLevel(PIN_BUTTON_1, pressed);
+    input_ring_push(&inputRing, micros(), 0, pressed);
+
+    // Wake loop() from its sleep
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(loopTask, &woken);
+    portYIELD_FROM_ISR(woken);
 }
 
 void IRAM_ATTR button2ISR() {
-    static unsigned long lastInterrupt = 0;
-    unsigned long now = millis();
+    bool pressed = digitalRead(PIN_BUTTON_2) == LOW;
+    armOppositeLevel(PIN_BUTTON_2, pressed);
+    input_ring_push(&inputRing, micros(), 1, pressed);
+
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(loopTask, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+// =============================================================================
+// POWER MANAGEMENT
+// =============================================================================
+
+// Every task blocks on a timer, a queue or a notification, so between
+// events the idle task has the chip to itself. With tickless idle it then
+// light-sleeps until the next timer or a button; otherwise the CPU clock
+// still drops to PM_MIN_FREQ_MHZ while nothing holds it up.
+void setupPower() {
+    // Keep RC_FAST (the PWM clock) and the output pins as they are through
+    // light sleep
+    esp_sleep_pd_config(ESP_PD_DOMAIN_RTC8M, ESP_PD_OPTION_ON);
+    #if SOC_GPIO_SUPPORT_SLP_SWITCH
+    const uint8_t outputs[] = {
+        PIN_RED_LED, PIN_NIR_LED, PIN_TFT_BL, PIN_POWER_ON,
+        #ifdef PIN_BUZZER
+        PIN_BUZZER,
+        #endif
+    };
+    for (uint8_t i = 0; i < sizeof(outputs); i++) {
+        gpio_sleep_sel_dis((gpio_num_t)outputs[i]);
+    }
+    #endif
+    esp_sleep_enable_gpio_wakeup();     // Button level interrupts
 
-    // Debounce
-    if (now - lastInterrupt > BUTTON_DEBOUNCE_MS) {
-        button2Pressed = true;
-        button2PressTime = now;
-        lastInterrupt = now;
+    #if CONFIG_PM_ENABLE
+    #if ESP_IDF_VERSION_MAJOR >= 5
+    esp_pm_config_t pm = {};
+    #else
+    esp_pm_config_esp32s3_t pm = {};
+    #endif
+    pm.max_freq_mhz = getCpuFrequencyMhz();
+    pm.min_freq_mhz = PM_MIN_FREQ_MHZ;
+    #if CONFIG_FREERTOS_USE_TICKLESS_IDLE
+    pm.light_sleep_enable = LIGHT_SLEEP_ENABLED;
+    #endif
+    esp_err_t err = esp_pm_configure(&pm);
+    if (err != ESP_OK) {
+        Serial.printf("Power: not configured (%s)\n", esp_err_to_name(err));
+        return;
     }
+    #if CONFIG_FREERTOS_USE_TICKLESS_IDLE
+    const char* sleepMode = pm.light_sleep_enable ? "on" : "off";
+    #else
+    const char* sleepMode = "unavailable (core built without tickless idle)";
+    #endif
+    Serial.printf("Power: %d-%d MHz, light sleep %s\n", pm.min_freq_mhz, pm.max_freq_mhz, sleepMode);
+    #else
+    Serial.println("Power: core built without power management, full clock");
+    #endif
 }
 
 // =============================================================================
@@ -547,11 +1168,11 @@ void setupBattery() {
 }
 
 float readBatteryVoltage() {
-    // Average multiple readings for stability
+    // Average multiple readings for stability (back to back: the safety
+    // task calls this every period)
     long sum = 0;
     for (int i = 0; i < 10; i++) {
         sum += analogRead(PIN_VBAT_ADC);
-        delay(1);
     }
     float adcValue = sum / 10.0;
 
@@ -562,37 +1183,26 @@ float readBatteryVoltage() {
     return vBat;
 }
 
+// Warnings from the safety task's latest reading; it handles the cutoffs
 void checkBattery() {
-    batteryVoltage = readBatteryVoltage();
-
     // Calculate percentage (linear approximation)
-    float percent = (batteryVoltage - VBAT_CUTOFF) / (VBAT_FULL - VBAT_CUTOFF) * 100.0;
+    float percent = (dev.batteryVoltage - VBAT_CUTOFF) / (VBAT_FULL - VBAT_CUTOFF) * 100.0;
     percent = constrain(percent, 0, 100);
 
-    // CRITICAL: Over-voltage protection (wrong charger, damaged BMS)
-    if (batteryVoltage > VBAT_OVERVOLTAGE) {
-        overVoltageError = true;
-        emergencyShutdown("OVER-VOLTAGE DETECTED!");
-        Serial.printf("DANGER: Battery voltage %.2fV exceeds safe limit!\n", batteryVoltage);
-        Serial.println("Check charger and BMS immediately.");
-        return;
-    } else {
-        overVoltageError = false;
-    }
-
-    // CRITICAL: Under-voltage protection
-    if (batteryVoltage < VBAT_CUTOFF) {
-        emergencyShutdown("UNDER-VOLTAGE - Battery critically low!");
+    // Over- and under-voltage: already cut off by the supervisor
+    dev.overVoltageError = (dev.batteryVoltage > VBAT_OVERVOLTAGE);
+    if (dev.overVoltageError || dev.batteryVoltage < VBAT_CUTOFF) {
         return;
     }
 
     // Low battery warning
-    if (batteryVoltage < VBAT_LOW && !lowBatteryWarning) {
-        lowBatteryWarning = true;
-        Serial.printf("WARNING: Low battery! %.2fV (%.0f%%)\n", batteryVoltage, percent);
+    if (dev.batteryVoltage < VBAT_LOW && !dev.lowBatteryWarning) {
+        dev.lowBatteryWarning = true;
+        Serial.printf("WARNING: Low battery! %.2fV (%.0f%%)\n", dev.batteryVoltage, percent);
         playTone(TONE_LOW_BAT, 100);
-    } else if (batteryVoltage >= VBAT_LOW) {
-        lowBatteryWarning = false;
+        postNotice(NOTICE_WARNING, "LOW BATTERY", "Charge soon", COLOR_YELLOW);
+    } else if (dev.batteryVoltage >= VBAT_LOW) {
+        dev.lowBatteryWarning = false;
     }
 }
 
@@ -617,35 +1227,32 @@ float readTemperature() {
     #endif
 }
 
+// Derating from the safety task's latest reading; it handles the cutoff
 void checkThermal() {
     #if TEMP_ENABLED
-    temperature = readTemperature();
-
-    // CRITICAL: Thermal cutoff
-    if (temperature >= TEMP_CUTOFF_C) {
-        emergencyShutdown("THERMAL CUTOFF - Overheating!");
-        Serial.printf("DANGER: Temperature %.1fC exceeds safe limit!\n", temperature);
+    if (dev.temperature >= TEMP_CUTOFF_C) {
         return;
     }
 
     // Thermal warning
-    if (temperature >= TEMP_WARNING_C && !thermalWarning) {
-        thermalWarning = true;
-        Serial.printf("WARNING: High temperature! %.1fC\n", temperature);
+    if (dev.temperature >= TEMP_WARNING_C && !dev.thermalWarning) {
+        dev.thermalWarning = true;
+        Serial.printf("WARNING: High temperature! %.1fC\n", dev.temperature);
         playTone(TONE_LOW_BAT, 100);
+        postNotice(NOTICE_WARNING, "HIGH TEMP", "Power reduced to 50%", COLOR_ORANGE);
 
         // Reduce power to 50% as protective measure
-        brightness = 128;
-        if (sessionActive) {
-            applyMode(currentMode);
+        dev.brightness = 128;
+        if (dev.sessionActive) {
+            applyMode(dev.currentMode);
             Serial.println("Power reduced to 50% due to temperature.");
         }
-    } else if (temperature < TEMP_WARNING_C - 5) {  // 5C hysteresis
-        if (thermalWarning) {
-            thermalWarning = false;
-            brightness = 255;  // Restore full power
-            if (sessionActive) {
-                applyMode(currentMode);
+    } else if (dev.temperature < TEMP_WARNING_C - 5) {  // 5C hysteresis
+        if (dev.thermalWarning) {
+            dev.thermalWarning = false;
+            dev.brightness = 255;  // Restore full power
+            if (dev.sessionActive) {
+                applyMode(dev.currentMode);
                 Serial.println("Temperature normal - full power restored.");
             }
         }
@@ -661,48 +1268,55 @@ bool checkSafetyLimits() {
     // Check all safety conditions before starting session
 
     // 1. Battery voltage in safe range
-    if (batteryVoltage < VBAT_CUTOFF) {
+    if (dev.batteryVoltage < VBAT_CUTOFF) {
         Serial.println("BLOCKED: Battery too low");
         playTone(TONE_LOW_BAT, 200);
+        postNotice(NOTICE_CRITICAL, "BLOCKED", "Battery too low", COLOR_DANGER);
         return false;
     }
 
-    if (batteryVoltage > VBAT_OVERVOLTAGE) {
+    if (dev.batteryVoltage > VBAT_OVERVOLTAGE) {
         Serial.println("BLOCKED: Battery voltage too high - check charger!");
         playTone(TONE_LOW_BAT, 500);
+        postNotice(NOTICE_CRITICAL, "BLOCKED", "Check charger", COLOR_DANGER);
         return false;
     }
 
     // 2. Thermal check
     #if TEMP_ENABLED
-    if (temperature >= TEMP_CUTOFF_C) {
+    if (dev.temperature >= TEMP_CUTOFF_C) {
         Serial.println("BLOCKED: Temperature too high");
         playTone(TONE_LOW_BAT, 200);
+        postNotice(NOTICE_CRITICAL, "BLOCKED", "Temperature too high", COLOR_DANGER);
         return false;
     }
     #endif
 
     // 3. Daily session limit (prevent overuse)
     // Reset counter if it's been >24 hours
-    if (millis() - dayStartTime > 24UL * 60 * 60 * 1000) {
-        dailySessionCount = 0;
-        dayStartTime = millis();
+    if (millis() - dev.dayStartTime > 24UL * 60 * 60 * 1000) {
+        dev.dailySessionCount = 0;
+        dev.dayStartTime = millis();
     }
 
-    if (dailySessionCount >= MAX_DAILY_SESSIONS) {
+    if (dev.dailySessionCount >= MAX_DAILY_SESSIONS) {
         Serial.printf("BLOCKED: Daily limit reached (%d sessions)\n", MAX_DAILY_SESSIONS);
         Serial.println("Rest recommended. Wait 24 hours or power cycle to reset.");
         playTone(TONE_LOW_BAT, 200);
+        postNotice(NOTICE_CRITICAL, "BLOCKED", "Daily limit reached", COLOR_DANGER);
         return false;
     }
 
     // 4. Minimum gap between sessions
-    if (lastSessionEndTime > 0) {
-        unsigned long gapMinutes = (millis() - lastSessionEndTime) / 60000;
+    if (dev.lastSessionEndTime > 0) {
+        unsigned long gapMinutes = (millis() - dev.lastSessionEndTime) / 60000;
         if (gapMinutes < MIN_SESSION_GAP_MIN) {
             Serial.printf("BLOCKED: Wait %lu more minutes between sessions\n",
                          MIN_SESSION_GAP_MIN - gapMinutes);
             playTone(TONE_LOW_BAT, 200);
+            char text[NOTICE_TEXT_LEN];
+            snprintf(text, sizeof(text), "Wait %lu more min", MIN_SESSION_GAP_MIN - gapMinutes);
+            postNotice(NOTICE_CRITICAL, "BLOCKED", text, COLOR_DANGER);
             return false;
         }
     }
@@ -718,18 +1332,137 @@ void emergencyShutdown(const char* reason) {
 
     // Immediately disable all LEDs
     setLEDs(0, 0);
-    sessionActive = false;
+    if (dev.sessionActive) {
+        recordSession(HISTORY_END_FAULT);
+    }
+    dev.sessionActive = false;
+    ui_set_session_active(&ui, false);
+    stopSessionJobs();
+
+    // Emergency screen: stays over every view until a button acknowledges it
+    #if RENDER_TASK_ENABLED
+    xSemaphoreTake(displayLock, portMAX_DELAY);     // Keeps the pending snapshot
+    #endif
+    display.notify(NOTICE_CRITICAL, "EMERGENCY", reason, COLOR_DANGER, NOTICE_STICKY);
+    unlockDisplay();
+    emergencyLatched = true;
+    refreshDisplay();
 
-    // Show emergency screen
-    display.showEmergency(reason);
+    // Alarm pattern (preempts anything playing)
+    playMelody(MELODY_ALARM, MELODY_LENGTH(MELODY_ALARM), MELODY_PRIORITY_ALARM);
+}
 
-    // Alarm pattern
-    for (int i = 0; i < 5; i++) {
-        playTone(TONE_LOW_BAT, 200);
-        delay(200);
+// =============================================================================
+// SAFETY SUPERVISOR (highest priority task)
+// =============================================================================
+
+void setupSafety() {
+    supervisor_init(&supervisor, micros(), SAFETY_PERIOD_MS, SAFETY_DEADLINE_MS);
+    xTaskCreatePinnedToCore(safetyTask, "safety", SAFETY_TASK_STACK, NULL,
+                            SAFETY_TASK_PRIORITY, &safetyTaskHandle, SAFETY_TASK_CORE);
+    Serial.printf("Safety supervisor: every %d ms (%d ms idle), deadline %d ms\n",
+                 SAFETY_PERIOD_MS, SAFETY_IDLE_PERIOD_MS, SAFETY_DEADLINE_MS);
+}
+
+// Fixed-rate check (slower while idle): on a fault the LEDs go off here,
+// preempting whatever loop() is doing, and loop() is woken to stop the
+// session and alarm
+void safetyTask(void* arg) {
+    for (;;) {
+        supervisor_begin(&supervisor, micros());
+
+        SensorState sensors;
+        sensors.batteryVoltage = readBatteryVoltage();
+        sensors.temperature = readTemperature();
+        sensors.sampledMs = millis();
+        sensor_state_publish(&sensorChannel, &sensors);
+
+        DeviceState state;
+        device_state_read(&deviceChannel, &state);
+        uint32_t elapsed = state.sessionActive ? (sensors.sampledMs - state.sessionStartTime) / 1000 : 0;
+        float temp = TEMP_ENABLED ? sensors.temperature : SUPERVISOR_NO_SENSOR;
+        uint32_t trips = supervisor.trips;
+        if (supervisor_check(&supervisor, sensors.batteryVoltage, temp, state.sessionActive, elapsed)) {
+            xSemaphoreTake(ledLock, portMAX_DELAY);
+            writePWM(PWM_CHANNEL_RED, 0);
+            writePWM(PWM_CHANNEL_NIR, 0);
+            xSemaphoreGive(ledLock);
+            supervisor_leds_off(&supervisor, micros());
+        }
+        supervisor_end(&supervisor, micros());
+
+        if (supervisor.trips != trips) {
+            xTaskNotifyGive(loopTask);
+        }
+
+        // Nothing to cut off with no session and the LEDs dark: check
+        // rarely, until loop() wakes us because they may light
+        bool lit = state.sessionActive || state.ledDuty > 0;
+        supervisor_set_period(&supervisor, micros(), lit ? SAFETY_PERIOD_MS : SAFETY_IDLE_PERIOD_MS);
+        for (;;) {
+            int32_t waitUs = (int32_t)(supervisor.releaseUs - micros());
+            if (waitUs <= 0) {
+                break;
+            }
+            if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS((waitUs + 999) / 1000))) {
+                supervisor_set_period(&supervisor, micros(), SAFETY_PERIOD_MS);
+            }
+        }
     }
 }
 
+// Latest safety task readings into dev, for this pass to act on
+void pullSensorState() {
+    SensorState sensors;
+    sensor_state_read(&sensorChannel, &sensors);
+    if (sensors.sampledMs == 0) {
+        return;     // Keep the setup() readings until the first sample
+    }
+    dev.batteryVoltage = sensors.batteryVoltage;
+    dev.temperature = sensors.temperature;
+}
+
+// The LEDs are already off: record the session, alarm and explain
+void handleSafetyTrip() {
+    uint32_t trips = __atomic_load_n(&supervisor.trips, __ATOMIC_ACQUIRE);
+    if (trips == safetyTripsHandled) {
+        return;
+    }
+    safetyTripsHandled = trips;
+
+    switch (supervisor.tripFault) {
+        case SAFETY_ERR_OVERVOLTAGE:
+            // Wrong charger, damaged BMS
+            dev.overVoltageError = true;
+            emergencyShutdown("OVER-VOLTAGE DETECTED!");
+            Serial.printf("DANGER: Battery voltage %.2fV exceeds safe limit!\n", dev.batteryVoltage);
+            Serial.println("Check charger and BMS immediately.");
+            break;
+
+        case SAFETY_ERR_UNDERVOLTAGE:
+            emergencyShutdown("UNDER-VOLTAGE: battery low");
+            break;
+
+        case SAFETY_ERR_THERMAL:
+            emergencyShutdown("THERMAL CUTOFF: overheating");
+            Serial.printf("DANGER: Temperature %.1fC exceeds safe limit!\n", dev.temperature);
+            break;
+
+        case SAFETY_ERR_SESSION_TOO_LONG:
+            if (dev.sessionActive) {
+                Serial.println("Max session time reached - safety shutoff");
+                stopSession(HISTORY_END_TIME_LIMIT);
+                postNotice(NOTICE_WARNING, "TIME LIMIT", "Safety shutoff", COLOR_ORANGE);
+            }
+            break;
+
+        default:
+            break;
+    }
+    Serial.printf("Safety: LEDs cut %lu us into the check\n",
+                 (unsigned long)supervisor.offLatencyUs);
+}
+
 // =============================================================================
 // PREFERENCES (FLASH STORAGE)
 // =============================================================================
@@ -737,13 +1470,13 @@ void emergencyShutdown(const char* reason) {
 void loadPreferences() {
     prefs.begin(PREFS_NAMESPACE, true);  // Read-only
 
-    lifetimeSessions = prefs.getULong(PREFS_KEY_SESSIONS, 0);
-    lifetimeMinutes = prefs.getULong(PREFS_KEY_MINUTES, 0);
-    currentMode = (TreatmentMode)prefs.getUChar(PREFS_KEY_MODE, DEFAULT_MODE);
+    dev.lifetimeSessions = prefs.getULong(PREFS_KEY_SESSIONS, 0);
+    dev.lifetimeMinutes = prefs.getULong(PREFS_KEY_MINUTES, 0);
+    dev.currentMode = (TreatmentMode)prefs.getUChar(PREFS_KEY_MODE, DEFAULT_MODE);
 
     // Validate mode
-    if (currentMode >= MODE_COUNT || currentMode == MODE_OFF) {
-        currentMode = DEFAULT_MODE;
+    if (dev.currentMode >= MODE_COUNT || dev.currentMode == MODE_OFF) {
+        dev.currentMode = DEFAULT_MODE;
     }
 
     prefs.end();
@@ -753,9 +1486,9 @@ void loadPreferences() {
 void savePreferences() {
     prefs.begin(PREFS_NAMESPACE, false);  // Read-write
 
-    prefs.putULong(PREFS_KEY_SESSIONS, lifetimeSessions);
-    prefs.putULong(PREFS_KEY_MINUTES, lifetimeMinutes);
-    prefs.putUChar(PREFS_KEY_MODE, currentMode);
+    prefs.putULong(PREFS_KEY_SESSIONS, dev.lifetimeSessions);
+    prefs.putULong(PREFS_KEY_MINUTES, dev.lifetimeMinutes);
+    prefs.putUChar(PREFS_KEY_MODE, dev.currentMode);
 
     prefs.end();
 }
@@ -764,28 +1497,36 @@ void savePreferences() {
 // USER FEEDBACK
 // =============================================================================
 
+// Blink count times; returns at once, the pattern runs from blinkJob
 void blinkStatus(int count, int onTime, int offTime) {
-    for (int i = 0; i < count; i++) {
-        digitalWrite(PIN_STATUS_LED, HIGH);
-        delay(onTime);
-        digitalWrite(PIN_STATUS_LED, LOW);
-        if (i < count - 1) delay(offTime);
+    if (count <= 0) {
+        return;
     }
+    blinkEdges = count * 2 - 1;     // Off, then on and off again per blink
+    blinkOnMs = onTime;
+    blinkOffMs = offTime;
+    digitalWrite(PIN_STATUS_LED, HIGH);
+    sched_start(&scheduler, &blinkJob, millis(), onTime, 0);
 }
 
+void setupBuzzer() {
+    #ifdef PIN_BUZZER
+    setupPWMTimer(PWM_TIMER_BUZZER, TONE_START);     // Silent until a note sets the duty
+    setupPWMChannel(PWM_CHANNEL_BUZZER, PWM_TIMER_BUZZER, PIN_BUZZER);
+    #endif
+    melody_init(&melodySeq);
+}
+
+// Single note; returns at once, the note plays in the background
 void playTone(int freq, int duration) {
-    // Simple tone using digitalWrite toggle
-    // For proper tone, use ledcWriteTone or external buzzer driver
+    ToneNote note = {(uint16_t)freq, (uint16_t)duration};
+    playMelody(&note, 1, MELODY_PRIORITY_EVENT);
+}
+
+void playMelody(const ToneNote* notes, uint8_t count, uint8_t priority) {
     #ifdef PIN_BUZZER
-    int period = 1000000 / freq;
-    int halfPeriod = period / 2;
-    unsigned long start = millis();
-
-    while (millis() - start < (unsigned long)duration) {
-        digitalWrite(PIN_BUZZER, HIGH);
-        delayMicroseconds(halfPeriod);
-        digitalWrite(PIN_BUZZER, LOW);
-        delayMicroseconds(halfPeriod);
+    if (melody_play(&melodySeq, notes, count, priority, millis())) {
+        runTone(NULL);      // First note sounds now
     }
     #endif
 }
@@ -0,0 +1,198 @@
+/**
+ * Roxy RedLight v2.0 - Animation Unit Tests
+ *
+ * Run with: pio test -e native -f test_anim
+ *
+ * Tests fixed-point easing, tween retargeting and frame pacing
+ */
+
+#include <unity.h>
+#include "anim.h"
+
+// =============================================================================
+// TEST FIXTURES
+// =============================================================================
+
+#define PERIOD_US   33333   // 30 fps
+
+static Tween tween;
+static FramePacer pacer;
+
+void setUp(void) {
+    tween_set(&tween, 0);
+    pacer_init(&pacer, PERIOD_US, 50);
+}
+
+void tearDown(void) {
+    // Nothing to clean up
+}
+
+// =============================================================================
+// EASING TESTS
+// =============================================================================
+
+void test_ease_endpoints_exact(void) {
+    for (uint8_t e = EASE_LINEAR; e <= EASE_IN_OUT; e++) {
+        TEST_ASSERT_EQUAL_UINT32(0, anim_ease(e, 0));
+        TEST_ASSERT_EQUAL_UINT32(ANIM_ONE, anim_ease(e, ANIM_ONE));
+        TEST_ASSERT_EQUAL_UINT32(ANIM_ONE, anim_ease(e, 2 * ANIM_ONE));  // Clamped
+    }
+}
+
+void test_ease_monotonic(void) {
+    for (uint8_t e = EASE_LINEAR; e <= EASE_IN_OUT; e++) {
+        uint32_t prev = 0;
+        for (uint32_t t = 0; t <= ANIM_ONE; t += 257) {
+            uint32_t v = anim_ease(e, t);
+            TEST_ASSERT_GREATER_OR_EQUAL_UINT32(prev, v);
+            prev = v;
+        }
+    }
+}
+
+void test_ease_shapes(void) {
+    uint32_t half = ANIM_ONE / 2;
+    TEST_ASSERT_EQUAL_UINT32(ANIM_ONE / 4, anim_ease(EASE_IN, half));
+    TEST_ASSERT_EQUAL_UINT32(3 * ANIM_ONE / 4, anim_ease(EASE_OUT, half));
+    TEST_ASSERT_EQUAL_UINT32(half, anim_ease(EASE_IN_OUT, half));
+}
+
+void test_lerp_rounds_and_handles_negative(void) {
+    TEST_ASSERT_EQUAL_INT32(50, anim_lerp(0, 100, ANIM_ONE / 2));
+    TEST_ASSERT_EQUAL_INT32(-50, anim_lerp(0, -100, ANIM_ONE / 2));
+    TEST_ASSERT_EQUAL_INT32(1, anim_lerp(0, 2, ANIM_ONE / 2));
+    TEST_ASSERT_EQUAL_INT32(170, anim_lerp(0, 170, ANIM_ONE));
+}
+
+void test_progress_wraps_timer(void) {
+    // Interval spanning the 32-bit rollover
+    uint32_t start = 0xFFFFFF00UL;
+    TEST_ASSERT_EQUAL_UINT32(ANIM_ONE / 2, anim_progress(start, 0x200, 0));
+    TEST_ASSERT_EQUAL_UINT32(ANIM_ONE, anim_progress(start, 0x200, 0x200));
+    TEST_ASSERT_EQUAL_UINT32(0, anim_progress(start, 0x200, start - 10));
+}
+
+void test_pulse_cycle(void) {
+    TEST_ASSERT_EQUAL_UINT32(0, anim_pulse(0, 1000));
+    TEST_ASSERT_EQUAL_UINT32(ANIM_ONE, anim_pulse(500, 1000));
+    TEST_ASSERT_EQUAL_UINT32(anim_pulse(250, 1000), anim_pulse(750, 1000));
+    TEST_ASSERT_EQUAL_UINT32(anim_pulse(100, 1000), anim_pulse(1100, 1000));
+}
+
+// =============================================================================
+// TWEEN TESTS
+// =============================================================================
+
+void test_tween_reaches_target(void) {
+    tween_to(&tween, 100, 1000, 300, EASE_LINEAR);
+
+    TEST_ASSERT_EQUAL_INT32(0, tween_value(&tween, 1000));
+    TEST_ASSERT_EQUAL_INT32(50, tween_value(&tween, 1150));
+    TEST_ASSERT_TRUE(tween_active(&tween, 1299));
+    TEST_ASSERT_EQUAL_INT32(100, tween_value(&tween, 1300));
+    TEST_ASSERT_FALSE(tween_active(&tween, 1300));
+}
+
+void test_tween_same_target_keeps_running(void) {
+    tween_to(&tween, 100, 1000, 300, EASE_LINEAR);
+    tween_to(&tween, 100, 1150, 300, EASE_LINEAR);  // Called every frame
+
+    TEST_ASSERT_EQUAL_INT32(100, tween_value(&tween, 1300));
+}
+
+void test_tween_retarget_continues_from_current(void) {
+    tween_to(&tween, 100, 1000, 300, EASE_LINEAR);
+    tween_to(&tween, 0, 1150, 300, EASE_LINEAR);
+
+    // No jump: starts back down from 50
+    TEST_ASSERT_EQUAL_INT32(50, tween_value(&tween, 1150));
+    TEST_ASSERT_EQUAL_INT32(0, tween_value(&tween, 1450));
+}
+
+void test_tween_set_is_idle(void) {
+    tween_set(&tween, 42);
+    TEST_ASSERT_EQUAL_INT32(42, tween_value(&tween, 0x90000000UL));
+    TEST_ASSERT_FALSE(tween_active(&tween, 0x90000000UL));
+}
+
+// =============================================================================
+// PACER TESTS
+// =============================================================================
+
+void test_pacer_idle_until_first_frame(void) {
+    TEST_ASSERT_EQUAL_UINT32(PACER_IDLE, pacer_wait(&pacer, 0));
+
+    pacer_frame(&pacer, 1000, 2000);
+    TEST_ASSERT_EQUAL_UINT32(PERIOD_US - 1000, pacer_wait(&pacer, 2000));
+    TEST_ASSERT_EQUAL_UINT32(0, pacer_wait(&pacer, 1000 + PERIOD_US + 5));
+}
+
+void test_pacer_on_time_frames_not_dropped(void) {
+    uint32_t t = 5000;
+    for (int i = 0; i < 100; i++) {
+        pacer_frame(&pacer, t, t + 2000);
+        t += PERIOD_US;
+    }
+    TEST_ASSERT_EQUAL_UINT32(100, pacer.frames);
+    TEST_ASSERT_EQUAL_UINT32(0, pacer.dropped);
+}
+
+void test_pacer_counts_missed_slots(void) {
+    pacer_frame(&pacer, 0, 1000);
+
+    // Next frame starts 3.5 periods later: slots 1 and 2 went by, and the
+    // one after it stays on the grid
+    uint32_t start = 3 * PERIOD_US + PERIOD_US / 2;
+    pacer_frame(&pacer, start, start + 1000);
+    TEST_ASSERT_EQUAL_UINT32(2, pacer.dropped);
+    TEST_ASSERT_EQUAL_UINT32(4 * PERIOD_US - start, pacer_wait(&pacer, start));
+}
+
+void test_pacer_slow_frame_bounded_by_load(void) {
+    // A 40 ms frame at 50% load must be followed by at least 40 ms of rest
+    pacer_frame(&pacer, 0, 40000);
+    uint32_t wait = pacer_wait(&pacer, 40000);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(40000, wait);
+    TEST_ASSERT_EQUAL_UINT32(0, (40000 + wait) % PERIOD_US);  // Still on the grid
+    TEST_ASSERT_EQUAL_UINT32(2, pacer.dropped);
+}
+
+void test_pacer_idle_time_not_dropped(void) {
+    pacer_frame(&pacer, 0, 1000);
+    pacer_idle(&pacer);
+    TEST_ASSERT_EQUAL_UINT32(PACER_IDLE, pacer_wait(&pacer, 5000));
+
+    pacer_frame(&pacer, 10000000, 10001000);
+    TEST_ASSERT_EQUAL_UINT32(0, pacer.dropped);
+}
+
+// =============================================================================
+// TEST RUNNER
+// =============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Easing
+    RUN_TEST(test_ease_endpoints_exact);
+    RUN_TEST(test_ease_monotonic);
+    RUN_TEST(test_ease_shapes);
+    RUN_TEST(test_lerp_rounds_and_handles_negative);
+    RUN_TEST(test_progress_wraps_timer);
+    RUN_TEST(test_pulse_cycle);
+
+    // Tweens
+    RUN_TEST(test_tween_reaches_target);
+    RUN_TEST(test_tween_same_target_keeps_running);
+    RUN_TEST(test_tween_retarget_continues_from_current);
+    RUN_TEST(test_tween_set_is_idle);
+
+    // Pacer
+    RUN_TEST(test_pacer_idle_until_first_frame);
+    RUN_TEST(test_pacer_on_time_frames_not_dropped);
+    RUN_TEST(test_pacer_counts_missed_slots);
+    RUN_TEST(test_pacer_slow_frame_bounded_by_load);
+    RUN_TEST(test_pacer_idle_time_not_dropped);
+
+    return UNITY_END();
+}
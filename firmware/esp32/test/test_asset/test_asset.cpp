@@ -0,0 +1,293 @@
+/**
+ * Roxy RedLight v2.0 - Image Asset Unit Tests
+ *
+ * Run with: pio test -e native -f test_asset
+ *
+ * Tests the palette-RLE encoder, row decoding with clipping and
+ * transparency, and decode throughput
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "asset.h"
+
+// =============================================================================
+// TEST FIXTURES
+// =============================================================================
+
+#define FRAME_W     170
+#define FRAME_H     320
+
+static const uint16_t palette[ASSET_MAX_COLORS] = {0};
+static const uint8_t identity[ASSET_MAX_COLORS] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15
+};
+
+static uint8_t pixels[FRAME_W * FRAME_H];
+static uint8_t stream[FRAME_W * FRAME_H * 2];
+static uint8_t frame[FRAME_W * FRAME_H / 2];
+
+static Asset encode(uint16_t w, uint16_t h, uint8_t transparent) {
+    Asset asset = {w, h, ASSET_MAX_COLORS, transparent, palette, stream, 0};
+    asset.size = asset_encode(pixels, (uint32_t)w * h, stream, sizeof(stream));
+    return asset;
+}
+
+// Pixel x of a 4 bpp row
+static uint8_t nibble(const uint8_t* row, int x) {
+    return (x & 1) ? (row[x >> 1] & 0x0F) : (row[x >> 1] >> 4);
+}
+
+void setUp(void) {
+    memset(pixels, 0, sizeof(pixels));
+    memset(frame, 0, sizeof(frame));
+}
+
+void tearDown(void) {
+    // Nothing to clean up
+}
+
+// =============================================================================
+// ENCODER TESTS
+// =============================================================================
+
+void test_encode_short_and_long_runs(void) {
+    // 3 pixels of 1, then 100 of 2
+    memset(pixels, 1, 3);
+    memset(pixels + 3, 2, 100);
+    uint8_t out[8];
+
+    TEST_ASSERT_EQUAL_UINT32(3, asset_encode(pixels, 103, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_HEX8(0x12, out[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x2F, out[1]);
+    TEST_ASSERT_EQUAL_HEX8(100 - ASSET_LONG_MIN, out[2]);
+}
+
+void test_encode_splits_runs_over_max(void) {
+    memset(pixels, 5, 1000);
+    Asset asset = encode(100, 10, ASSET_OPAQUE);
+
+    // 271 + 271 + 271 + 187
+    TEST_ASSERT_EQUAL_UINT32(8, asset.size);
+    TEST_ASSERT_TRUE(asset_valid(&asset));
+}
+
+void test_encode_measure_and_capacity(void) {
+    for (int i = 0; i < 64; i++) {
+        pixels[i] = i % 3;
+    }
+    uint8_t out[16];
+
+    TEST_ASSERT_EQUAL_UINT32(64, asset_encode(pixels, 64, NULL, 0));
+    TEST_ASSERT_EQUAL_UINT32(0, asset_encode(pixels, 64, out, sizeof(out)));
+}
+
+void test_valid_rejects_bad_streams(void) {
+    memset(pixels, 3, 50);
+    Asset asset = encode(10, 5, ASSET_OPAQUE);
+    TEST_ASSERT_TRUE(asset_valid(&asset));
+
+    asset.height = 6;                   // Too few pixels
+    TEST_ASSERT_FALSE(asset_valid(&asset));
+
+    asset.height = 5;
+    asset.colors = 3;                   // Index 3 outside the palette
+    TEST_ASSERT_FALSE(asset_valid(&asset));
+
+    asset.colors = ASSET_MAX_COLORS;
+    asset.size--;                       // Long run cut off
+    TEST_ASSERT_FALSE(asset_valid(&asset));
+}
+
+// =============================================================================
+// DECODER TESTS
+// =============================================================================
+
+void test_round_trip_rows(void) {
+    // Runs of every length, crossing row ends
+    uint32_t i = 0;
+    for (uint8_t len = 1; i < 40 * 30; len = len % 40 + 1) {
+        for (uint8_t k = 0; k < len && i < 40 * 30; k++, i++) {
+            pixels[i] = len % 15;
+        }
+    }
+    Asset asset = encode(40, 30, ASSET_OPAQUE);
+    TEST_ASSERT_TRUE(asset_valid(&asset));
+
+    AssetReader reader;
+    asset_begin(&reader, &asset);
+    for (int y = 0; y < 30; y++) {
+        uint8_t row[20];
+        asset_decode_row4(&reader, row, 0, 40, identity);
+        for (int x = 0; x < 40; x++) {
+            TEST_ASSERT_EQUAL_UINT8(pixels[y * 40 + x], nibble(row, x));
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(asset.size, reader.pos);
+}
+
+void test_decode_row16_maps_palette(void) {
+    memset(pixels, 1, 8);
+    memset(pixels + 8, 2, 8);
+    Asset asset = encode(16, 1, ASSET_OPAQUE);
+    uint16_t map[ASSET_MAX_COLORS] = {0, 0x1234, 0xABCD};
+    uint16_t row[16];
+
+    AssetReader reader;
+    asset_begin(&reader, &asset);
+    asset_decode_row16(&reader, row, 0, 16, map);
+    TEST_ASSERT_EQUAL_HEX16(0x1234, row[7]);
+    TEST_ASSERT_EQUAL_HEX16(0xABCD, row[8]);
+}
+
+void test_transparent_pixels_keep_background(void) {
+    // 1 0 0 1 with 0 transparent, drawn over 7s
+    pixels[0] = 1;
+    pixels[3] = 1;
+    Asset asset = encode(4, 1, 0);
+    uint8_t row[2] = {0x77, 0x77};
+
+    AssetReader reader;
+    asset_begin(&reader, &asset);
+    asset_decode_row4(&reader, row, 0, 4, identity);
+    TEST_ASSERT_EQUAL_HEX8(0x17, row[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x71, row[1]);
+}
+
+void test_odd_x_keeps_neighbour_nibbles(void) {
+    memset(pixels, 9, 3);
+    Asset asset = encode(3, 1, ASSET_OPAQUE);
+    uint8_t row[3] = {0x55, 0x55, 0x55};
+
+    AssetReader reader;
+    asset_begin(&reader, &asset);
+    asset_decode_row4(&reader, row, 1, 6, identity);
+    TEST_ASSERT_EQUAL_HEX8(0x59, row[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x99, row[1]);
+    TEST_ASSERT_EQUAL_HEX8(0x55, row[2]);
+}
+
+void test_clipped_at_both_edges(void) {
+    for (int i = 0; i < 10; i++) {
+        pixels[i] = i + 1;
+    }
+    Asset asset = encode(10, 1, ASSET_OPAQUE);
+    uint16_t map[ASSET_MAX_COLORS];
+    for (int i = 0; i < ASSET_MAX_COLORS; i++) {
+        map[i] = i;
+    }
+
+    // Left edge at -3 in a 4-pixel row: only pixels 3..6 land
+    uint16_t row[5] = {0, 0, 0, 0, 0xEEEE};
+    AssetReader reader;
+    asset_begin(&reader, &asset);
+    asset_decode_row16(&reader, row, -3, 4, map);
+    TEST_ASSERT_EQUAL_UINT16(4, row[0]);
+    TEST_ASSERT_EQUAL_UINT16(7, row[3]);
+    TEST_ASSERT_EQUAL_HEX16(0xEEEE, row[4]);
+    TEST_ASSERT_EQUAL_UINT16(1, reader.row);
+}
+
+void test_skip_rows_matches_decoding(void) {
+    for (int i = 0; i < 20 * 20; i++) {
+        pixels[i] = (i / 7) % 16;
+    }
+    Asset asset = encode(20, 20, ASSET_OPAQUE);
+
+    AssetReader reader;
+    asset_begin(&reader, &asset);
+    asset_skip_rows(&reader, 13);
+    TEST_ASSERT_EQUAL_UINT16(13, reader.row);
+
+    uint8_t row[10];
+    asset_decode_row4(&reader, row, 0, 20, identity);
+    for (int x = 0; x < 20; x++) {
+        TEST_ASSERT_EQUAL_UINT8(pixels[13 * 20 + x], nibble(row, x));
+    }
+}
+
+void test_truncated_stream_pads_transparent(void) {
+    // 16 pixels claimed, only the first row encoded
+    memset(pixels, 4, 8);
+    Asset asset = {8, 2, ASSET_MAX_COLORS, 0, palette, stream, 0};
+    asset.size = asset_encode(pixels, 8, stream, sizeof(stream));
+    uint8_t first[4] = {0x33, 0x33, 0x33, 0x33};
+    uint8_t second[4] = {0x33, 0x33, 0x33, 0x33};
+
+    AssetReader reader;
+    asset_begin(&reader, &asset);
+    asset_decode_row4(&reader, first, 0, 8, identity);
+    asset_decode_row4(&reader, second, 0, 8, identity);
+    TEST_ASSERT_EQUAL_HEX8(0x44, first[3]);
+    TEST_ASSERT_EQUAL_HEX8(0x33, second[0]);
+    TEST_ASSERT_FALSE(asset_valid(&asset));
+}
+
+// =============================================================================
+// THROUGHPUT TESTS
+// =============================================================================
+
+void test_decode_throughput_full_frame(void) {
+    // Splash-like content: horizontal bands with short runs on every row
+    for (int y = 0; y < FRAME_H; y++) {
+        for (int x = 0; x < FRAME_W; x++) {
+            pixels[y * FRAME_W + x] = (y / 16 + (x / (1 + y % 9))) % 16;
+        }
+    }
+    Asset asset = encode(FRAME_W, FRAME_H, ASSET_OPAQUE);
+    TEST_ASSERT_TRUE(asset_valid(&asset));
+
+    const int frames = 200;
+    clock_t start = clock();
+    for (int f = 0; f < frames; f++) {
+        AssetReader reader;
+        asset_begin(&reader, &asset);
+        for (int y = 0; y < FRAME_H; y++) {
+            asset_decode_row4(&reader, frame + y * (FRAME_W / 2), 0, FRAME_W, identity);
+        }
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    double fps = frames / ((seconds > 0) ? seconds : 1e-9);
+
+    char message[96];
+    snprintf(message, sizeof(message), "%lu stream bytes, %.0f frames/s, %.0f Mpx/s",
+             (unsigned long)asset.size, fps, fps * FRAME_W * FRAME_H / 1e6);
+    TEST_MESSAGE(message);
+
+    // Any host manages well over a full frame per millisecond
+    TEST_ASSERT_TRUE(fps > 1000);
+    for (int x = 0; x < FRAME_W; x++) {
+        TEST_ASSERT_EQUAL_UINT8(pixels[(FRAME_H - 1) * FRAME_W + x],
+                                nibble(frame + (FRAME_H - 1) * (FRAME_W / 2), x));
+    }
+}
+
+// =============================================================================
+// TEST RUNNER
+// =============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Encoder
+    RUN_TEST(test_encode_short_and_long_runs);
+    RUN_TEST(test_encode_splits_runs_over_max);
+    RUN_TEST(test_encode_measure_and_capacity);
+    RUN_TEST(test_valid_rejects_bad_streams);
+
+    // Decoder
+    RUN_TEST(test_round_trip_rows);
+    RUN_TEST(test_decode_row16_maps_palette);
+    RUN_TEST(test_transparent_pixels_keep_background);
+    RUN_TEST(test_odd_x_keeps_neighbour_nibbles);
+    RUN_TEST(test_clipped_at_both_edges);
+    RUN_TEST(test_skip_rows_matches_decoding);
+    RUN_TEST(test_truncated_stream_pads_transparent);
+
+    // Throughput
+    RUN_TEST(test_decode_throughput_full_frame);
+
+    return UNITY_END();
+}
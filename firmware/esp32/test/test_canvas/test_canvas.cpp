@@ -0,0 +1,206 @@
+/**
+ * Roxy RedLight v2.0 - Host Canvas Unit Tests
+ *
+ * Run with: pio test -e native -f test_canvas
+ *
+ * Tests buffer layout, clipping and shape bounds of the host backend
+ */
+
+#include <unity.h>
+#include "host_canvas.h"
+
+// =============================================================================
+// TEST FIXTURES
+// =============================================================================
+
+static HostCanvas canvas;
+
+void setUp(void) {
+    canvas.create(20, 10, 16, NULL);
+    HostCanvas::pixelsWritten = 0;
+}
+
+void tearDown(void) {
+    canvas.destroy();
+}
+
+// =============================================================================
+// BUFFER TESTS
+// =============================================================================
+
+void test_create_zeroed(void) {
+    TEST_ASSERT_TRUE(canvas.created());
+    TEST_ASSERT_EQUAL(0, canvas.readPixelValue(0, 0));
+    TEST_ASSERT_EQUAL(0, canvas.readPixelValue(19, 9));
+}
+
+void test_rgb565_stored_byte_swapped(void) {
+    canvas.fillRect(0, 0, 1, 1, 0xF800);
+
+    const uint16_t* img = (const uint16_t*)canvas.getPointer();
+    TEST_ASSERT_EQUAL_HEX16(0x00F8, img[0]);
+    TEST_ASSERT_EQUAL_HEX16(0xF800, canvas.readPixelValue(0, 0));
+}
+
+void test_4bit_even_x_high_nibble(void) {
+    canvas.create(20, 10, 4, NULL);
+    canvas.fillRect(0, 0, 1, 1, 0x3);
+    canvas.fillRect(1, 0, 1, 1, 0xA);
+
+    const uint8_t* img = (const uint8_t*)canvas.getPointer();
+    TEST_ASSERT_EQUAL_HEX8(0x3A, img[0]);
+    TEST_ASSERT_EQUAL(0xA, canvas.readPixelValue(1, 0));
+}
+
+void test_1bit_rows_padded_msb_first(void) {
+    canvas.create(10, 2, 1, NULL);
+    canvas.fillRect(0, 1, 1, 1, 1);
+
+    // 10 pixels round up to 2 bytes per row
+    const uint8_t* img = (const uint8_t*)canvas.getPointer();
+    TEST_ASSERT_EQUAL_HEX8(0x80, img[2]);
+    TEST_ASSERT_EQUAL(1, canvas.readPixelValue(0, 1));
+}
+
+void test_read_outside_is_zero(void) {
+    canvas.fillScreen(0xFFFF);
+    TEST_ASSERT_EQUAL(0, canvas.readPixelValue(-1, 0));
+    TEST_ASSERT_EQUAL(0, canvas.readPixelValue(20, 0));
+}
+
+// =============================================================================
+// SHAPE TESTS
+// =============================================================================
+
+void test_fill_counts_pixels(void) {
+    canvas.fillRect(2, 2, 5, 4, 0x07E0);
+    TEST_ASSERT_EQUAL(20, HostCanvas::pixelsWritten);
+}
+
+void test_fill_clipped(void) {
+    canvas.fillRect(15, 5, 10, 10, 0x07E0);
+
+    // Only the 5x5 on-canvas part is written
+    TEST_ASSERT_EQUAL(25, HostCanvas::pixelsWritten);
+    TEST_ASSERT_EQUAL_HEX16(0x07E0, canvas.readPixelValue(19, 9));
+}
+
+void test_draw_rect_outline_only(void) {
+    canvas.drawRect(0, 0, 5, 5, 0xFFFF);
+
+    TEST_ASSERT_EQUAL(16, HostCanvas::pixelsWritten);
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, canvas.readPixelValue(4, 4));
+    TEST_ASSERT_EQUAL(0, canvas.readPixelValue(2, 2));
+}
+
+void test_circle_within_bounds(void) {
+    canvas.fillCircle(10, 5, 3, 0xFFFF);
+
+    // Extremes on the axes, nothing outside the 7x7 box
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, canvas.readPixelValue(7, 5));
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, canvas.readPixelValue(10, 8));
+    TEST_ASSERT_EQUAL(0, canvas.readPixelValue(6, 5));
+    TEST_ASSERT_EQUAL(0, canvas.readPixelValue(7, 2));
+}
+
+void test_round_rect_corners_cut(void) {
+    canvas.fillRoundRect(0, 0, 10, 10, 3, 0xFFFF);
+
+    TEST_ASSERT_EQUAL(0, canvas.readPixelValue(0, 0));
+    TEST_ASSERT_EQUAL(0, canvas.readPixelValue(9, 9));
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, canvas.readPixelValue(5, 0));
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, canvas.readPixelValue(0, 5));
+}
+
+void test_bitmap_fg_and_bg(void) {
+    const uint8_t bits[2] = {0xA0, 0x40};  // 3x2: X.X / .X.
+    canvas.drawBitmap(1, 1, bits, 3, 2, 0xFFFF, 0x001F);
+
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, canvas.readPixelValue(1, 1));
+    TEST_ASSERT_EQUAL_HEX16(0x001F, canvas.readPixelValue(2, 1));
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, canvas.readPixelValue(2, 2));
+    TEST_ASSERT_EQUAL(6, HostCanvas::pixelsWritten);
+}
+
+// =============================================================================
+// OFFSET TESTS
+// =============================================================================
+
+void test_offset_shifts_drawing(void) {
+    // Canvas as rows 30..39 of the screen
+    canvas.setOffset(0, 30);
+    canvas.fillRect(2, 28, 3, 4, 0xFFFF);
+
+    // Rows 28-29 fall above the strip, 30-31 land on buffer rows 0-1
+    TEST_ASSERT_EQUAL(6, HostCanvas::pixelsWritten);
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, canvas.readPixelValue(2, 0));
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, canvas.readPixelValue(4, 1));
+    TEST_ASSERT_EQUAL(0, canvas.readPixelValue(2, 2));
+    canvas.setOffset(0, 0);
+}
+
+void test_offset_fill_screen_whole_buffer(void) {
+    canvas.setOffset(0, 100);
+    canvas.fillScreen(0x001F);
+
+    TEST_ASSERT_EQUAL(200, HostCanvas::pixelsWritten);
+    TEST_ASSERT_EQUAL_HEX16(0x001F, canvas.readPixelValue(0, 0));
+    TEST_ASSERT_EQUAL_HEX16(0x001F, canvas.readPixelValue(19, 9));
+    canvas.setOffset(0, 0);
+}
+
+// =============================================================================
+// TEXT TESTS
+// =============================================================================
+
+void test_text_width_per_font(void) {
+    TEST_ASSERT_EQUAL(12, canvas.textWidth("ab", 1));
+    TEST_ASSERT_EQUAL(16, canvas.textWidth("ab", 2));
+    TEST_ASSERT_EQUAL(16 + 4, canvas.textWidth("1:2", 2));  // Narrow ':'
+}
+
+void test_text_datum_placement(void) {
+    canvas.create(40, 40, 16, NULL);
+    canvas.setTextFont(1);
+    canvas.setTextColor(0xFFFF, 0x0001);
+    canvas.setTextDatum(MC_DATUM);
+    canvas.drawString("A", 20, 20);
+
+    // 6x8 cell centred on (20, 20): background spans x 17..22, y 16..23
+    TEST_ASSERT_EQUAL_HEX16(0x0001, canvas.readPixelValue(17, 16));
+    TEST_ASSERT_EQUAL(0, canvas.readPixelValue(16, 16));
+    TEST_ASSERT_EQUAL(0, canvas.readPixelValue(17, 24));
+}
+
+// =============================================================================
+// TEST RUNNER
+// =============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Buffer
+    RUN_TEST(test_create_zeroed);
+    RUN_TEST(test_rgb565_stored_byte_swapped);
+    RUN_TEST(test_4bit_even_x_high_nibble);
+    RUN_TEST(test_1bit_rows_padded_msb_first);
+    RUN_TEST(test_read_outside_is_zero);
+
+    // Shapes
+    RUN_TEST(test_fill_counts_pixels);
+    RUN_TEST(test_fill_clipped);
+    RUN_TEST(test_draw_rect_outline_only);
+    RUN_TEST(test_circle_within_bounds);
+    RUN_TEST(test_round_rect_corners_cut);
+    RUN_TEST(test_bitmap_fg_and_bg);
+
+    // Offset
+    RUN_TEST(test_offset_shifts_drawing);
+    RUN_TEST(test_offset_fill_screen_whole_buffer);
+
+    // Text
+    RUN_TEST(test_text_width_per_font);
+    RUN_TEST(test_text_datum_placement);
+
+    return UNITY_END();
+}
@@ -0,0 +1,279 @@
+/**
+ * Roxy RedLight v2.0 - Dirty Region Unit Tests
+ *
+ * Run with: pio test -e native -f test_dirty
+ *
+ * Tests clipping, merging and overflow of partial-update rects
+ */
+
+#include <unity.h>
+#include "dirty.h"
+
+// =============================================================================
+// TEST FIXTURES
+// =============================================================================
+
+static DirtyRegion region;
+
+void setUp(void) {
+    dirty_init(&region, 170, 320);
+}
+
+void tearDown(void) {
+    // Nothing to clean up
+}
+
+// =============================================================================
+// BASIC TESTS
+// =============================================================================
+
+void test_init_empty(void) {
+    TEST_ASSERT_TRUE(dirty_is_empty(&region));
+    TEST_ASSERT_EQUAL(0, dirty_area(&region));
+}
+
+void test_add_single_rect(void) {
+    dirty_add(&region, 10, 20, 30, 40);
+
+    TEST_ASSERT_EQUAL(1, region.count);
+    TEST_ASSERT_EQUAL(10, region.rects[0].x);
+    TEST_ASSERT_EQUAL(20, region.rects[0].y);
+    TEST_ASSERT_EQUAL(30, region.rects[0].w);
+    TEST_ASSERT_EQUAL(40, region.rects[0].h);
+    TEST_ASSERT_EQUAL(1200, dirty_area(&region));
+}
+
+void test_add_empty_ignored(void) {
+    dirty_add(&region, 10, 10, 0, 10);
+    dirty_add(&region, 10, 10, 10, -5);
+    TEST_ASSERT_TRUE(dirty_is_empty(&region));
+}
+
+void test_clear_empties_region(void) {
+    dirty_add(&region, 0, 0, 10, 10);
+    dirty_clear(&region);
+    TEST_ASSERT_TRUE(dirty_is_empty(&region));
+}
+
+// =============================================================================
+// CLIPPING TESTS
+// =============================================================================
+
+void test_clip_to_screen(void) {
+    dirty_add(&region, -10, 300, 50, 50);
+
+    TEST_ASSERT_EQUAL(1, region.count);
+    TEST_ASSERT_EQUAL(0, region.rects[0].x);
+    TEST_ASSERT_EQUAL(300, region.rects[0].y);
+    TEST_ASSERT_EQUAL(40, region.rects[0].w);
+    TEST_ASSERT_EQUAL(20, region.rects[0].h);
+}
+
+void test_offscreen_ignored(void) {
+    dirty_add(&region, 200, 10, 20, 20);
+    dirty_add(&region, 10, -40, 20, 20);
+    TEST_ASSERT_TRUE(dirty_is_empty(&region));
+}
+
+void test_add_all_covers_screen(void) {
+    dirty_add(&region, 5, 5, 5, 5);
+    dirty_add_all(&region);
+
+    TEST_ASSERT_EQUAL(1, region.count);
+    TEST_ASSERT_EQUAL(170UL * 320UL, dirty_area(&region));
+}
+
+// =============================================================================
+// MERGE TESTS
+// =============================================================================
+
+void test_overlapping_rects_merge(void) {
+    dirty_add(&region, 10, 10, 20, 20);
+    dirty_add(&region, 20, 20, 20, 20);
+
+    TEST_ASSERT_EQUAL(1, region.count);
+    TEST_ASSERT_EQUAL(10, region.rects[0].x);
+    TEST_ASSERT_EQUAL(10, region.rects[0].y);
+    TEST_ASSERT_EQUAL(30, region.rects[0].w);
+    TEST_ASSERT_EQUAL(30, region.rects[0].h);
+}
+
+void test_adjacent_rects_merge(void) {
+    // Same row band, touching edges - union wastes nothing
+    dirty_add(&region, 10, 100, 20, 10);
+    dirty_add(&region, 30, 100, 20, 10);
+
+    TEST_ASSERT_EQUAL(1, region.count);
+    TEST_ASSERT_EQUAL(400, dirty_area(&region));
+}
+
+void test_distant_rects_stay_separate(void) {
+    // Countdown digits and footer are far apart
+    dirty_add(&region, 40, 80, 90, 40);
+    dirty_add(&region, 10, 295, 40, 20);
+
+    TEST_ASSERT_EQUAL(2, region.count);
+    TEST_ASSERT_EQUAL(3600 + 800, dirty_area(&region));
+}
+
+void test_merge_cascades(void) {
+    dirty_add(&region, 0, 0, 10, 10);
+    dirty_add(&region, 100, 0, 10, 10);
+    TEST_ASSERT_EQUAL(2, region.count);
+
+    // Bridges both existing rects
+    dirty_add(&region, 5, 0, 100, 10);
+    TEST_ASSERT_EQUAL(1, region.count);
+    TEST_ASSERT_EQUAL(0, region.rects[0].x);
+    TEST_ASSERT_EQUAL(110, region.rects[0].w);
+}
+
+void test_rects_never_overlap(void) {
+    dirty_add(&region, 0, 0, 50, 50);
+    dirty_add(&region, 100, 100, 50, 50);
+    dirty_add(&region, 40, 40, 70, 70);
+
+    for (uint8_t i = 0; i < region.count; i++) {
+        for (uint8_t j = i + 1; j < region.count; j++) {
+            TEST_ASSERT_FALSE(dirty_rect_intersects(region.rects[i], region.rects[j]));
+        }
+    }
+}
+
+// =============================================================================
+// OVERFLOW TESTS
+// =============================================================================
+
+void test_overflow_bounded(void) {
+    // Scatter more small rects than the region can hold
+    for (int i = 0; i < DIRTY_MAX_RECTS * 3; i++) {
+        dirty_add(&region, (i % 4) * 40, (i / 4) * 50, 4, 4);
+    }
+
+    TEST_ASSERT_LESS_OR_EQUAL(DIRTY_MAX_RECTS, region.count);
+    TEST_ASSERT_GREATER_THAN(0, region.count);
+}
+
+void test_overflow_covers_all_inputs(void) {
+    DirtyRect inputs[DIRTY_MAX_RECTS + 4];
+    for (int i = 0; i < DIRTY_MAX_RECTS + 4; i++) {
+        inputs[i].x = (i % 3) * 60;
+        inputs[i].y = i * 25;
+        inputs[i].w = 5;
+        inputs[i].h = 5;
+        dirty_add(&region, inputs[i].x, inputs[i].y, inputs[i].w, inputs[i].h);
+    }
+
+    // Every added pixel must still be inside some rect
+    for (int i = 0; i < DIRTY_MAX_RECTS + 4; i++) {
+        bool covered = false;
+        for (uint8_t j = 0; j < region.count; j++) {
+            DirtyRect r = region.rects[j];
+            if (inputs[i].x >= r.x && inputs[i].x + inputs[i].w <= r.x + r.w &&
+                inputs[i].y >= r.y && inputs[i].y + inputs[i].h <= r.y + r.h) {
+                covered = true;
+            }
+        }
+        TEST_ASSERT_TRUE(covered);
+    }
+}
+
+// =============================================================================
+// ROW BAND TESTS
+// =============================================================================
+
+void test_row_bands_full_width_sorted(void) {
+    DirtyRect bands[DIRTY_MAX_RECTS];
+
+    dirty_add(&region, 10, 200, 30, 10);
+    dirty_add(&region, 40, 80, 90, 40);
+    uint8_t n = dirty_row_bands(&region, bands);
+
+    TEST_ASSERT_EQUAL(2, n);
+    TEST_ASSERT_EQUAL(80, bands[0].y);
+    TEST_ASSERT_EQUAL(40, bands[0].h);
+    TEST_ASSERT_EQUAL(200, bands[1].y);
+    TEST_ASSERT_EQUAL(0, bands[1].x);
+    TEST_ASSERT_EQUAL(170, bands[1].w);
+}
+
+void test_row_bands_join_shared_rows(void) {
+    DirtyRect bands[DIRTY_MAX_RECTS];
+
+    // Side by side on overlapping rows, too far apart to merge as rects
+    dirty_add(&region, 0, 100, 10, 20);
+    dirty_add(&region, 150, 110, 10, 20);
+    TEST_ASSERT_EQUAL(2, region.count);
+
+    uint8_t n = dirty_row_bands(&region, bands);
+    TEST_ASSERT_EQUAL(1, n);
+    TEST_ASSERT_EQUAL(100, bands[0].y);
+    TEST_ASSERT_EQUAL(30, bands[0].h);
+}
+
+// =============================================================================
+// STRIP CLIP TESTS
+// =============================================================================
+
+void test_rect_clip_to_strip(void) {
+    DirtyRect r = {20, 30, 50, 40};
+    DirtyRect strip = {0, 40, 170, 40};
+    DirtyRect out;
+
+    TEST_ASSERT_TRUE(dirty_rect_clip(r, strip, &out));
+    TEST_ASSERT_EQUAL(20, out.x);
+    TEST_ASSERT_EQUAL(40, out.y);
+    TEST_ASSERT_EQUAL(50, out.w);
+    TEST_ASSERT_EQUAL(30, out.h);
+}
+
+void test_rect_clip_outside_strip(void) {
+    DirtyRect r = {20, 0, 50, 40};
+    DirtyRect strip = {0, 40, 170, 40};
+    DirtyRect out = {1, 2, 3, 4};
+
+    // Touching the strip's top edge is not an overlap
+    TEST_ASSERT_FALSE(dirty_rect_clip(r, strip, &out));
+    TEST_ASSERT_EQUAL(1, out.x);
+    TEST_ASSERT_EQUAL(4, out.h);
+}
+
+// =============================================================================
+// TEST RUNNER
+// =============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Basics
+    RUN_TEST(test_init_empty);
+    RUN_TEST(test_add_single_rect);
+    RUN_TEST(test_add_empty_ignored);
+    RUN_TEST(test_clear_empties_region);
+
+    // Clipping
+    RUN_TEST(test_clip_to_screen);
+    RUN_TEST(test_offscreen_ignored);
+    RUN_TEST(test_add_all_covers_screen);
+
+    // Merging
+    RUN_TEST(test_overlapping_rects_merge);
+    RUN_TEST(test_adjacent_rects_merge);
+    RUN_TEST(test_distant_rects_stay_separate);
+    RUN_TEST(test_merge_cascades);
+    RUN_TEST(test_rects_never_overlap);
+
+    // Overflow
+    RUN_TEST(test_overflow_bounded);
+    RUN_TEST(test_overflow_covers_all_inputs);
+
+    // Row bands
+    RUN_TEST(test_row_bands_full_width_sorted);
+    RUN_TEST(test_row_bands_join_shared_rows);
+
+    // Strip clipping
+    RUN_TEST(test_rect_clip_to_strip);
+    RUN_TEST(test_rect_clip_outside_strip);
+
+    return UNITY_END();
+}
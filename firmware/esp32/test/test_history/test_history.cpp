@@ -0,0 +1,178 @@
+/**
+ * Roxy RedLight v2.0 - Session History Unit Tests
+ *
+ * Run with: pio test -e native -f test_history
+ *
+ * Tests the LRU page cache over a fake store, and newest-first paging
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "history.h"
+
+// =============================================================================
+// TEST FIXTURES
+// =============================================================================
+
+// In-memory store: record i has durationSec = i
+#define STORE_MAX   1000
+
+static HistoryRecord store[STORE_MAX];
+static uint32_t storeCount;
+static uint32_t storeReads;
+static HistoryCache cache;
+
+static uint16_t readStore(void* ctx, uint32_t first, HistoryRecord* out, uint16_t count) {
+    storeReads++;
+    if (first >= storeCount) {
+        return 0;
+    }
+    if (count > storeCount - first) {
+        count = storeCount - first;
+    }
+    memcpy(out, &store[first], count * sizeof(HistoryRecord));
+    return count;
+}
+
+static void fillStore(uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        memset(&store[i], 0, sizeof(HistoryRecord));
+        store[i].durationSec = i;
+    }
+    storeCount = count;
+}
+
+void setUp(void) {
+    fillStore(100);
+    storeReads = 0;
+    history_cache_init(&cache, readStore, NULL);
+}
+
+void tearDown(void) {
+    // Nothing to clean up
+}
+
+// =============================================================================
+// CACHE TESTS
+// =============================================================================
+
+void test_record_is_sixteen_bytes(void) {
+    TEST_ASSERT_EQUAL(16, sizeof(HistoryRecord));
+}
+
+void test_miss_reads_page_from_store(void) {
+    const HistoryPage* page = history_cache_page(&cache, 2);
+    TEST_ASSERT_EQUAL(1, storeReads);
+    TEST_ASSERT_EQUAL(HISTORY_PAGE_RECORDS, page->count);
+    TEST_ASSERT_EQUAL(2 * HISTORY_PAGE_RECORDS, page->records[0].durationSec);
+}
+
+void test_hit_skips_store(void) {
+    history_cache_page(&cache, 2);
+    history_cache_page(&cache, 2);
+    TEST_ASSERT_EQUAL(1, storeReads);
+    TEST_ASSERT_EQUAL(1, cache.hits);
+    TEST_ASSERT_EQUAL(1, cache.misses);
+}
+
+void test_evicts_least_recently_used(void) {
+    for (uint32_t p = 0; p < HISTORY_CACHE_PAGES; p++) {
+        history_cache_page(&cache, p);
+    }
+    history_cache_page(&cache, 0);                      // 1 is now the oldest
+    history_cache_page(&cache, HISTORY_CACHE_PAGES);    // Evicts 1
+
+    storeReads = 0;
+    history_cache_page(&cache, 0);
+    TEST_ASSERT_EQUAL(0, storeReads);
+    history_cache_page(&cache, 1);
+    TEST_ASSERT_EQUAL(1, storeReads);
+}
+
+void test_short_last_page(void) {
+    fillStore(2 * HISTORY_PAGE_RECORDS + 1);
+    const HistoryPage* page = history_cache_page(&cache, 2);
+    TEST_ASSERT_EQUAL(1, page->count);
+}
+
+void test_invalidate_rereads_after_append(void) {
+    fillStore(HISTORY_PAGE_RECORDS - 1);
+    TEST_ASSERT_EQUAL(HISTORY_PAGE_RECORDS - 1, history_cache_page(&cache, 0)->count);
+
+    fillStore(HISTORY_PAGE_RECORDS);
+    history_cache_invalidate(&cache, history_page_of(storeCount - 1));
+    TEST_ASSERT_EQUAL(HISTORY_PAGE_RECORDS, history_cache_page(&cache, 0)->count);
+    TEST_ASSERT_EQUAL(2, storeReads);
+}
+
+// =============================================================================
+// PAGING TESTS
+// =============================================================================
+
+void test_empty_store_has_one_screen(void) {
+    TEST_ASSERT_EQUAL(1, history_screen_count(0));
+    TEST_ASSERT_EQUAL(0, history_screen_page(0, 0));
+    TEST_ASSERT_EQUAL(0, history_cache_page(&cache, 99)->count);
+}
+
+void test_screen_zero_is_newest_page(void) {
+    uint32_t records = 5 * HISTORY_PAGE_RECORDS + 2;
+    TEST_ASSERT_EQUAL(6, history_screen_count(records));
+    TEST_ASSERT_EQUAL(5, history_screen_page(records, 0));
+    TEST_ASSERT_EQUAL(0, history_screen_page(records, 5));
+    TEST_ASSERT_EQUAL(0, history_screen_page(records, 50));    // Clamped to the oldest
+}
+
+void test_end_names(void) {
+    TEST_ASSERT_EQUAL_STRING("Done", history_end_name(HISTORY_END_COMPLETE));
+    TEST_ASSERT_EQUAL_STRING("Stop", history_end_name(HISTORY_END_STOPPED));
+    TEST_ASSERT_EQUAL_STRING("Limit", history_end_name(HISTORY_END_TIME_LIMIT));
+    TEST_ASSERT_EQUAL_STRING("Fault", history_end_name(HISTORY_END_FAULT));
+    TEST_ASSERT_EQUAL_STRING("?", history_end_name(HISTORY_END_COUNT));
+}
+
+// =============================================================================
+// THROUGHPUT
+// =============================================================================
+
+void test_scrolling_back_and_forth_stays_cached(void) {
+    // Down three screens and back: each page read once
+    fillStore(STORE_MAX);
+    uint32_t screens = history_screen_count(storeCount);
+    for (uint32_t s = 0; s < 3; s++) {
+        history_cache_page(&cache, history_screen_page(storeCount, s));
+    }
+    for (int32_t s = 2; s >= 0; s--) {
+        history_cache_page(&cache, history_screen_page(storeCount, s));
+    }
+    TEST_ASSERT_EQUAL(3, storeReads);
+    TEST_ASSERT_EQUAL(STORE_MAX - 1,
+        history_cache_page(&cache, history_screen_page(storeCount, 0))->records[3].durationSec);
+    TEST_ASSERT_EQUAL(167, screens);
+}
+
+// =============================================================================
+// TEST RUNNER
+// =============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Cache
+    RUN_TEST(test_record_is_sixteen_bytes);
+    RUN_TEST(test_miss_reads_page_from_store);
+    RUN_TEST(test_hit_skips_store);
+    RUN_TEST(test_evicts_least_recently_used);
+    RUN_TEST(test_short_last_page);
+    RUN_TEST(test_invalidate_rereads_after_append);
+
+    // Paging
+    RUN_TEST(test_empty_store_has_one_screen);
+    RUN_TEST(test_screen_zero_is_newest_page);
+    RUN_TEST(test_end_names);
+
+    // Throughput
+    RUN_TEST(test_scrolling_back_and_forth_stays_cached);
+
+    return UNITY_END();
+}
@@ -0,0 +1,255 @@
+/**
+ * Roxy RedLight v2.0 - Button Input Unit Tests
+ *
+ * Run with: pio test -e native -f test_input
+ *
+ * Tests the edge ring, debouncing, and short, long, double-click and
+ * hold-repeat gestures
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "input.h"
+
+// =============================================================================
+// TEST FIXTURES
+// =============================================================================
+
+#define DEBOUNCE_MS     50
+#define LONG_MS         1000
+#define DOUBLE_MS       250
+#define REPEAT_MS       200
+#define MS              1000UL
+
+static InputRing ring;
+static InputRecognizer rec;
+static uint32_t clockUs;
+
+// An edge through the ring, as the ISR and loop() pass it
+static void edge(uint8_t button, bool down) {
+    input_ring_push(&ring, clockUs, button, down);
+    InputEdge e;
+    while (input_ring_pop(&ring, &e)) {
+        input_feed(&rec, &e);
+    }
+}
+
+static void wait(uint32_t ms) {
+    clockUs += ms * MS;
+    input_tick(&rec, clockUs);
+}
+
+static void click(uint8_t button, uint32_t ms) {
+    edge(button, true);
+    wait(ms);
+    edge(button, false);
+}
+
+static ButtonEvent next() {
+    InputEvent e;
+    return input_event(&rec, &e) ? e.event : BUTTON_NONE;
+}
+
+void setUp(void) {
+    clockUs = 1000000;
+    input_ring_init(&ring);
+    input_init(&rec, clockUs, DEBOUNCE_MS, LONG_MS, DOUBLE_MS, REPEAT_MS);
+}
+
+void tearDown(void) {
+    // Nothing to clean up
+}
+
+// =============================================================================
+// RING TESTS
+// =============================================================================
+
+void test_ring_keeps_order_and_times(void) {
+    for (uint32_t i = 0; i < 10; i++) {
+        TEST_ASSERT_TRUE(input_ring_push(&ring, 100 + i, i % 2, true));
+    }
+    InputEdge e;
+    for (uint32_t i = 0; i < 10; i++) {
+        TEST_ASSERT_TRUE(input_ring_pop(&ring, &e));
+        TEST_ASSERT_EQUAL(100 + i, e.us);
+        TEST_ASSERT_EQUAL(i % 2, e.button);
+    }
+    TEST_ASSERT_FALSE(input_ring_pop(&ring, &e));
+}
+
+void test_ring_full_counts_overrun(void) {
+    for (uint32_t i = 0; i < INPUT_RING_SIZE; i++) {
+        TEST_ASSERT_TRUE(input_ring_push(&ring, i, 0, true));
+    }
+    TEST_ASSERT_FALSE(input_ring_push(&ring, 0, 0, true));
+    TEST_ASSERT_EQUAL(1, ring.overruns);
+
+    // Draining frees the slots again
+    InputEdge e;
+    input_ring_pop(&ring, &e);
+    TEST_ASSERT_TRUE(input_ring_push(&ring, 0, 0, true));
+}
+
+// =============================================================================
+// GESTURE TESTS
+// =============================================================================
+
+void test_short_press_on_release(void) {
+    click(0, 100);
+    TEST_ASSERT_EQUAL(BUTTON_1_SHORT, next());
+    TEST_ASSERT_EQUAL(BUTTON_NONE, next());
+}
+
+void test_event_time_is_release_edge(void) {
+    click(1, 100);
+    InputEvent e;
+    TEST_ASSERT_TRUE(input_event(&rec, &e));
+    TEST_ASSERT_EQUAL(BUTTON_2_SHORT, e.event);
+    TEST_ASSERT_EQUAL(clockUs, e.us);
+}
+
+void test_two_quick_presses_both_reported(void) {
+    // Both presses land before loop() looks: neither is lost
+    input_ring_push(&ring, clockUs, 0, true);
+    input_ring_push(&ring, clockUs + 80 * MS, 0, false);
+    input_ring_push(&ring, clockUs + 300 * MS, 0, true);
+    input_ring_push(&ring, clockUs + 380 * MS, 0, false);
+    clockUs += 400 * MS;
+    edge(0, false);     // Drain
+
+    TEST_ASSERT_EQUAL(BUTTON_1_SHORT, next());
+    TEST_ASSERT_EQUAL(BUTTON_1_SHORT, next());
+    TEST_ASSERT_EQUAL(BUTTON_NONE, next());
+}
+
+void test_bounces_ignored(void) {
+    edge(0, true);
+    clockUs += 2 * MS;
+    edge(0, false);
+    clockUs += 3 * MS;
+    edge(0, true);
+    wait(100);
+    edge(0, false);
+    clockUs += 1 * MS;
+    edge(0, true);
+    clockUs += 1 * MS;
+    edge(0, false);
+    wait(100);
+
+    TEST_ASSERT_EQUAL(BUTTON_1_SHORT, next());
+    TEST_ASSERT_EQUAL(BUTTON_NONE, next());
+}
+
+void test_release_inside_bounce_window_settles(void) {
+    // A tap shorter than the debounce time still ends the press
+    edge(0, true);
+    clockUs += 20 * MS;
+    edge(0, false);
+    TEST_ASSERT_EQUAL(BUTTON_NONE, next());
+    TEST_ASSERT_EQUAL(DEBOUNCE_MS * MS, input_wait(&rec, clockUs));
+
+    wait(DEBOUNCE_MS);
+    TEST_ASSERT_EQUAL(BUTTON_1_SHORT, next());
+}
+
+void test_long_press_while_held(void) {
+    edge(1, true);
+    wait(LONG_MS - 1);
+    TEST_ASSERT_EQUAL(BUTTON_NONE, next());
+    wait(1);
+    TEST_ASSERT_EQUAL(BUTTON_2_LONG, next());
+
+    // No short press on release
+    edge(1, false);
+    TEST_ASSERT_EQUAL(BUTTON_NONE, next());
+}
+
+void test_hold_repeats_after_long(void) {
+    edge(0, true);
+    for (int i = 0; i < (LONG_MS + 3 * REPEAT_MS) / 10; i++) {
+        wait(10);
+    }
+    edge(0, false);
+
+    TEST_ASSERT_EQUAL(BUTTON_1_LONG, next());
+    TEST_ASSERT_EQUAL(BUTTON_1_REPEAT, next());
+    TEST_ASSERT_EQUAL(BUTTON_1_REPEAT, next());
+    TEST_ASSERT_EQUAL(BUTTON_1_REPEAT, next());
+    TEST_ASSERT_EQUAL(BUTTON_NONE, next());
+}
+
+void test_stalled_loop_does_not_burst_repeats(void) {
+    edge(0, true);
+    wait(LONG_MS + 10 * REPEAT_MS);     // One tick for the whole hold
+    TEST_ASSERT_EQUAL(BUTTON_1_LONG, next());
+    TEST_ASSERT_EQUAL(BUTTON_1_REPEAT, next());
+    TEST_ASSERT_EQUAL(BUTTON_NONE, next());
+    TEST_ASSERT_EQUAL(REPEAT_MS * MS, input_wait(&rec, clockUs));
+}
+
+void test_double_click(void) {
+    input_double_click(&rec, 0, true);
+    click(0, 80);
+    wait(100);
+    TEST_ASSERT_EQUAL(BUTTON_NONE, next());     // Could still be a double
+    click(0, 80);
+
+    TEST_ASSERT_EQUAL(BUTTON_1_DOUBLE, next());
+    TEST_ASSERT_EQUAL(BUTTON_NONE, next());
+}
+
+void test_double_click_gap_expires_to_short(void) {
+    input_double_click(&rec, 0, true);
+    click(0, 80);
+    wait(DOUBLE_MS - 1);
+    TEST_ASSERT_EQUAL(BUTTON_NONE, next());
+    wait(1);
+    TEST_ASSERT_EQUAL(BUTTON_1_SHORT, next());
+}
+
+void test_buttons_independent(void) {
+    edge(0, true);
+    wait(100);
+    click(1, 100);
+    wait(100);
+    edge(0, false);
+
+    TEST_ASSERT_EQUAL(BUTTON_2_SHORT, next());
+    TEST_ASSERT_EQUAL(BUTTON_1_SHORT, next());
+}
+
+void test_survives_time_wrap(void) {
+    clockUs = 0xFFFFFFFF - 30 * MS;
+    input_init(&rec, clockUs, DEBOUNCE_MS, LONG_MS, DOUBLE_MS, REPEAT_MS);
+    edge(0, true);
+    wait(LONG_MS);
+    TEST_ASSERT_EQUAL(BUTTON_1_LONG, next());
+}
+
+// =============================================================================
+// TEST RUNNER
+// =============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Ring
+    RUN_TEST(test_ring_keeps_order_and_times);
+    RUN_TEST(test_ring_full_counts_overrun);
+
+    // Gestures
+    RUN_TEST(test_short_press_on_release);
+    RUN_TEST(test_event_time_is_release_edge);
+    RUN_TEST(test_two_quick_presses_both_reported);
+    RUN_TEST(test_bounces_ignored);
+    RUN_TEST(test_release_inside_bounce_window_settles);
+    RUN_TEST(test_long_press_while_held);
+    RUN_TEST(test_hold_repeats_after_long);
+    RUN_TEST(test_stalled_loop_does_not_burst_repeats);
+    RUN_TEST(test_double_click);
+    RUN_TEST(test_double_click_gap_expires_to_short);
+    RUN_TEST(test_buttons_independent);
+    RUN_TEST(test_survives_time_wrap);
+
+    return UNITY_END();
+}
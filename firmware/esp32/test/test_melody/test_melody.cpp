@@ -0,0 +1,181 @@
+/**
+ * Roxy RedLight v2.0 - Melody Sequencer Unit Tests
+ *
+ * Run with: pio test -e native -f test_melody
+ *
+ * Tests note timing, queueing, priority preemption and overflow
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "melody.h"
+
+// =============================================================================
+// TEST FIXTURES
+// =============================================================================
+
+static MelodySeq seq;
+static uint32_t clockMs;
+
+static const ToneNote CHIME[] = {{1500, 500}, {MELODY_REST, 200}, {1500, 500}};
+static const ToneNote CLICK[] = {{1000, 50}};
+static const ToneNote ALARM[] = {{2000, 200}, {MELODY_REST, 200}};
+
+// Play and start sounding, as the firmware does
+static bool play(const ToneNote* notes, uint8_t count, uint8_t priority) {
+    bool queued = melody_play(&seq, notes, count, priority, clockMs);
+    melody_update(&seq, clockMs);
+    return queued;
+}
+
+// Jump to the next note boundary, as the scheduled job does
+static void step() {
+    clockMs += melody_next(&seq, clockMs);
+    melody_update(&seq, clockMs);
+}
+
+void setUp(void) {
+    melody_init(&seq);
+    clockMs = 5000;
+}
+
+void tearDown(void) {
+    // Nothing to clean up
+}
+
+// =============================================================================
+// TIMING TESTS
+// =============================================================================
+
+void test_idle_is_silent(void) {
+    TEST_ASSERT_FALSE(melody_busy(&seq));
+    TEST_ASSERT_EQUAL(MELODY_REST, seq.freq);
+    TEST_ASSERT_EQUAL(MELODY_IDLE, melody_next(&seq, clockMs));
+    TEST_ASSERT_FALSE(melody_update(&seq, clockMs));
+}
+
+void test_first_note_sounds_at_once(void) {
+    play(CHIME, 3, MELODY_PRIORITY_EVENT);
+    TEST_ASSERT_EQUAL(1500, seq.freq);
+    TEST_ASSERT_EQUAL(500, melody_next(&seq, clockMs));
+}
+
+void test_notes_follow_in_order(void) {
+    play(CHIME, 3, MELODY_PRIORITY_EVENT);
+
+    step();
+    TEST_ASSERT_EQUAL(MELODY_REST, seq.freq);
+    TEST_ASSERT_EQUAL(200, melody_next(&seq, clockMs));
+    step();
+    TEST_ASSERT_EQUAL(1500, seq.freq);
+    step();
+    TEST_ASSERT_EQUAL(MELODY_REST, seq.freq);
+    TEST_ASSERT_FALSE(melody_busy(&seq));
+    TEST_ASSERT_EQUAL(5000 + 1200, clockMs);
+}
+
+void test_late_update_keeps_rhythm(void) {
+    play(CHIME, 3, MELODY_PRIORITY_EVENT);
+
+    // 30 ms late into the rest: it still ends at 700
+    clockMs += 530;
+    TEST_ASSERT_TRUE(melody_update(&seq, clockMs));
+    TEST_ASSERT_EQUAL(MELODY_REST, seq.freq);
+    TEST_ASSERT_EQUAL(170, melody_next(&seq, clockMs));
+}
+
+void test_very_late_update_skips_finished_notes(void) {
+    play(CHIME, 3, MELODY_PRIORITY_EVENT);
+    clockMs += 5000;
+    melody_update(&seq, clockMs);
+    TEST_ASSERT_FALSE(melody_busy(&seq));
+    TEST_ASSERT_EQUAL(MELODY_REST, seq.freq);
+}
+
+// =============================================================================
+// QUEUE TESTS
+// =============================================================================
+
+void test_equal_priority_queues_behind(void) {
+    play(CLICK, 1, MELODY_PRIORITY_CLICK);
+    TEST_ASSERT_TRUE(play(CLICK, 1, MELODY_PRIORITY_CLICK));
+    TEST_ASSERT_EQUAL(2, seq.count);
+
+    step();
+    TEST_ASSERT_TRUE(melody_busy(&seq));
+    step();
+    TEST_ASSERT_FALSE(melody_busy(&seq));
+}
+
+void test_higher_priority_preempts(void) {
+    play(CHIME, 3, MELODY_PRIORITY_EVENT);
+    clockMs += 100;
+    TEST_ASSERT_TRUE(play(ALARM, 2, MELODY_PRIORITY_ALARM));
+
+    TEST_ASSERT_EQUAL(2000, seq.freq);
+    TEST_ASSERT_EQUAL(2, seq.count);
+    TEST_ASSERT_EQUAL(200, melody_next(&seq, clockMs));
+}
+
+void test_lower_priority_dropped(void) {
+    play(ALARM, 2, MELODY_PRIORITY_ALARM);
+    TEST_ASSERT_FALSE(play(CLICK, 1, MELODY_PRIORITY_CLICK));
+    TEST_ASSERT_EQUAL(1, seq.dropped);
+    TEST_ASSERT_EQUAL(2, seq.count);
+
+    // Once the alarm is over, clicks play again
+    step();
+    step();
+    TEST_ASSERT_TRUE(play(CLICK, 1, MELODY_PRIORITY_CLICK));
+}
+
+void test_full_queue_drops_whole_melody(void) {
+    for (int i = 0; i < MELODY_QUEUE_NOTES / 3; i++) {
+        TEST_ASSERT_TRUE(play(CHIME, 3, MELODY_PRIORITY_EVENT));
+    }
+    TEST_ASSERT_FALSE(play(CHIME, 3, MELODY_PRIORITY_EVENT));
+    TEST_ASSERT_EQUAL(MELODY_QUEUE_NOTES / 3 * 3, seq.count);
+    TEST_ASSERT_EQUAL(1, seq.dropped);
+}
+
+void test_stop_silences(void) {
+    play(CHIME, 3, MELODY_PRIORITY_EVENT);
+    melody_stop(&seq);
+    TEST_ASSERT_FALSE(melody_busy(&seq));
+    TEST_ASSERT_EQUAL(MELODY_REST, seq.freq);
+    TEST_ASSERT_TRUE(play(CLICK, 1, MELODY_PRIORITY_CLICK));
+}
+
+void test_survives_time_wrap(void) {
+    clockMs = 0xFFFFFFFF - 100;
+    play(CHIME, 3, MELODY_PRIORITY_EVENT);
+    step();
+    step();
+    TEST_ASSERT_EQUAL(1500, seq.freq);
+    TEST_ASSERT_EQUAL(500, melody_next(&seq, clockMs));
+}
+
+// =============================================================================
+// TEST RUNNER
+// =============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Timing
+    RUN_TEST(test_idle_is_silent);
+    RUN_TEST(test_first_note_sounds_at_once);
+    RUN_TEST(test_notes_follow_in_order);
+    RUN_TEST(test_late_update_keeps_rhythm);
+    RUN_TEST(test_very_late_update_skips_finished_notes);
+
+    // Queue
+    RUN_TEST(test_equal_priority_queues_behind);
+    RUN_TEST(test_higher_priority_preempts);
+    RUN_TEST(test_lower_priority_dropped);
+    RUN_TEST(test_full_queue_drops_whole_melody);
+    RUN_TEST(test_stop_silences);
+    RUN_TEST(test_survives_time_wrap);
+
+    return UNITY_END();
+}
@@ -0,0 +1,200 @@
+/**
+ * Roxy RedLight v2.0 - Notification Queue Unit Tests
+ *
+ * Run with: pio test -e native -f test_notice
+ *
+ * Tests ordering by level, expiry, preemption and a full queue
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "notice.h"
+
+// =============================================================================
+// TEST FIXTURES
+// =============================================================================
+
+static NoticeQueue queue;
+
+void setUp(void) {
+    notice_init(&queue);
+}
+
+void tearDown(void) {
+    // Nothing to clean up
+}
+
+// =============================================================================
+// QUEUE TESTS
+// =============================================================================
+
+void test_empty_queue_shows_nothing(void) {
+    TEST_ASSERT_NULL(notice_current(&queue, 1000));
+    TEST_ASSERT_EQUAL(NOTICE_IDLE, notice_next(&queue, 1000));
+}
+
+void test_post_copies_and_truncates(void) {
+    char title[32];
+    strcpy(title, "A title much too long");
+    notice_post(&queue, NOTICE_INFO, title, "Detail", 0xFFFF, 2000);
+    title[0] = 'X';
+
+    const Notice* n = notice_current(&queue, 1000);
+    TEST_ASSERT_NOT_NULL(n);
+    TEST_ASSERT_EQUAL(NOTICE_TITLE_LEN - 1, strlen(n->title));
+    TEST_ASSERT_EQUAL('A', n->title[0]);
+    TEST_ASSERT_EQUAL_STRING("Detail", n->text);
+}
+
+void test_same_level_in_posting_order(void) {
+    notice_post(&queue, NOTICE_INFO, "First", "", 0, 2000);
+    notice_post(&queue, NOTICE_INFO, "Second", "", 0, 2000);
+
+    TEST_ASSERT_EQUAL_STRING("First", notice_current(&queue, 1000)->title);
+    TEST_ASSERT_EQUAL_STRING("Second", notice_current(&queue, 3000)->title);
+}
+
+// =============================================================================
+// TIMING TESTS
+// =============================================================================
+
+void test_expires_after_shown_duration(void) {
+    notice_post(&queue, NOTICE_INFO, "Done", "", 0, 2000);
+
+    // Timer starts when first shown, not when posted
+    TEST_ASSERT_NOT_NULL(notice_current(&queue, 5000));
+    TEST_ASSERT_EQUAL(2000, notice_next(&queue, 5000));
+    TEST_ASSERT_EQUAL(500, notice_next(&queue, 6500));
+    TEST_ASSERT_NOT_NULL(notice_current(&queue, 6999));
+    TEST_ASSERT_NULL(notice_current(&queue, 7000));
+}
+
+void test_not_shown_has_no_deadline(void) {
+    notice_post(&queue, NOTICE_INFO, "Done", "", 0, 2000);
+    TEST_ASSERT_EQUAL(NOTICE_IDLE, notice_next(&queue, 1000));
+}
+
+void test_survives_time_wrap(void) {
+    notice_post(&queue, NOTICE_INFO, "Done", "", 0, 2000);
+    notice_current(&queue, 0xFFFFFFFF - 500);
+    TEST_ASSERT_NOT_NULL(notice_current(&queue, 1000));
+    TEST_ASSERT_NULL(notice_current(&queue, 1500));
+}
+
+// =============================================================================
+// PRIORITY TESTS
+// =============================================================================
+
+void test_critical_preempts_toast(void) {
+    notice_post(&queue, NOTICE_INFO, "Toast", "", 0, 3000);
+    notice_current(&queue, 1000);
+
+    notice_post(&queue, NOTICE_CRITICAL, "Alert", "", 0, 1000);
+    TEST_ASSERT_EQUAL_STRING("Alert", notice_current(&queue, 1500)->title);
+
+    // The toast's own time kept running underneath
+    TEST_ASSERT_EQUAL_STRING("Toast", notice_current(&queue, 2500)->title);
+    TEST_ASSERT_NULL(notice_current(&queue, 4000));
+}
+
+void test_full_queue_evicts_least_urgent(void) {
+    for (int i = 0; i < NOTICE_SLOTS - 1; i++) {
+        notice_post(&queue, NOTICE_WARNING, "Warn", "", 0, 1000);
+    }
+    notice_post(&queue, NOTICE_INFO, "Info", "", 0, 1000);
+
+    TEST_ASSERT_TRUE(notice_post(&queue, NOTICE_CRITICAL, "Alert", "", 0, 1000));
+    TEST_ASSERT_EQUAL(1, queue.dropped);
+
+    // The info toast made room
+    for (int i = 0; i < NOTICE_SLOTS; i++) {
+        TEST_ASSERT_NOT_EQUAL(NOTICE_INFO, queue.slots[i].level);
+    }
+}
+
+void test_full_queue_refuses_less_urgent(void) {
+    for (int i = 0; i < NOTICE_SLOTS; i++) {
+        notice_post(&queue, NOTICE_CRITICAL, "Alert", "", 0, 1000);
+    }
+    TEST_ASSERT_FALSE(notice_post(&queue, NOTICE_INFO, "Info", "", 0, 1000));
+    TEST_ASSERT_EQUAL(1, queue.dropped);
+}
+
+void test_ids_unique_per_post(void) {
+    notice_post(&queue, NOTICE_INFO, "Same", "", 0, 1000);
+    uint32_t first = notice_current(&queue, 0)->id;
+    notice_current(&queue, 1000);
+    notice_post(&queue, NOTICE_INFO, "Same", "", 0, 1000);
+    TEST_ASSERT_NOT_EQUAL(first, notice_current(&queue, 1000)->id);
+}
+
+// =============================================================================
+// STICKY TESTS
+// =============================================================================
+
+void test_sticky_never_expires(void) {
+    notice_post(&queue, NOTICE_CRITICAL, "Trip", "", 0, NOTICE_STICKY);
+    notice_current(&queue, 1000);
+    TEST_ASSERT_EQUAL(NOTICE_IDLE, notice_next(&queue, 1000));
+    TEST_ASSERT_NOT_NULL(notice_current(&queue, 1000 + 86400000UL));
+}
+
+void test_acknowledge_clears_sticky(void) {
+    notice_post(&queue, NOTICE_CRITICAL, "Trip", "", 0, NOTICE_STICKY);
+    notice_post(&queue, NOTICE_INFO, "Toast", "", 0, 1000);
+    notice_current(&queue, 1000);
+
+    TEST_ASSERT_TRUE(notice_acknowledge(&queue));
+    TEST_ASSERT_EQUAL_STRING("Toast", notice_current(&queue, 2000)->title);
+    TEST_ASSERT_FALSE(notice_acknowledge(&queue));
+}
+
+void test_acknowledge_ignores_timed(void) {
+    notice_post(&queue, NOTICE_CRITICAL, "Alert", "", 0, 1000);
+    notice_current(&queue, 0);
+    TEST_ASSERT_FALSE(notice_acknowledge(&queue));
+    TEST_ASSERT_NOT_NULL(notice_current(&queue, 500));
+}
+
+void test_full_queue_keeps_sticky(void) {
+    for (int i = 0; i < NOTICE_SLOTS; i++) {
+        notice_post(&queue, NOTICE_CRITICAL, "Trip", "", 0, NOTICE_STICKY);
+    }
+    TEST_ASSERT_FALSE(notice_post(&queue, NOTICE_CRITICAL, "Alert", "", 0, 1000));
+    TEST_ASSERT_EQUAL(1, queue.dropped);
+    for (int i = 0; i < NOTICE_SLOTS; i++) {
+        TEST_ASSERT_EQUAL_STRING("Trip", queue.slots[i].title);
+    }
+}
+
+// =============================================================================
+// TEST RUNNER
+// =============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Queue
+    RUN_TEST(test_empty_queue_shows_nothing);
+    RUN_TEST(test_post_copies_and_truncates);
+    RUN_TEST(test_same_level_in_posting_order);
+
+    // Timing
+    RUN_TEST(test_expires_after_shown_duration);
+    RUN_TEST(test_not_shown_has_no_deadline);
+    RUN_TEST(test_survives_time_wrap);
+
+    // Priority
+    RUN_TEST(test_critical_preempts_toast);
+    RUN_TEST(test_full_queue_evicts_least_urgent);
+    RUN_TEST(test_full_queue_refuses_less_urgent);
+    RUN_TEST(test_ids_unique_per_post);
+
+    // Sticky
+    RUN_TEST(test_sticky_never_expires);
+    RUN_TEST(test_acknowledge_clears_sticky);
+    RUN_TEST(test_acknowledge_ignores_timed);
+    RUN_TEST(test_full_queue_keeps_sticky);
+
+    return UNITY_END();
+}
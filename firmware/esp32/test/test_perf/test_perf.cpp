@@ -0,0 +1,146 @@
+/**
+ * Roxy RedLight v2.0 - Timing Histogram Unit Tests
+ *
+ * Run with: pio test -e native -f test_perf
+ *
+ * Tests bucketing, summary statistics and percentiles
+ */
+
+#include <unity.h>
+#include "perf.h"
+
+// =============================================================================
+// TEST FIXTURES
+// =============================================================================
+
+static PerfHist hist;
+
+void setUp(void) {
+    perf_init(&hist);
+}
+
+void tearDown(void) {
+    // Nothing to clean up
+}
+
+// =============================================================================
+// BUCKET TESTS
+// =============================================================================
+
+void test_small_values_exact_buckets(void) {
+    for (uint32_t v = 0; v < 8; v++) {
+        TEST_ASSERT_EQUAL(v, perf_bucket(v));
+    }
+}
+
+void test_buckets_monotonic(void) {
+    uint16_t prev = 0;
+    for (uint32_t v = 1; v < 100000; v += 7) {
+        uint16_t b = perf_bucket(v);
+        TEST_ASSERT_GREATER_OR_EQUAL(prev, b);
+        prev = b;
+    }
+}
+
+void test_largest_value_in_range(void) {
+    TEST_ASSERT_EQUAL(PERF_BUCKETS - 1, perf_bucket(UINT32_MAX));
+}
+
+// =============================================================================
+// SUMMARY TESTS
+// =============================================================================
+
+void test_empty_reports_zero(void) {
+    TEST_ASSERT_EQUAL(0, hist.count);
+    TEST_ASSERT_EQUAL(0, perf_avg(&hist));
+    TEST_ASSERT_EQUAL(0, perf_percentile(&hist, 99));
+}
+
+void test_min_avg_max(void) {
+    perf_record(&hist, 300);
+    perf_record(&hist, 100);
+    perf_record(&hist, 200);
+
+    TEST_ASSERT_EQUAL(3, hist.count);
+    TEST_ASSERT_EQUAL(100, perf_min(&hist));
+    TEST_ASSERT_EQUAL(200, perf_avg(&hist));
+    TEST_ASSERT_EQUAL(300, perf_max(&hist));
+}
+
+void test_single_sample_percentile_exact(void) {
+    perf_record(&hist, 123456);
+    TEST_ASSERT_EQUAL(123456, perf_percentile(&hist, 50));
+    TEST_ASSERT_EQUAL(123456, perf_percentile(&hist, 99));
+}
+
+// =============================================================================
+// PERCENTILE TESTS
+// =============================================================================
+
+void test_p99_finds_outliers(void) {
+    // 98 fast frames, 2 slow ones: p99 must land on the slow ones
+    for (int i = 0; i < 98; i++) {
+        perf_record(&hist, 1000);
+    }
+    perf_record(&hist, 50000);
+    perf_record(&hist, 50000);
+
+    uint32_t p50 = perf_percentile(&hist, 50);
+    uint32_t p99 = perf_percentile(&hist, 99);
+    TEST_ASSERT_UINT32_WITHIN(250, 1000, p50);
+    TEST_ASSERT_UINT32_WITHIN(12500, 50000, p99);
+}
+
+void test_percentile_within_bucket_error(void) {
+    for (uint32_t v = 1; v <= 1000; v++) {
+        perf_record(&hist, v * 100);
+    }
+
+    // True p90 is 90000; buckets are 25% wide at most
+    uint32_t p90 = perf_percentile(&hist, 90);
+    TEST_ASSERT_GREATER_OR_EQUAL(90000, p90);
+    TEST_ASSERT_LESS_OR_EQUAL(90000 + 90000 / 4, p90);
+}
+
+void test_percentile_clamped_to_max(void) {
+    perf_record(&hist, 1000);
+    perf_record(&hist, 1001);
+    TEST_ASSERT_LESS_OR_EQUAL(1001, perf_percentile(&hist, 100));
+}
+
+void test_bucket_overflow_keeps_shape(void) {
+    // Enough samples to overflow a 16-bit bucket
+    for (uint32_t i = 0; i < 70000; i++) {
+        perf_record(&hist, (i % 10 == 0) ? 8000 : 1000);
+    }
+
+    TEST_ASSERT_EQUAL(70000, hist.count);
+    TEST_ASSERT_UINT32_WITHIN(250, 1000, perf_percentile(&hist, 50));
+    TEST_ASSERT_UINT32_WITHIN(2000, 8000, perf_percentile(&hist, 95));
+}
+
+// =============================================================================
+// TEST RUNNER
+// =============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Buckets
+    RUN_TEST(test_small_values_exact_buckets);
+    RUN_TEST(test_buckets_monotonic);
+    RUN_TEST(test_largest_value_in_range);
+
+    // Summary
+    RUN_TEST(test_empty_reports_zero);
+    RUN_TEST(test_min_avg_max);
+    RUN_TEST(test_single_sample_percentile_exact);
+
+    // Percentiles
+    RUN_TEST(test_p99_finds_outliers);
+    RUN_TEST(test_percentile_within_bucket_error);
+    RUN_TEST(test_percentile_clamped_to_max);
+    RUN_TEST(test_bucket_overflow_keeps_shape);
+
+    return UNITY_END();
+}
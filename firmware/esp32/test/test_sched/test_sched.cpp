@@ -0,0 +1,255 @@
+/**
+ * Roxy RedLight v2.0 - Job Scheduler Unit Tests
+ *
+ * Run with: pio test -e native -f test_sched
+ *
+ * Tests timer wheel deadlines across levels, periodic phase, stopping
+ * from jobs, lateness accounting and time wrap
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "sched.h"
+
+// =============================================================================
+// TEST FIXTURES
+// =============================================================================
+
+static Scheduler sched;
+static SchedJob jobs[4];
+static uint32_t clockMs;
+static uint32_t runs[4];
+static uint32_t lastRun[4];
+
+static void countRun(void* arg) {
+    int i = (int)(intptr_t)arg;
+    runs[i]++;
+    lastRun[i] = clockMs;
+}
+
+static void stopOther(void* arg) {
+    countRun(arg);
+    sched_stop(&sched, &jobs[1]);
+}
+
+// Step the clock a millisecond at a time, as a busy loop would
+static void advance(uint32_t ms) {
+    for (uint32_t i = 0; i < ms; i++) {
+        clockMs++;
+        sched_run(&sched, clockMs);
+    }
+}
+
+static void startAt(uint32_t time) {
+    clockMs = time;
+    sched_init(&sched, clockMs);
+    for (int i = 0; i < 4; i++) {
+        sched_job_init(&jobs[i], "test", countRun, (void*)(intptr_t)i);
+        runs[i] = 0;
+        lastRun[i] = 0;
+    }
+}
+
+void setUp(void) {
+    startAt(1000);
+}
+
+void tearDown(void) {
+    // Nothing to clean up
+}
+
+// =============================================================================
+// DEADLINE TESTS
+// =============================================================================
+
+void test_one_shot_runs_at_deadline(void) {
+    sched_start(&sched, &jobs[0], clockMs, 10, 0);
+
+    advance(9);
+    TEST_ASSERT_EQUAL(0, runs[0]);
+    advance(1);
+    TEST_ASSERT_EQUAL(1, runs[0]);
+    TEST_ASSERT_FALSE(sched_active(&jobs[0]));
+
+    advance(100);
+    TEST_ASSERT_EQUAL(1, runs[0]);
+}
+
+void test_deadlines_exact_on_every_level(void) {
+    // Level 0, 1, 2 and 3 delays (20 minutes: a session)
+    const uint32_t delays[4] = {50, 3000, 100000, 1200000};
+    for (int i = 0; i < 4; i++) {
+        sched_start(&sched, &jobs[i], clockMs, delays[i], 0);
+    }
+    uint32_t start = clockMs;
+
+    advance(1200000);
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL(1, runs[i]);
+        TEST_ASSERT_EQUAL(start + delays[i], lastRun[i]);
+    }
+}
+
+void test_beyond_wheel_span_still_exact(void) {
+    uint32_t delay = (1UL << (SCHED_SLOT_BITS * SCHED_LEVELS)) + 12345;
+    sched_start(&sched, &jobs[0], clockMs, delay, 0);
+    uint32_t due = clockMs + delay;
+
+    // Large steps are fine: the wheel catches up tick by tick
+    while (clockMs + 1000 < due) {
+        clockMs += 1000;
+        sched_run(&sched, clockMs);
+    }
+    TEST_ASSERT_EQUAL(0, runs[0]);
+    advance(due - clockMs);
+    TEST_ASSERT_EQUAL(1, runs[0]);
+}
+
+void test_periodic_keeps_period(void) {
+    sched_start(&sched, &jobs[0], clockMs, 100, 100);
+    advance(1000);
+    TEST_ASSERT_EQUAL(10, runs[0]);
+    TEST_ASSERT_TRUE(sched_active(&jobs[0]));
+}
+
+void test_deadlines_survive_time_wrap(void) {
+    startAt(0xFFFFFFFF - 30);
+    sched_start(&sched, &jobs[0], clockMs, 100, 0);
+    uint32_t due = clockMs + 100;
+
+    advance(100);
+    TEST_ASSERT_EQUAL(1, runs[0]);
+    TEST_ASSERT_EQUAL(due, lastRun[0]);
+}
+
+// =============================================================================
+// CONTROL TESTS
+// =============================================================================
+
+void test_stop_cancels(void) {
+    sched_start(&sched, &jobs[0], clockMs, 10, 10);
+    advance(25);
+    sched_stop(&sched, &jobs[0]);
+    advance(100);
+    TEST_ASSERT_EQUAL(2, runs[0]);
+}
+
+void test_stop_from_job_in_same_slot(void) {
+    jobs[0].fn = stopOther;
+    sched_start(&sched, &jobs[1], clockMs, 10, 0);
+    sched_start(&sched, &jobs[0], clockMs, 10, 0);  // Linked ahead of job 1
+
+    advance(10);
+    TEST_ASSERT_EQUAL(1, runs[0]);
+    TEST_ASSERT_EQUAL(0, runs[1]);
+}
+
+void test_restart_moves_deadline(void) {
+    sched_start(&sched, &jobs[0], clockMs, 10, 0);
+    advance(5);
+    sched_start(&sched, &jobs[0], clockMs, 10, 0);
+    advance(9);
+    TEST_ASSERT_EQUAL(0, runs[0]);
+    advance(1);
+    TEST_ASSERT_EQUAL(1, runs[0]);
+}
+
+void test_next_reports_earliest(void) {
+    TEST_ASSERT_EQUAL(SCHED_IDLE, sched_next(&sched, clockMs));
+
+    sched_start(&sched, &jobs[0], clockMs, 5000, 0);
+    sched_start(&sched, &jobs[1], clockMs, 70, 0);
+    TEST_ASSERT_EQUAL(70, sched_next(&sched, clockMs));
+
+    advance(30);
+    TEST_ASSERT_EQUAL(40, sched_next(&sched, clockMs));
+    TEST_ASSERT_EQUAL(0, sched_next(&sched, clockMs + 50));    // Overdue
+}
+
+// =============================================================================
+// ACCOUNTING TESTS
+// =============================================================================
+
+void test_lateness_recorded(void) {
+    sched_start(&sched, &jobs[0], clockMs, 10, 0);
+    clockMs += 17;
+    sched_run(&sched, clockMs);
+
+    TEST_ASSERT_EQUAL(1, jobs[0].runs);
+    TEST_ASSERT_EQUAL(7, jobs[0].lateMax);
+    TEST_ASSERT_EQUAL(7, sched_late_avg(&jobs[0]));
+}
+
+void test_missed_periods_skipped_on_phase(void) {
+    sched_start(&sched, &jobs[0], clockMs, 100, 100);
+    uint32_t start = clockMs;
+
+    // Blocked for 350 ms past the first deadline: 3 periods lost
+    clockMs += 450;
+    sched_run(&sched, clockMs);
+    TEST_ASSERT_EQUAL(1, runs[0]);
+    TEST_ASSERT_EQUAL(3, jobs[0].missed);
+
+    // Back on the 100 ms grid
+    advance(start + 500 - clockMs);
+    TEST_ASSERT_EQUAL(2, runs[0]);
+    TEST_ASSERT_EQUAL(start + 500, lastRun[0]);
+
+    sched_reset_stats(&jobs[0]);
+    TEST_ASSERT_EQUAL(0, jobs[0].missed);
+    TEST_ASSERT_EQUAL(0, sched_late_avg(&jobs[0]));
+}
+
+// =============================================================================
+// THROUGHPUT
+// =============================================================================
+
+void test_hour_of_loop_jobs(void) {
+    // The firmware's mix: display, telemetry, thermal, battery
+    const uint32_t periods[4] = {100, 1000, 2000, 5000};
+    for (int i = 0; i < 4; i++) {
+        sched_start(&sched, &jobs[i], clockMs, periods[i], periods[i]);
+    }
+
+    // Woken only at deadlines, as the sleeping loop is
+    uint32_t end = clockMs + 3600000UL;
+    while (clockMs < end) {
+        clockMs += sched_next(&sched, clockMs);
+        sched_run(&sched, clockMs);
+    }
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL(3600000UL / periods[i], runs[i]);
+        TEST_ASSERT_EQUAL(0, jobs[i].lateMax);
+        TEST_ASSERT_EQUAL(0, jobs[i].missed);
+    }
+}
+
+// =============================================================================
+// TEST RUNNER
+// =============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Deadlines
+    RUN_TEST(test_one_shot_runs_at_deadline);
+    RUN_TEST(test_deadlines_exact_on_every_level);
+    RUN_TEST(test_beyond_wheel_span_still_exact);
+    RUN_TEST(test_periodic_keeps_period);
+    RUN_TEST(test_deadlines_survive_time_wrap);
+
+    // Control
+    RUN_TEST(test_stop_cancels);
+    RUN_TEST(test_stop_from_job_in_same_slot);
+    RUN_TEST(test_restart_moves_deadline);
+    RUN_TEST(test_next_reports_earliest);
+
+    // Accounting
+    RUN_TEST(test_lateness_recorded);
+    RUN_TEST(test_missed_periods_skipped_on_phase);
+
+    // Throughput
+    RUN_TEST(test_hour_of_loop_jobs);
+
+    return UNITY_END();
+}
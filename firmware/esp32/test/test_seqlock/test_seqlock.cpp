@@ -0,0 +1,153 @@
+/**
+ * Roxy RedLight v2.0 - Sequence Lock Unit Tests
+ *
+ * Run with: pio test -e native -f test_seqlock
+ *
+ * Tests publishing, torn-read detection and a reader interleaved with the
+ * writer
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "seqlock.h"
+
+// =============================================================================
+// TEST FIXTURES
+// =============================================================================
+
+typedef struct {
+    uint32_t a;
+    uint32_t b;                 // Always a * 3 in a whole value
+    float c;
+    bool flag;
+} Value;
+
+static Seqlock lock;
+static Value slots[2];
+
+static Value make(uint32_t a) {
+    Value v;
+    memset(&v, 0, sizeof(v));
+    v.a = a;
+    v.b = a * 3;
+    v.c = a * 0.5f;
+    v.flag = (a % 2) != 0;
+    return v;
+}
+
+static void publish(uint32_t a) {
+    Value v = make(a);
+    seqlock_publish(&lock, slots, sizeof(Value), &v);
+}
+
+void setUp(void) {
+    seqlock_init(&lock);
+    memset(slots, 0, sizeof(slots));
+}
+
+void tearDown(void) {
+    // Nothing to clean up
+}
+
+// =============================================================================
+// PUBLISH TESTS
+// =============================================================================
+
+void test_read_returns_latest(void) {
+    publish(1);
+    publish(2);
+    publish(3);
+
+    Value out;
+    TEST_ASSERT_EQUAL(0, seqlock_read(&lock, slots, sizeof(Value), &out));
+    TEST_ASSERT_EQUAL(3, out.a);
+    TEST_ASSERT_EQUAL(9, out.b);
+    TEST_ASSERT_EQUAL_FLOAT(1.5f, out.c);
+    TEST_ASSERT_TRUE(out.flag);
+}
+
+void test_publish_alternates_slots(void) {
+    publish(1);
+    const void* first = seqlock_slot(slots, sizeof(Value), seqlock_read_begin(&lock));
+    publish(2);
+    const void* second = seqlock_slot(slots, sizeof(Value), seqlock_read_begin(&lock));
+    TEST_ASSERT_TRUE(first != second);
+}
+
+// =============================================================================
+// INTERLEAVING TESTS
+// =============================================================================
+
+void test_uncontended_read_valid(void) {
+    publish(7);
+    uint32_t seq = seqlock_read_begin(&lock);
+    Value out;
+    memcpy(&out, seqlock_slot(slots, sizeof(Value), seq), sizeof(Value));
+    TEST_ASSERT_TRUE(seqlock_read_valid(&lock, seq));
+    TEST_ASSERT_EQUAL(7, out.a);
+}
+
+void test_publish_leaves_slot_being_read(void) {
+    // A reader mid-copy when the writer runs: the writer fills the other
+    // slot, so the half-read value stays whole
+    publish(4);
+    uint32_t seq = seqlock_read_begin(&lock);
+    const Value* reading = (const Value*)seqlock_slot(slots, sizeof(Value), seq);
+    publish(5);
+
+    TEST_ASSERT_EQUAL(4, reading->a);
+    TEST_ASSERT_EQUAL(12, reading->b);
+}
+
+void test_publish_during_read_detected(void) {
+    publish(4);
+    uint32_t seq = seqlock_read_begin(&lock);
+    Value out;
+    memcpy(&out, seqlock_slot(slots, sizeof(Value), seq), sizeof(Value));
+    publish(5);
+
+    // The next publish would reuse the slot: reject the copy
+    TEST_ASSERT_FALSE(seqlock_read_valid(&lock, seq));
+}
+
+void test_second_publish_reuses_slot(void) {
+    publish(4);
+    uint32_t seq = seqlock_read_begin(&lock);
+    const Value* reading = (const Value*)seqlock_slot(slots, sizeof(Value), seq);
+    publish(5);
+    publish(6);
+
+    // Two publishes on, the reader's slot has been overwritten
+    TEST_ASSERT_EQUAL(6, reading->a);
+}
+
+void test_survives_sequence_wrap(void) {
+    lock.seq = 0xFFFFFFFF;
+    publish(8);
+    TEST_ASSERT_EQUAL(0, lock.seq);
+
+    Value out;
+    seqlock_read(&lock, slots, sizeof(Value), &out);
+    TEST_ASSERT_EQUAL(8, out.a);
+}
+
+// =============================================================================
+// TEST RUNNER
+// =============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Publish
+    RUN_TEST(test_read_returns_latest);
+    RUN_TEST(test_publish_alternates_slots);
+
+    // Interleaving
+    RUN_TEST(test_uncontended_read_valid);
+    RUN_TEST(test_publish_leaves_slot_being_read);
+    RUN_TEST(test_publish_during_read_detected);
+    RUN_TEST(test_second_publish_reuses_slot);
+    RUN_TEST(test_survives_sequence_wrap);
+
+    return UNITY_END();
+}
@@ -0,0 +1,199 @@
+/**
+ * Roxy RedLight v2.0 - Safety Supervisor Unit Tests
+ *
+ * Run with: pio test -e native -f test_supervisor
+ *
+ * Tests fault latching, deadline accounting and the fault-to-off bound
+ */
+
+#include <unity.h>
+#include "supervisor.h"
+
+// =============================================================================
+// TEST FIXTURES
+// =============================================================================
+
+#define PERIOD_MS       100
+#define DEADLINE_MS     10
+#define MS              1000UL
+#define GOOD_V          7.4f
+#define GOOD_C          25.0f
+
+static Supervisor sup;
+static uint32_t clockUs;
+
+// One check on time, taking execUs
+static bool check(float voltage, float temp_c, bool active, uint32_t elapsed, uint32_t execUs) {
+    supervisor_begin(&sup, clockUs);
+    bool off = supervisor_check(&sup, voltage, temp_c, active, elapsed);
+    if (off) {
+        supervisor_leds_off(&sup, clockUs + execUs / 2);
+    }
+    supervisor_end(&sup, clockUs + execUs);
+    clockUs += PERIOD_MS * MS;
+    return off;
+}
+
+void setUp(void) {
+    clockUs = 5000000;
+    supervisor_init(&sup, clockUs, PERIOD_MS, DEADLINE_MS);
+}
+
+void tearDown(void) {
+    // Nothing to clean up
+}
+
+// =============================================================================
+// VERDICT TESTS
+// =============================================================================
+
+void test_good_readings_keep_leds_on(void) {
+    TEST_ASSERT_FALSE(check(GOOD_V, GOOD_C, true, 60, 200));
+    TEST_ASSERT_EQUAL(SAFETY_OK, sup.fault);
+    TEST_ASSERT_EQUAL(0, sup.trips);
+}
+
+void test_voltage_and_heat_faults_trip(void) {
+    TEST_ASSERT_TRUE(check(8.9f, GOOD_C, true, 60, 200));
+    TEST_ASSERT_EQUAL(SAFETY_ERR_OVERVOLTAGE, sup.tripFault);
+
+    supervisor_init(&sup, clockUs, PERIOD_MS, DEADLINE_MS);
+    TEST_ASSERT_TRUE(check(5.9f, GOOD_C, false, 0, 200));
+    TEST_ASSERT_EQUAL(SAFETY_ERR_UNDERVOLTAGE, sup.tripFault);
+
+    supervisor_init(&sup, clockUs, PERIOD_MS, DEADLINE_MS);
+    TEST_ASSERT_TRUE(check(GOOD_V, 47.0f, true, 60, 200));
+    TEST_ASSERT_EQUAL(SAFETY_ERR_THERMAL, sup.tripFault);
+}
+
+void test_no_sensor_never_trips_thermal(void) {
+    TEST_ASSERT_FALSE(check(GOOD_V, SUPERVISOR_NO_SENSOR, true, 60, 200));
+}
+
+void test_session_length_only_while_running(void) {
+    TEST_ASSERT_FALSE(check(GOOD_V, GOOD_C, false, SAFETY_MAX_SESSION_SEC + 10, 200));
+    TEST_ASSERT_TRUE(check(GOOD_V, GOOD_C, true, SAFETY_MAX_SESSION_SEC, 200));
+    TEST_ASSERT_EQUAL(SAFETY_ERR_SESSION_TOO_LONG, sup.tripFault);
+}
+
+void test_lasting_fault_trips_once(void) {
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_TRUE(check(5.9f, GOOD_C, true, 60, 200));  // Held off every check
+    }
+    TEST_ASSERT_EQUAL(1, sup.trips);
+
+    // Recovers, then a new fault trips again
+    TEST_ASSERT_FALSE(check(GOOD_V, GOOD_C, false, 0, 200));
+    TEST_ASSERT_EQUAL(SAFETY_OK, sup.fault);
+    TEST_ASSERT_TRUE(check(GOOD_V, 50.0f, false, 0, 200));
+    TEST_ASSERT_EQUAL(2, sup.trips);
+}
+
+// =============================================================================
+// TIMING TESTS
+// =============================================================================
+
+void test_off_latency_timed_from_check_start(void) {
+    check(8.9f, GOOD_C, true, 60, 400);
+    TEST_ASSERT_EQUAL(200, sup.offLatencyUs);
+
+    // Later checks holding the LEDs off are not trips
+    check(8.9f, GOOD_C, true, 60, 4000);
+    TEST_ASSERT_EQUAL(200, sup.offLatencyMaxUs);
+}
+
+void test_late_start_and_slow_check_recorded(void) {
+    clockUs += 3 * MS;      // Woken 3 ms late
+    check(GOOD_V, GOOD_C, false, 0, 2 * MS);
+
+    TEST_ASSERT_EQUAL(3 * MS, sup.lateMaxUs);
+    TEST_ASSERT_EQUAL(2 * MS, sup.execMaxUs);
+    TEST_ASSERT_EQUAL(5 * MS, sup.responseMaxUs);
+    TEST_ASSERT_EQUAL(0, sup.missed);
+}
+
+void test_deadline_miss_counted(void) {
+    check(GOOD_V, GOOD_C, false, 0, DEADLINE_MS * MS + 1);
+    TEST_ASSERT_EQUAL(1, sup.missed);
+    check(GOOD_V, GOOD_C, false, 0, 100);
+    TEST_ASSERT_EQUAL(1, sup.missed);
+}
+
+void test_skipped_releases_counted(void) {
+    clockUs += 3 * PERIOD_MS * MS + 2 * MS;     // Stalled through three checks
+    check(GOOD_V, GOOD_C, false, 0, 100);
+
+    TEST_ASSERT_EQUAL(3, sup.missed);
+    TEST_ASSERT_EQUAL(2 * MS, sup.lateMaxUs);   // Measured from the release it ran for
+    TEST_ASSERT_EQUAL(1, sup.runs);
+}
+
+void test_worst_case_bound(void) {
+    clockUs += 1 * MS;
+    check(GOOD_V, GOOD_C, false, 0, 300);
+    TEST_ASSERT_EQUAL(PERIOD_MS * MS + 1 * MS + 300, supervisor_worst_case(&sup));
+}
+
+void test_survives_time_wrap(void) {
+    clockUs = 0xFFFFFFFF - 50 * MS;
+    supervisor_init(&sup, clockUs, PERIOD_MS, DEADLINE_MS);
+    for (int i = 0; i < 3; i++) {
+        check(GOOD_V, GOOD_C, false, 0, 500);
+    }
+    TEST_ASSERT_EQUAL(0, sup.missed);
+    TEST_ASSERT_EQUAL(500, sup.responseMaxUs);
+}
+
+void test_slower_period_moves_next_release(void) {
+    uint32_t release = clockUs;
+    check(GOOD_V, GOOD_C, false, 0, 100);
+    supervisor_set_period(&sup, release + 1 * MS, 20 * PERIOD_MS);
+    TEST_ASSERT_EQUAL(release + 20 * PERIOD_MS * MS, sup.releaseUs);
+
+    // On time at the new release: nothing missed
+    clockUs = sup.releaseUs;
+    check(GOOD_V, GOOD_C, false, 0, 100);
+    TEST_ASSERT_EQUAL(0, sup.missed);
+    TEST_ASSERT_EQUAL(0, sup.lateMaxUs);
+}
+
+void test_faster_period_due_at_once(void) {
+    supervisor_init(&sup, clockUs, 20 * PERIOD_MS, DEADLINE_MS);
+    supervisor_begin(&sup, clockUs);
+    supervisor_end(&sup, clockUs + 100);
+
+    // Woken early, well past one short period since the last check
+    clockUs += 15 * PERIOD_MS * MS;
+    supervisor_set_period(&sup, clockUs, PERIOD_MS);
+    TEST_ASSERT_EQUAL(clockUs, sup.releaseUs);
+    check(GOOD_V, GOOD_C, true, 0, 100);
+    TEST_ASSERT_EQUAL(0, sup.missed);
+    TEST_ASSERT_EQUAL(PERIOD_MS * MS + 100, supervisor_worst_case(&sup));
+}
+
+// =============================================================================
+// TEST RUNNER
+// =============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Verdict
+    RUN_TEST(test_good_readings_keep_leds_on);
+    RUN_TEST(test_voltage_and_heat_faults_trip);
+    RUN_TEST(test_no_sensor_never_trips_thermal);
+    RUN_TEST(test_session_length_only_while_running);
+    RUN_TEST(test_lasting_fault_trips_once);
+
+    // Timing
+    RUN_TEST(test_off_latency_timed_from_check_start);
+    RUN_TEST(test_late_start_and_slow_check_recorded);
+    RUN_TEST(test_deadline_miss_counted);
+    RUN_TEST(test_skipped_releases_counted);
+    RUN_TEST(test_worst_case_bound);
+    RUN_TEST(test_survives_time_wrap);
+    RUN_TEST(test_slower_period_moves_next_release);
+    RUN_TEST(test_faster_period_due_at_once);
+
+    return UNITY_END();
+}
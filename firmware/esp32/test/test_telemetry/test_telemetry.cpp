@@ -0,0 +1,222 @@
+/**
+ * Roxy RedLight v2.0 - Telemetry Trace Unit Tests
+ *
+ * Run with: pio test -e native -f test_telemetry
+ *
+ * Tests the sample ring, min/max decimation and chart scaling
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "telemetry.h"
+
+// =============================================================================
+// TEST FIXTURES
+// =============================================================================
+
+static TelemetryRing ring;
+static TelemetryTrace trace;
+static uint8_t rows[TELEMETRY_COLUMNS][2];
+
+static TelemetrySample sampleOf(int16_t volts) {
+    TelemetrySample s;
+    s.value[SERIES_VOLTS] = volts;
+    s.value[SERIES_TEMP] = 250;
+    s.value[SERIES_DUTY] = 50;
+    return s;
+}
+
+static void addVolts(int16_t volts) {
+    TelemetrySample s = sampleOf(volts);
+    telemetry_trace_add(&trace, &s);
+}
+
+void setUp(void) {
+    telemetry_ring_init(&ring);
+    telemetry_trace_init(&trace, 1, true);
+}
+
+void tearDown(void) {
+    // Nothing to clean up
+}
+
+// =============================================================================
+// RING TESTS
+// =============================================================================
+
+void test_ring_reads_in_order(void) {
+    uint32_t cursor = ring.written;
+    for (int16_t v = 0; v < 5; v++) {
+        TelemetrySample s = sampleOf(v);
+        telemetry_ring_push(&ring, &s);
+    }
+
+    TelemetrySample out;
+    for (int16_t v = 0; v < 5; v++) {
+        TEST_ASSERT_TRUE(telemetry_ring_read(&ring, &cursor, &out));
+        TEST_ASSERT_EQUAL(v, out.value[SERIES_VOLTS]);
+    }
+    TEST_ASSERT_FALSE(telemetry_ring_read(&ring, &cursor, &out));
+}
+
+void test_ring_overrun_resumes_at_oldest(void) {
+    uint32_t cursor = ring.written;
+    for (int16_t v = 0; v < TELEMETRY_RING_SIZE + 10; v++) {
+        TelemetrySample s = sampleOf(v);
+        telemetry_ring_push(&ring, &s);
+    }
+
+    TelemetrySample out;
+    TEST_ASSERT_TRUE(telemetry_ring_read(&ring, &cursor, &out));
+    TEST_ASSERT_EQUAL(10, out.value[SERIES_VOLTS]);
+
+    int reads = 1;
+    while (telemetry_ring_read(&ring, &cursor, &out)) {
+        reads++;
+    }
+    TEST_ASSERT_EQUAL(TELEMETRY_RING_SIZE, reads);
+}
+
+// =============================================================================
+// DECIMATION TESTS
+// =============================================================================
+
+void test_growing_trace_merges_when_full(void) {
+    for (int16_t v = 0; v < TELEMETRY_COLUMNS; v++) {
+        addVolts(v);
+    }
+    TEST_ASSERT_EQUAL(TELEMETRY_COLUMNS, trace.count);
+    TEST_ASSERT_EQUAL(1, trace.span);
+
+    addVolts(TELEMETRY_COLUMNS);
+    TEST_ASSERT_EQUAL(TELEMETRY_COLUMNS / 2 + 1, trace.count);
+    TEST_ASSERT_EQUAL(2, trace.span);
+
+    // First merged column covers samples 0 and 1
+    const TelemetryColumn* first = telemetry_trace_column(&trace, 0);
+    TEST_ASSERT_EQUAL(0, first->lo[SERIES_VOLTS]);
+    TEST_ASSERT_EQUAL(1, first->hi[SERIES_VOLTS]);
+}
+
+void test_growing_trace_keeps_extremes(void) {
+    // A one-sample dip among thousands must survive every merge
+    for (int i = 0; i < 5000; i++) {
+        addVolts(i == 3333 ? 600 : 740);
+    }
+    TEST_ASSERT_LESS_OR_EQUAL(TELEMETRY_COLUMNS, trace.count);
+
+    int16_t lo, hi;
+    telemetry_trace_range(&trace, SERIES_VOLTS, 0, &lo, &hi);
+    TEST_ASSERT_EQUAL(600, lo);
+    TEST_ASSERT_EQUAL(740, hi);
+}
+
+void test_growing_trace_covers_all_samples(void) {
+    for (int i = 0; i < 1000; i++) {
+        addVolts(740);
+    }
+    uint32_t covered = (uint32_t)(trace.count - 1) * trace.span + trace.filled;
+    TEST_ASSERT_EQUAL(1000, covered);
+}
+
+void test_sliding_trace_drops_oldest(void) {
+    telemetry_trace_init(&trace, 2, false);
+    for (int16_t v = 0; v < 2 * TELEMETRY_COLUMNS + 4; v++) {
+        addVolts(v);
+    }
+    TEST_ASSERT_EQUAL(TELEMETRY_COLUMNS, trace.count);
+    TEST_ASSERT_EQUAL(2, trace.span);
+
+    // Two columns (samples 0-3) fell off the front
+    TEST_ASSERT_EQUAL(4, telemetry_trace_column(&trace, 0)->lo[SERIES_VOLTS]);
+    TEST_ASSERT_EQUAL(2 * TELEMETRY_COLUMNS + 3,
+                      telemetry_trace_column(&trace, TELEMETRY_COLUMNS - 1)->hi[SERIES_VOLTS]);
+}
+
+// =============================================================================
+// SCALING TESTS
+// =============================================================================
+
+void test_range_widened_to_min_span(void) {
+    addVolts(740);
+    addVolts(742);
+
+    int16_t lo, hi;
+    telemetry_trace_range(&trace, SERIES_VOLTS, 20, &lo, &hi);
+    TEST_ASSERT_EQUAL(20, hi - lo);
+    TEST_ASSERT_TRUE(lo <= 740 && hi >= 742);
+}
+
+void test_plot_scales_to_rows(void) {
+    addVolts(700);
+    addVolts(800);
+    addVolts(750);
+
+    telemetry_trace_plot(&trace, SERIES_VOLTS, 700, 800, 51, rows);
+    TEST_ASSERT_EQUAL(50, rows[0][0]);      // lo on the bottom row
+    TEST_ASSERT_EQUAL(0, rows[1][0]);       // hi on the top row
+    TEST_ASSERT_EQUAL(50, rows[1][1]);      // Reaching down to the previous column
+    TEST_ASSERT_EQUAL(25, rows[2][0]);      // Middle: already touches the previous run
+    TEST_ASSERT_EQUAL(25, rows[2][1]);
+}
+
+void test_plot_empty_columns_marked(void) {
+    addVolts(740);
+
+    telemetry_trace_plot(&trace, SERIES_VOLTS, 700, 800, 56, rows);
+    TEST_ASSERT_NOT_EQUAL(TELEMETRY_EMPTY, rows[0][0]);
+    TEST_ASSERT_EQUAL(TELEMETRY_EMPTY, rows[1][0]);
+    TEST_ASSERT_EQUAL(TELEMETRY_EMPTY, rows[TELEMETRY_COLUMNS - 1][1]);
+}
+
+void test_plot_clamps_out_of_range(void) {
+    addVolts(500);
+    addVolts(900);
+
+    telemetry_trace_plot(&trace, SERIES_VOLTS, 700, 800, 56, rows);
+    TEST_ASSERT_EQUAL(55, rows[0][0]);
+    TEST_ASSERT_EQUAL(55, rows[0][1]);
+    TEST_ASSERT_EQUAL(0, rows[1][0]);
+}
+
+// =============================================================================
+// THROUGHPUT
+// =============================================================================
+
+void test_day_of_samples_stays_bounded(void) {
+    // A day at 1 Hz: span grows to cover it in at most a chart width
+    for (long i = 0; i < 86400L; i++) {
+        addVolts((int16_t)(700 + i % 50));
+    }
+    TEST_ASSERT_LESS_OR_EQUAL(TELEMETRY_COLUMNS, trace.count);
+    TEST_ASSERT_GREATER_OR_EQUAL(TELEMETRY_COLUMNS / 2, trace.count);
+}
+
+// =============================================================================
+// TEST RUNNER
+// =============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Ring
+    RUN_TEST(test_ring_reads_in_order);
+    RUN_TEST(test_ring_overrun_resumes_at_oldest);
+
+    // Decimation
+    RUN_TEST(test_growing_trace_merges_when_full);
+    RUN_TEST(test_growing_trace_keeps_extremes);
+    RUN_TEST(test_growing_trace_covers_all_samples);
+    RUN_TEST(test_sliding_trace_drops_oldest);
+
+    // Scaling
+    RUN_TEST(test_range_widened_to_min_span);
+    RUN_TEST(test_plot_scales_to_rows);
+    RUN_TEST(test_plot_empty_columns_marked);
+    RUN_TEST(test_plot_clamps_out_of_range);
+
+    // Throughput
+    RUN_TEST(test_day_of_samples_stays_bounded);
+
+    return UNITY_END();
+}
@@ -3,7 +3,8 @@
  *
  * Run with: pio test -e native -f test_ui
  *
- * Tests navigation, button handling, and mode selection logic
+ * Tests navigation, button handling, and mode selection logic through the
+ * transition table the firmware dispatches on
  */
 
 #include <unity.h>
@@ -59,6 +60,12 @@ void test_next_screen_cycles(void) {
     ui_next_screen(&state);
     TEST_ASSERT_EQUAL(SCREEN_SAFETY, state.current_screen);
 
+    ui_next_screen(&state);
+    TEST_ASSERT_EQUAL(SCREEN_TELEMETRY, state.current_screen);
+
+    ui_next_screen(&state);
+    TEST_ASSERT_EQUAL(SCREEN_HISTORY, state.current_screen);
+
     // Should wrap to home
     ui_next_screen(&state);
     TEST_ASSERT_EQUAL(SCREEN_HOME, state.current_screen);
@@ -69,10 +76,10 @@ void test_prev_screen_cycles(void) {
 
     // Should wrap to last screen
     ui_prev_screen(&state);
-    TEST_ASSERT_EQUAL(SCREEN_SAFETY, state.current_screen);
+    TEST_ASSERT_EQUAL(SCREEN_HISTORY, state.current_screen);
 
     ui_prev_screen(&state);
-    TEST_ASSERT_EQUAL(SCREEN_BATTERY, state.current_screen);
+    TEST_ASSERT_EQUAL(SCREEN_TELEMETRY, state.current_screen);
 }
 
 void test_goto_screen_direct(void) {
@@ -152,20 +159,21 @@ void test_home_button1_starts_session(void) {
     TEST_ASSERT_EQUAL(ACTION_START_SESSION, action);
 }
 
-void test_home_button1_no_action_when_active(void) {
+void test_home_button1_stops_when_active(void) {
     state.current_screen = SCREEN_HOME;
     state.session_active = true;
 
     UIAction action = ui_handle_button(&state, BUTTON_1_SHORT);
-    TEST_ASSERT_EQUAL(ACTION_NONE, action);
+    TEST_ASSERT_EQUAL(ACTION_STOP_SESSION, action);
 }
 
 void test_home_button2_navigates(void) {
     state.current_screen = SCREEN_HOME;
 
+    // Idle, the session screen would only show home again
     UIAction action = ui_handle_button(&state, BUTTON_2_SHORT);
     TEST_ASSERT_EQUAL(ACTION_NAVIGATE_NEXT, action);
-    TEST_ASSERT_EQUAL(SCREEN_SESSION, state.current_screen);
+    TEST_ASSERT_EQUAL(SCREEN_STATS, state.current_screen);
 }
 
 void test_home_long_press_changes_mode(void) {
@@ -178,13 +186,13 @@ void test_home_long_press_changes_mode(void) {
     TEST_ASSERT_EQUAL(UI_MODE_ALTERNATING, state.current_mode);
 }
 
-void test_home_long_press_no_change_when_active(void) {
+void test_home_long_press_stops_when_active(void) {
     state.current_screen = SCREEN_HOME;
     state.session_active = true;
     state.current_mode = UI_MODE_DUAL;
 
     UIAction action = ui_handle_button(&state, BUTTON_1_LONG);
-    TEST_ASSERT_EQUAL(ACTION_NONE, action);
+    TEST_ASSERT_EQUAL(ACTION_STOP_SESSION, action);
     TEST_ASSERT_EQUAL(UI_MODE_DUAL, state.current_mode);  // Unchanged
 }
 
@@ -235,13 +243,19 @@ void test_settings_button1_confirms(void) {
 // BUTTON HANDLING - INFO SCREENS
 // =============================================================================
 
-void test_info_screens_button1_no_action(void) {
-    Screen info_screens[] = {SCREEN_STATS, SCREEN_BATTERY, SCREEN_SAFETY};
+void test_info_screens_button1_navigates_back(void) {
+    Screen info_screens[] = {
+        SCREEN_STATS, SCREEN_BATTERY, SCREEN_SAFETY, SCREEN_TELEMETRY, SCREEN_HISTORY
+    };
+    Screen back[] = {
+        SCREEN_HOME, SCREEN_SETTINGS, SCREEN_BATTERY, SCREEN_SAFETY, SCREEN_TELEMETRY
+    };
 
-    for (int i = 0; i < 3; i++) {
+    for (int i = 0; i < 5; i++) {
         state.current_screen = info_screens[i];
         UIAction action = ui_handle_button(&state, BUTTON_1_SHORT);
-        TEST_ASSERT_EQUAL(ACTION_NONE, action);
+        TEST_ASSERT_EQUAL(ACTION_NAVIGATE_PREV, action);
+        TEST_ASSERT_EQUAL(back[i], state.current_screen);
     }
 }
 
@@ -253,6 +267,148 @@ void test_info_screens_button2_navigates(void) {
     TEST_ASSERT_EQUAL(SCREEN_SETTINGS, state.current_screen);
 }
 
+void test_settings_entry_highlights_current_mode(void) {
+    state.current_mode = UI_MODE_NIR_ONLY;
+    state.selected_mode = UI_MODE_ALTERNATING;
+    ui_goto_screen(&state, SCREEN_SETTINGS);
+    TEST_ASSERT_EQUAL(UI_MODE_NIR_ONLY, state.selected_mode);
+}
+
+void test_settings_any_mode_selectable(void) {
+    for (int target = UI_MODE_RED_ONLY; target < UI_MODE_COUNT; target++) {
+        ui_init(&state);
+        ui_goto_screen(&state, SCREEN_SETTINGS);
+        while (state.selected_mode != target) {
+            ui_handle_button(&state, BUTTON_2_SHORT);
+        }
+
+        TEST_ASSERT_EQUAL(ACTION_CONFIRM_SETTING, ui_handle_button(&state, BUTTON_1_SHORT));
+        TEST_ASSERT_EQUAL(target, state.current_mode);
+        TEST_ASSERT_EQUAL(SCREEN_HOME, state.current_screen);
+    }
+}
+
+// =============================================================================
+// BUTTON HANDLING - HISTORY SCREEN
+// =============================================================================
+
+void test_history_pages_then_leaves(void) {
+    ui_goto_screen(&state, SCREEN_HISTORY);
+    ui_set_history_pages(&state, 3);
+
+    TEST_ASSERT_EQUAL(ACTION_PAGE_OLDER, ui_handle_button(&state, BUTTON_2_SHORT));
+    TEST_ASSERT_EQUAL(ACTION_PAGE_OLDER, ui_handle_button(&state, BUTTON_2_SHORT));
+    TEST_ASSERT_EQUAL(2, state.history_page);
+    TEST_ASSERT_EQUAL(SCREEN_HISTORY, state.current_screen);
+
+    // Past the oldest: on to the next screen
+    TEST_ASSERT_EQUAL(ACTION_NAVIGATE_NEXT, ui_handle_button(&state, BUTTON_2_SHORT));
+    TEST_ASSERT_EQUAL(SCREEN_HOME, state.current_screen);
+}
+
+void test_history_newer_then_leaves(void) {
+    ui_goto_screen(&state, SCREEN_HISTORY);
+    ui_set_history_pages(&state, 2);
+    ui_handle_button(&state, BUTTON_2_SHORT);
+
+    TEST_ASSERT_EQUAL(ACTION_PAGE_NEWER, ui_handle_button(&state, BUTTON_1_SHORT));
+    TEST_ASSERT_EQUAL(0, state.history_page);
+    TEST_ASSERT_EQUAL(ACTION_NAVIGATE_PREV, ui_handle_button(&state, BUTTON_1_SHORT));
+    TEST_ASSERT_EQUAL(SCREEN_TELEMETRY, state.current_screen);
+}
+
+void test_history_repeat_stops_at_end(void) {
+    ui_goto_screen(&state, SCREEN_HISTORY);
+    ui_set_history_pages(&state, 2);
+
+    TEST_ASSERT_EQUAL(ACTION_PAGE_OLDER, ui_handle_button(&state, BUTTON_2_REPEAT));
+    TEST_ASSERT_EQUAL(ACTION_NONE, ui_handle_button(&state, BUTTON_2_REPEAT));
+    TEST_ASSERT_EQUAL(SCREEN_HISTORY, state.current_screen);
+    TEST_ASSERT_EQUAL(1, state.history_page);
+}
+
+void test_history_pages_clamp_page(void) {
+    ui_goto_screen(&state, SCREEN_HISTORY);
+    ui_set_history_pages(&state, 4);
+    ui_handle_button(&state, BUTTON_2_SHORT);
+    ui_handle_button(&state, BUTTON_2_SHORT);
+
+    ui_set_history_pages(&state, 2);
+    TEST_ASSERT_EQUAL(1, state.history_page);
+    ui_set_history_pages(&state, 0);
+    TEST_ASSERT_EQUAL(1, state.history_pages);
+    TEST_ASSERT_EQUAL(0, state.history_page);
+}
+
+// =============================================================================
+// TRANSITION TABLE TESTS
+// =============================================================================
+
+void test_table_targets_valid(void) {
+    for (int screen = 0; screen < SCREEN_COUNT; screen++) {
+        for (int active = 0; active < 2; active++) {
+            for (int event = 0; event < BUTTON_EVENT_COUNT; event++) {
+                UITransition t = ui_transition((Screen)screen, active, (ButtonEvent)event);
+                TEST_ASSERT_TRUE(t.next == UI_STAY || t.next < SCREEN_COUNT);
+                TEST_ASSERT_TRUE(t.action <= ACTION_SHOW_DIAGNOSTICS);
+                // A session only starts or changes mode while idle
+                if (active) {
+                    TEST_ASSERT_NOT_EQUAL(ACTION_START_SESSION, t.action);
+                    TEST_ASSERT_NOT_EQUAL(ACTION_CHANGE_MODE, t.action);
+                    TEST_ASSERT_NOT_EQUAL(ACTION_CONFIRM_SETTING, t.action);
+                }
+            }
+        }
+    }
+}
+
+void test_running_button1_stops_everywhere(void) {
+    for (int screen = 0; screen < SCREEN_COUNT; screen++) {
+        TEST_ASSERT_EQUAL(ACTION_STOP_SESSION,
+                          ui_transition((Screen)screen, true, BUTTON_1_SHORT).action);
+        TEST_ASSERT_EQUAL(ACTION_STOP_SESSION,
+                          ui_transition((Screen)screen, true, BUTTON_1_LONG).action);
+    }
+}
+
+void test_running_never_waits_for_double_click(void) {
+    state.session_active = true;
+    for (int screen = 0; screen < SCREEN_COUNT; screen++) {
+        state.current_screen = (Screen)screen;
+        TEST_ASSERT_FALSE(ui_handles(&state, BUTTON_1_DOUBLE));
+        TEST_ASSERT_FALSE(ui_handles(&state, BUTTON_2_DOUBLE));
+    }
+}
+
+void test_running_button2_flips_telemetry(void) {
+    ui_set_session_active(&state, true);
+
+    TEST_ASSERT_EQUAL(ACTION_NAVIGATE_NEXT, ui_handle_button(&state, BUTTON_2_SHORT));
+    TEST_ASSERT_EQUAL(SCREEN_TELEMETRY, state.current_screen);
+    TEST_ASSERT_EQUAL(ACTION_TOGGLE_RANGE, ui_handle_button(&state, BUTTON_2_LONG));
+    TEST_ASSERT_EQUAL(SCREEN_TELEMETRY, state.current_screen);
+    TEST_ASSERT_EQUAL(ACTION_NAVIGATE_PREV, ui_handle_button(&state, BUTTON_2_SHORT));
+    TEST_ASSERT_EQUAL(SCREEN_SESSION, state.current_screen);
+}
+
+void test_double_click_home_off_home_only(void) {
+    TEST_ASSERT_FALSE(ui_handles(&state, BUTTON_1_DOUBLE));
+
+    ui_goto_screen(&state, SCREEN_BATTERY);
+    TEST_ASSERT_TRUE(ui_handles(&state, BUTTON_1_DOUBLE));
+    TEST_ASSERT_EQUAL(ACTION_GO_HOME, ui_handle_button(&state, BUTTON_1_DOUBLE));
+    TEST_ASSERT_EQUAL(SCREEN_HOME, state.current_screen);
+}
+
+void test_out_of_range_input_does_nothing(void) {
+    UITransition t = ui_transition(SCREEN_HOME, false, BUTTON_EVENT_COUNT);
+    TEST_ASSERT_EQUAL(ACTION_NONE, t.action);
+    TEST_ASSERT_EQUAL(UI_STAY, t.next);
+
+    t = ui_transition(SCREEN_COUNT, false, BUTTON_1_SHORT);
+    TEST_ASSERT_EQUAL(ACTION_NONE, t.action);
+}
+
 // =============================================================================
 // SESSION STATE TESTS
 // =============================================================================
@@ -293,6 +449,8 @@ void test_screen_names(void) {
     TEST_ASSERT_EQUAL_STRING("Settings", ui_get_screen_name(SCREEN_SETTINGS));
     TEST_ASSERT_EQUAL_STRING("Battery", ui_get_screen_name(SCREEN_BATTERY));
     TEST_ASSERT_EQUAL_STRING("Safety", ui_get_screen_name(SCREEN_SAFETY));
+    TEST_ASSERT_EQUAL_STRING("Telemetry", ui_get_screen_name(SCREEN_TELEMETRY));
+    TEST_ASSERT_EQUAL_STRING("History", ui_get_screen_name(SCREEN_HISTORY));
 }
 
 // =============================================================================
@@ -329,10 +487,10 @@ int main(int argc, char **argv) {
 
     // Home screen buttons
     RUN_TEST(test_home_button1_starts_session);
-    RUN_TEST(test_home_button1_no_action_when_active);
+    RUN_TEST(test_home_button1_stops_when_active);
     RUN_TEST(test_home_button2_navigates);
     RUN_TEST(test_home_long_press_changes_mode);
-    RUN_TEST(test_home_long_press_no_change_when_active);
+    RUN_TEST(test_home_long_press_stops_when_active);
 
     // Session screen buttons
     RUN_TEST(test_session_button1_stops_when_active);
@@ -341,11 +499,27 @@ int main(int argc, char **argv) {
     // Settings screen buttons
     RUN_TEST(test_settings_button2_cycles_modes);
     RUN_TEST(test_settings_button1_confirms);
+    RUN_TEST(test_settings_entry_highlights_current_mode);
+    RUN_TEST(test_settings_any_mode_selectable);
 
     // Info screens
-    RUN_TEST(test_info_screens_button1_no_action);
+    RUN_TEST(test_info_screens_button1_navigates_back);
     RUN_TEST(test_info_screens_button2_navigates);
 
+    // History screen buttons
+    RUN_TEST(test_history_pages_then_leaves);
+    RUN_TEST(test_history_newer_then_leaves);
+    RUN_TEST(test_history_repeat_stops_at_end);
+    RUN_TEST(test_history_pages_clamp_page);
+
+    // Transition table
+    RUN_TEST(test_table_targets_valid);
+    RUN_TEST(test_running_button1_stops_everywhere);
+    RUN_TEST(test_running_never_waits_for_double_click);
+    RUN_TEST(test_running_button2_flips_telemetry);
+    RUN_TEST(test_double_click_home_off_home_only);
+    RUN_TEST(test_out_of_range_input_does_nothing);
+
     // Session state
     RUN_TEST(test_set_session_active_navigates_to_session);
     RUN_TEST(test_set_session_inactive_stays_on_screen);
@@ -0,0 +1,189 @@
+/**
+ * Roxy RedLight v2.0 - Retained Widget Unit Tests
+ *
+ * Run with: pio test -e native -f test_widget
+ *
+ * Tests change detection per frame buffer and on the panel
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "widget.h"
+
+// =============================================================================
+// TEST FIXTURES
+// =============================================================================
+
+static WidgetState state;
+static DirtyRegion region;
+
+static uint32_t sigOf(const char* text, int16_t level) {
+    WidgetValue v;
+    memset(&v, 0, sizeof(v));
+    strncpy(v.text, text, sizeof(v.text) - 1);
+    v.level = level;
+    return widget_sig(&v);
+}
+
+static DirtyRect rect(int16_t x, int16_t y, int16_t w, int16_t h) {
+    DirtyRect r = {x, y, w, h};
+    return r;
+}
+
+void setUp(void) {
+    widget_reset(&state);
+    dirty_init(&region, 170, 320);
+}
+
+void tearDown(void) {
+    // Nothing to clean up
+}
+
+// =============================================================================
+// SIGNATURE TESTS
+// =============================================================================
+
+void test_sig_equal_values_match(void) {
+    TEST_ASSERT_EQUAL_UINT32(sigOf("12:00", 0), sigOf("12:00", 0));
+}
+
+void test_sig_any_field_changes_it(void) {
+    TEST_ASSERT_NOT_EQUAL(sigOf("12:00", 0), sigOf("11:59", 0));
+    TEST_ASSERT_NOT_EQUAL(sigOf("12:00", 0), sigOf("12:00", 1));
+}
+
+void test_sig_data_by_content(void) {
+    uint8_t a[4] = {1, 2, 3, 4};
+    uint8_t b[4] = {1, 2, 3, 4};
+    WidgetValue va;
+    WidgetValue vb;
+    memset(&va, 0, sizeof(va));
+    memset(&vb, 0, sizeof(vb));
+    va.data = a;
+    va.dataLen = sizeof(a);
+    vb.data = b;
+    vb.dataLen = sizeof(b);
+
+    // Same bytes in different places match; a changed byte does not
+    TEST_ASSERT_EQUAL_UINT32(widget_sig(&va), widget_sig(&vb));
+    b[3] = 5;
+    TEST_ASSERT_NOT_EQUAL(widget_sig(&va), widget_sig(&vb));
+}
+
+void test_sig_never_zero(void) {
+    for (int16_t i = 0; i < 1000; i++) {
+        TEST_ASSERT_NOT_EQUAL(0, sigOf("", i));
+    }
+}
+
+// =============================================================================
+// BUFFER TESTS
+// =============================================================================
+
+void test_reset_widget_stale_everywhere(void) {
+    uint32_t sig = sigOf("7.40V", 0);
+    TEST_ASSERT_TRUE(widget_stale(&state, 0, sig));
+    TEST_ASSERT_TRUE(widget_stale(&state, 1, sig));
+}
+
+void test_painted_only_in_its_buffer(void) {
+    uint32_t sig = sigOf("7.40V", 0);
+    widget_painted(&state, 0, sig, rect(10, 10, 40, 16));
+
+    TEST_ASSERT_FALSE(widget_stale(&state, 0, sig));
+    TEST_ASSERT_TRUE(widget_stale(&state, 1, sig));
+    TEST_ASSERT_TRUE(widget_stale(&state, 0, sigOf("7.41V", 0)));
+}
+
+void test_invalidate_one_buffer(void) {
+    uint32_t sig = sigOf("50%", 0);
+    widget_painted(&state, 0, sig, rect(0, 0, 10, 10));
+    widget_painted(&state, 1, sig, rect(0, 0, 10, 10));
+
+    widget_invalidate(&state, 1);
+    TEST_ASSERT_FALSE(widget_stale(&state, 0, sig));
+    TEST_ASSERT_TRUE(widget_stale(&state, 1, sig));
+    TEST_ASSERT_EQUAL(0, state.bounds[1].w);
+}
+
+// =============================================================================
+// PANEL TESTS
+// =============================================================================
+
+void test_show_first_value_dirty(void) {
+    TEST_ASSERT_TRUE(widget_show(&state, sigOf("1", 0), rect(10, 20, 30, 40), &region));
+    TEST_ASSERT_EQUAL(1, region.count);
+    TEST_ASSERT_EQUAL(1200, dirty_area(&region));
+}
+
+void test_show_same_value_clean(void) {
+    widget_show(&state, sigOf("1", 0), rect(10, 20, 30, 40), &region);
+    dirty_clear(&region);
+
+    TEST_ASSERT_FALSE(widget_show(&state, sigOf("1", 0), rect(10, 20, 30, 40), &region));
+    TEST_ASSERT_TRUE(dirty_is_empty(&region));
+}
+
+void test_show_change_covers_old_and_new(void) {
+    // Shrinking text: the old, wider bounds must be repainted too
+    widget_show(&state, sigOf("100%", 0), rect(50, 100, 60, 20), &region);
+    dirty_clear(&region);
+
+    widget_show(&state, sigOf("9%", 0), rect(65, 100, 30, 20), &region);
+    TEST_ASSERT_EQUAL(1, region.count);
+    TEST_ASSERT_EQUAL(50, region.rects[0].x);
+    TEST_ASSERT_EQUAL(60, region.rects[0].w);
+}
+
+// =============================================================================
+// GEOMETRY TESTS
+// =============================================================================
+
+void test_text_bounds_by_datum(void) {
+    // MC_DATUM (4): centred on the anchor, padded on every side
+    DirtyRect r = widget_text_bounds(85, 100, 40, 16, 4);
+    TEST_ASSERT_EQUAL(85 - 20 - WIDGET_TEXT_PAD, r.x);
+    TEST_ASSERT_EQUAL(100 - 8 - WIDGET_TEXT_PAD, r.y);
+    TEST_ASSERT_EQUAL(40 + 2 * WIDGET_TEXT_PAD, r.w);
+
+    // TR_DATUM (2): ends at the anchor
+    r = widget_text_bounds(160, 60, 30, 16, 2);
+    TEST_ASSERT_EQUAL(160 + WIDGET_TEXT_PAD, r.x + r.w);
+    TEST_ASSERT_EQUAL(60 - WIDGET_TEXT_PAD, r.y);
+}
+
+void test_text_bounds_empty_text(void) {
+    DirtyRect r = widget_text_bounds(85, 100, 0, 16, 4);
+    TEST_ASSERT_EQUAL(0, r.w);
+    TEST_ASSERT_EQUAL(0, r.h);
+}
+
+// =============================================================================
+// TEST RUNNER
+// =============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Signatures
+    RUN_TEST(test_sig_equal_values_match);
+    RUN_TEST(test_sig_any_field_changes_it);
+    RUN_TEST(test_sig_data_by_content);
+    RUN_TEST(test_sig_never_zero);
+
+    // Buffers
+    RUN_TEST(test_reset_widget_stale_everywhere);
+    RUN_TEST(test_painted_only_in_its_buffer);
+    RUN_TEST(test_invalidate_one_buffer);
+
+    // Panel
+    RUN_TEST(test_show_first_value_dirty);
+    RUN_TEST(test_show_same_value_clean);
+    RUN_TEST(test_show_change_covers_old_and_new);
+
+    // Geometry
+    RUN_TEST(test_text_bounds_by_datum);
+    RUN_TEST(test_text_bounds_empty_text);
+
+    return UNITY_END();
+}
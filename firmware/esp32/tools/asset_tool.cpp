@@ -0,0 +1,286 @@
+/**
+ * Roxy RedLight v2.0 - Asset Encoder
+ *
+ * Run with: pio run -e assets -t exec
+ *
+ * Converts every binary PPM (P6) image in assets/ into a palette-RLE
+ * stream and writes include/assets.h and src/assets.cpp, so images live
+ * in flash at a fraction of their RGB565 size. Magenta (255, 0, 255)
+ * pixels are transparent. An image may use at most 16 colors (transparent
+ * included); draw it with the COLOR_* values from config.h so every color
+ * lands on a palette entry.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <dirent.h>
+#include "asset.h"
+
+#define MAX_ASSETS      32
+#define MAX_NAME        32
+#define KEY_COLOR       0xF81F  // Magenta in RGB565
+
+typedef struct {
+    char name[MAX_NAME];        // File name without ".ppm"
+    uint16_t width;
+    uint16_t height;
+    uint8_t colors;
+    uint8_t transparent;
+    uint16_t palette[ASSET_MAX_COLORS];
+    uint8_t* data;
+    uint32_t size;
+} Encoded;
+
+// =============================================================================
+// PPM INPUT
+// =============================================================================
+
+// Next header number, skipping whitespace and # comments
+static int readNumber(FILE* f) {
+    int c = fgetc(f);
+    while (c != EOF && (isspace(c) || c == '#')) {
+        if (c == '#') {
+            while (c != EOF && c != '\n') {
+                c = fgetc(f);
+            }
+        }
+        c = fgetc(f);
+    }
+
+    int value = 0;
+    while (c != EOF && isdigit(c)) {
+        value = value * 10 + (c - '0');
+        c = fgetc(f);
+    }
+    return value;   // The single whitespace byte after it is consumed
+}
+
+static bool encodeImage(const char* path, Encoded* out) {
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+
+    char magic[2];
+    if (fread(magic, 1, 2, f) != 2 || magic[0] != 'P' || magic[1] != '6') {
+        fprintf(stderr, "%s: not a binary PPM (P6)\n", path);
+        fclose(f);
+        return false;
+    }
+    int w = readNumber(f);
+    int h = readNumber(f);
+    int maxval = readNumber(f);
+    if (w <= 0 || h <= 0 || w > 0xFFFF || h > 0xFFFF || maxval != 255) {
+        fprintf(stderr, "%s: unsupported size or depth\n", path);
+        fclose(f);
+        return false;
+    }
+
+    uint32_t count = (uint32_t)w * h;
+    uint8_t* indices = (uint8_t*)malloc(count);
+    out->width = w;
+    out->height = h;
+    out->colors = 0;
+    out->transparent = ASSET_OPAQUE;
+
+    // Build the palette while converting to RGB565
+    for (uint32_t i = 0; i < count; i++) {
+        uint8_t rgb[3];
+        if (fread(rgb, 1, 3, f) != 3) {
+            fprintf(stderr, "%s: truncated\n", path);
+            free(indices);
+            fclose(f);
+            return false;
+        }
+        uint16_t color = ((rgb[0] >> 3) << 11) | ((rgb[1] >> 2) << 5) | (rgb[2] >> 3);
+
+        uint8_t index = 0;
+        while (index < out->colors && out->palette[index] != color) {
+            index++;
+        }
+        if (index == out->colors) {
+            if (out->colors == ASSET_MAX_COLORS) {
+                fprintf(stderr, "%s: more than %d colors\n", path, ASSET_MAX_COLORS);
+                free(indices);
+                fclose(f);
+                return false;
+            }
+            out->palette[out->colors++] = color;
+            if (color == KEY_COLOR) {
+                out->transparent = index;
+            }
+        }
+        indices[i] = index;
+    }
+    fclose(f);
+
+    out->size = asset_encode(indices, count, NULL, 0);
+    out->data = (uint8_t*)malloc(out->size);
+    asset_encode(indices, count, out->data, out->size);
+    free(indices);
+
+    Asset check = {out->width, out->height, out->colors, out->transparent,
+                   out->palette, out->data, out->size};
+    return asset_valid(&check);
+}
+
+// =============================================================================
+// C OUTPUT
+// =============================================================================
+
+// "splash_logo" -> "SplashLogo"
+static void camelName(const char* name, char* out) {
+    bool upper = true;
+    for (; *name; name++) {
+        if (*name == '_' || *name == '-') {
+            upper = true;
+            continue;
+        }
+        *out++ = upper ? toupper(*name) : *name;
+        upper = false;
+    }
+    *out = 0;
+}
+
+static bool writeHeader(const char* path, const Encoded* assets, int count) {
+    FILE* f = fopen(path, "w");
+    if (f == NULL) {
+        return false;
+    }
+
+    fprintf(f, "/**\n"
+               " * Roxy RedLight v2.0 - Image Assets\n"
+               " *\n"
+               " * Generated by tools/asset_tool.cpp from assets/ - do not edit.\n"
+               " * Regenerate with: pio run -e assets -t exec\n"
+               " */\n\n"
+               "#ifndef ASSETS_H\n"
+               "#define ASSETS_H\n\n"
+               "#include \"asset.h\"\n\n");
+    for (int i = 0; i < count; i++) {
+        char camel[MAX_NAME];
+        camelName(assets[i].name, camel);
+        fprintf(f, "extern const Asset asset%s;%*s// %ux%u\n", camel,
+                (int)(24 - strlen(camel)), "", assets[i].width, assets[i].height);
+    }
+    fprintf(f, "\n#endif // ASSETS_H\n");
+    fclose(f);
+    return true;
+}
+
+static bool writeSource(const char* path, const Encoded* assets, int count) {
+    FILE* f = fopen(path, "w");
+    if (f == NULL) {
+        return false;
+    }
+
+    fprintf(f, "/**\n"
+               " * Roxy RedLight v2.0 - Image Assets\n"
+               " *\n"
+               " * Generated by tools/asset_tool.cpp from assets/ - do not edit.\n"
+               " */\n\n"
+               "#include \"assets.h\"\n");
+
+    for (int i = 0; i < count; i++) {
+        const Encoded& a = assets[i];
+        char camel[MAX_NAME];
+        camelName(a.name, camel);
+
+        fprintf(f, "\n// %s.ppm: %ux%u, %u colors, %lu bytes (%lu as RGB565)\n",
+                a.name, a.width, a.height, a.colors, (unsigned long)a.size,
+                (unsigned long)a.width * a.height * 2);
+
+        fprintf(f, "static const uint16_t palette%s[] = {", camel);
+        for (uint8_t c = 0; c < a.colors; c++) {
+            fprintf(f, "%s0x%04X", c ? ", " : "", a.palette[c]);
+        }
+        fprintf(f, "};\n\n");
+
+        fprintf(f, "static const uint8_t data%s[] = {", camel);
+        for (uint32_t b = 0; b < a.size; b++) {
+            fprintf(f, "%s0x%02X%s", (b % 12) ? " " : "\n    ", a.data[b],
+                    (b + 1 < a.size) ? "," : "");
+        }
+        fprintf(f, "\n};\n\n");
+
+        char transparent[16];
+        if (a.transparent == ASSET_OPAQUE) {
+            strcpy(transparent, "ASSET_OPAQUE");
+        } else {
+            snprintf(transparent, sizeof(transparent), "%u", a.transparent);
+        }
+        fprintf(f, "const Asset asset%s = {\n"
+                   "    %u, %u, %u, %s, palette%s, data%s, sizeof(data%s)\n"
+                   "};\n",
+                camel, a.width, a.height, a.colors, transparent, camel, camel, camel);
+    }
+    fclose(f);
+    return true;
+}
+
+// =============================================================================
+// MAIN
+// =============================================================================
+
+static int compareNames(const void* a, const void* b) {
+    return strcmp(((const Encoded*)a)->name, ((const Encoded*)b)->name);
+}
+
+int main(int argc, char** argv) {
+    const char* project = (argc > 1) ? argv[1] : ".";
+    char path[512];
+
+    snprintf(path, sizeof(path), "%s/assets", project);
+    DIR* dir = opendir(path);
+    if (dir == NULL) {
+        fprintf(stderr, "%s: not found\n", path);
+        return 1;
+    }
+
+    static Encoded assets[MAX_ASSETS];
+    int count = 0;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        size_t len = strlen(entry->d_name);
+        if (len < 5 || len - 4 >= MAX_NAME || strcmp(entry->d_name + len - 4, ".ppm") != 0) {
+            continue;
+        }
+        if (count == MAX_ASSETS) {
+            fprintf(stderr, "More than %d assets\n", MAX_ASSETS);
+            return 1;
+        }
+        memcpy(assets[count].name, entry->d_name, len - 4);
+        assets[count].name[len - 4] = 0;
+        count++;
+    }
+    closedir(dir);
+
+    // Stable output whatever order the directory lists in
+    qsort(assets, count, sizeof(Encoded), compareNames);
+
+    for (int i = 0; i < count; i++) {
+        snprintf(path, sizeof(path), "%s/assets/%s.ppm", project, assets[i].name);
+        if (!encodeImage(path, &assets[i])) {
+            return 1;
+        }
+        printf("%-16s %4ux%-4u %2u colors %6lu bytes (%lu as RGB565)\n",
+               assets[i].name, assets[i].width, assets[i].height, assets[i].colors,
+               (unsigned long)assets[i].size,
+               (unsigned long)assets[i].width * assets[i].height * 2);
+    }
+
+    snprintf(path, sizeof(path), "%s/include/assets.h", project);
+    if (!writeHeader(path, assets, count)) {
+        fprintf(stderr, "%s: cannot write\n", path);
+        return 1;
+    }
+    snprintf(path, sizeof(path), "%s/src/assets.cpp", project);
+    if (!writeSource(path, assets, count)) {
+        fprintf(stderr, "%s: cannot write\n", path);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,239 @@
+"""
+Roxy RedLight v2.0 - Font Subsetter
+
+Runs before every device build (extra_scripts = pre:tools/font_subset.py).
+
+Collects the characters the UI can draw - the string literals in the
+scanned sources, plus what their printf formats can produce - and converts
+just those glyphs of TFT_eSPI's built-in fonts 2 and 4 into GFX free fonts
+in src/font_subset.cpp. The full fonts are then left out of the build
+(no LOAD_FONT2/LOAD_FONT4), and SpriteCanvas swaps the subsets in for those
+font numbers. include/font_subset.h declares what is generated here.
+"""
+
+import glob
+import os
+import re
+
+# Sources whose strings may reach the display: the UI, and every library
+# (names such as history_end_name() are drawn as they are). Host stubs
+# never run on the device.
+SCAN = ["src/display.cpp", "src/main.cpp", "lib/*/*.cpp"]
+EXCLUDE = "host_"
+
+# Always present: the glyph atlas digits and what number formats produce
+ALWAYS = " 0123456789:./-"
+
+# Font number -> (TFT_eSPI font file, table suffix, RLE encoded)
+FONTS = {
+    2: ("Font16", "f16", False),
+    4: ("Font32rle", "f32", True),
+}
+
+FIRST = 0x20
+LAST = 0x7E
+OUTPUT = "src/font_subset.cpp"
+
+# =============================================================================
+# CHARACTER SET
+# =============================================================================
+
+LITERAL = re.compile(r'"((?:[^"\\\n]|\\.)*)"')
+FORMAT = re.compile(r"%[-+ #0]*\d*(?:\.\d+)?(?:hh|h|ll|l|z)?([diouxXfFeEgGcsp%])")
+
+
+def strip_comments(text):
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+    return re.sub(r"//[^\n]*", "", text)
+
+
+def literal_chars(literal):
+    """Characters a literal (possibly a printf format) can put on screen."""
+    chars = set()
+    text = bytes(literal, "utf-8").decode("unicode_escape")
+    for match in FORMAT.finditer(text):
+        kind = match.group(1)
+        if kind == "%":
+            chars.add("%")
+        elif kind not in "csp":
+            chars.update("0123456789-.")
+    chars.update(FORMAT.sub("", text))
+    return chars
+
+
+def scan_paths(project):
+    paths = []
+    for pattern in SCAN:
+        for path in sorted(glob.glob(os.path.join(project, pattern))):
+            if not os.path.basename(path).startswith(EXCLUDE):
+                paths.append(path)
+    return paths
+
+
+def collect_chars(project):
+    chars = set(ALWAYS)
+    for path in scan_paths(project):
+        with open(path, encoding="utf-8") as f:
+            text = strip_comments(f.read())
+        for line in text.splitlines():
+            # Serial output and includes never reach the panel
+            if "Serial." in line or line.lstrip().startswith("#"):
+                continue
+            for literal in LITERAL.findall(line):
+                chars.update(literal_chars(literal))
+    return {c for c in chars if FIRST <= ord(c) <= LAST}
+
+# =============================================================================
+# TFT_eSPI FONT INPUT
+# =============================================================================
+
+ARRAY = re.compile(r"(\w+)\s*\[[^\]]*\]\s*=\s*\{(.*?)\}", re.S)
+
+
+def read_font(fonts_dir, name, suffix):
+    """Returns (height, widths, glyph byte lists) for characters 32..127."""
+    text = ""
+    for ext in (".h", ".c"):
+        path = os.path.join(fonts_dir, name + ext)
+        if os.path.exists(path):
+            with open(path, encoding="latin-1") as f:
+                text += strip_comments(f.read())
+
+    height = re.search(r"#define\s+chr_hgt_%s\s+(\d+)" % suffix, text)
+    if height is None:
+        raise ValueError("%s: no chr_hgt_%s" % (name, suffix))
+
+    arrays = {}
+    for array, body in ARRAY.findall(text):
+        arrays[array] = [item.strip() for item in body.split(",") if item.strip()]
+
+    widths = [int(w, 0) for w in arrays["widtbl_" + suffix]]
+    glyphs = [[int(b, 0) for b in arrays[ref]] for ref in arrays["chrtbl_" + suffix]]
+    return int(height.group(1)), widths, glyphs
+
+
+def glyph_pixels(data, width, height, rle):
+    """Decodes one TFT_eSPI glyph to rows of 0/1 pixels."""
+    pixels = []
+    if rle:
+        # Bit 7 set: (low bits + 1) ink pixels, else (byte + 1) background
+        for byte in data:
+            pixels += [1 if byte & 0x80 else 0] * ((byte & 0x7F) + 1)
+    else:
+        # Rows of whole bytes, MSB leftmost
+        stride = len(data) // height if height else 0
+        for y in range(height):
+            row = data[y * stride:(y + 1) * stride]
+            for x in range(width):
+                byte = row[x // 8] if x // 8 < len(row) else 0
+                pixels.append((byte >> (7 - x % 8)) & 1)
+    pixels = (pixels + [0] * (width * height))[:width * height]
+    return [pixels[y * width:(y + 1) * width] for y in range(height)]
+
+# =============================================================================
+# GFX FONT OUTPUT
+# =============================================================================
+
+
+def pack_bits(rows):
+    """GFX bitmaps are one bit stream across rows, MSB first."""
+    bits = [bit for row in rows for bit in row]
+    out = []
+    for i in range(0, len(bits), 8):
+        chunk = bits[i:i + 8] + [0] * (8 - len(bits[i:i + 8]))
+        out.append(sum(bit << (7 - k) for k, bit in enumerate(chunk)))
+    return out
+
+
+def convert_font(number, fonts_dir, chars):
+    name, suffix, rle = FONTS[number]
+    height, widths, glyphs = read_font(fonts_dir, name, suffix)
+
+    bitmap = []
+    records = []
+    kept = 0
+    full = sum(len(g) for g in glyphs)
+    for code in range(FIRST, LAST + 1):
+        index = code - FIRST
+        width = widths[index] if index < len(widths) else 0
+        rows = glyph_pixels(glyphs[index], width, height, rle) if index < len(glyphs) else []
+
+        # Every glyph spans the whole cell with its baseline at the cell
+        # bottom, so TFT_eSPI's free-font datum maths position text exactly
+        # where the built-in font put it. Blank glyphs keep only an advance.
+        if chr(code) not in chars:
+            records.append((len(bitmap), 0, 0, 0, -height, chr(code)))
+            continue
+        kept += 1
+        ink = any(any(row) for row in rows)
+        records.append((len(bitmap), width, height if ink else 0, width, -height, chr(code)))
+        if ink:
+            bitmap += pack_bits(rows)
+
+    print("Font subset: font %d, %d glyphs, %d bitmap bytes (%d of glyph data in TFT_eSPI)" %
+          (number, kept, len(bitmap), full))
+
+    lines = ["", "// Font %d (%s): %d of %d glyphs" % (number, name, kept, LAST - FIRST + 1)]
+    lines.append("static const uint8_t bitmap%d[] PROGMEM = {" % number)
+    for i in range(0, len(bitmap), 12):
+        lines.append("    " + ", ".join("0x%02X" % b for b in bitmap[i:i + 12]) + ",")
+    if not bitmap:
+        lines.append("    0x00")
+    lines.append("};")
+    lines.append("")
+    lines.append("static const GFXglyph glyphs%d[] PROGMEM = {" % number)
+    for offset, w, h, advance, y_offset, char in records:
+        comment = "'%s'" % char if char not in "\\'" else "'\\%s'" % char
+        lines.append("    {%5d, %2d, %2d, %2d, 0, %3d},  // %s" %
+                     (offset, w, h, advance, y_offset, comment))
+    lines.append("};")
+    lines.append("")
+    lines.append("const GFXfont fontSubset%d PROGMEM = {(uint8_t*)bitmap%d, (GFXglyph*)glyphs%d, "
+                 "0x%02X, 0x%02X, %d};" % (number, number, number, FIRST, LAST, height))
+    return lines
+
+
+def generate(project, fonts_dir):
+    chars = collect_chars(project)
+    lines = [
+        "/**",
+        " * Roxy RedLight v2.0 - Font Subsets",
+        " *",
+        " * Generated by tools/font_subset.py on every build - do not edit.",
+        " * Characters: " + "".join(sorted(chars)).replace("*/", "* /"),
+        " */",
+        "",
+        "#ifdef ARDUINO",
+        "",
+        '#include "font_subset.h"',
+    ]
+    for number in sorted(FONTS):
+        lines += convert_font(number, fonts_dir, chars)
+    lines += ["", "#endif // ARDUINO", ""]
+    source = "\n".join(lines)
+
+    # Leave an unchanged file alone so it does not rebuild
+    path = os.path.join(project, OUTPUT)
+    if os.path.exists(path):
+        with open(path, encoding="utf-8") as f:
+            if f.read() == source:
+                return
+    with open(path, "w", encoding="utf-8") as f:
+        f.write(source)
+
+# =============================================================================
+# PLATFORMIO HOOK
+# =============================================================================
+
+try:
+    Import("env")  # noqa: F821 (SCons builtin)
+except NameError:
+    env = None
+
+if env is not None:
+    fonts_dir = os.path.join(env.subst("$PROJECT_LIBDEPS_DIR"), env.subst("$PIOENV"),
+                             "TFT_eSPI", "Fonts")
+    if not os.path.isdir(fonts_dir):
+        print("Font subset: %s not found (install lib_deps first)" % fonts_dir)
+        env.Exit(1)
+    generate(env.subst("$PROJECT_DIR"), fonts_dir)